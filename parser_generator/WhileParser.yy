@@ -12,6 +12,7 @@
 #include <iostream>
 #include <vector>
 #include <memory>
+#include <sstream>
 
 #include "Term.hpp"
 #include "Formula.hpp"
@@ -33,8 +34,9 @@ namespace parser {
 }
 }
 
-// The parsing context.
+// The parsing context, and the state of the reentrant scanner (cf. yylex_init in WhileScanner.cpp).
 %param { parser::WhileParsingContext &context }
+%param { void* scanner }
 %locations
 %define api.location.type {Location}
 %initial-action
@@ -51,7 +53,7 @@ namespace parser {
 using namespace program;
 
 // Tell Flex the lexer's prototype ...
-# define YY_DECL parser::WhileParser::symbol_type yylex(parser::WhileParsingContext &context)
+# define YY_DECL parser::WhileParser::symbol_type yylex(parser::WhileParsingContext &context, void* yyscanner)
 // ... and declare it for the parser's sake.
 YY_DECL;
 
@@ -166,6 +168,8 @@ program:
   function_list 
   { 
     context.program = std::unique_ptr<const program::Program>(new program::Program($1)); 
+    // snapshot of the declarations of the program, which e.g. identify the program in the cache of spectre::Encoder
+    context.programSignature = logic::Signature::signature();
   }
 ;
 
@@ -188,7 +192,7 @@ smtlib_formula:
     
     if(leftSort != rightSort)
     {
-      error(@4, "Argument types " + leftSort->name + " and " + rightSort->name + " don't match!");
+      throw syntax_error(@4, "Argument types " + leftSort->name + " and " + rightSort->name + " don't match!");
     }
     $$ = logic::Formulas::equality(std::move($3), std::move($4));
   }
@@ -196,11 +200,11 @@ smtlib_formula:
 {
   if($3->symbol->rngSort != logic::Sorts::intSort())
   {
-    error(@3, "Left argument type needs to be Int");
+    throw syntax_error(@3, "Left argument type needs to be Int");
   }
   if($4->symbol->rngSort != logic::Sorts::intSort())
   {
-    error(@4, "Right argument type needs to be Int");
+    throw syntax_error(@4, "Right argument type needs to be Int");
   }
   $$ = logic::Theory::intGreater(std::move($3), std::move($4));
 }
@@ -208,11 +212,11 @@ smtlib_formula:
 {
   if($3->symbol->rngSort != logic::Sorts::intSort())
   {
-    error(@3, "Left argument type needs to be Int");
+    throw syntax_error(@3, "Left argument type needs to be Int");
   }
   if($4->symbol->rngSort != logic::Sorts::intSort())
   {
-    error(@4, "Right argument type needs to be Int");
+    throw syntax_error(@4, "Right argument type needs to be Int");
   } 
   $$ = logic::Theory::intGreaterEqual(std::move($3), std::move($4));
 }
@@ -220,11 +224,11 @@ smtlib_formula:
 { 
   if($3->symbol->rngSort != logic::Sorts::intSort())
   {
-    error(@3, "Left argument type needs to be Int");
+    throw syntax_error(@3, "Left argument type needs to be Int");
   }
   if($4->symbol->rngSort != logic::Sorts::intSort())
   {
-    error(@4, "Right argument type needs to be Int");
+    throw syntax_error(@4, "Right argument type needs to be Int");
   } 
   $$ = logic::Theory::intLess(std::move($3), std::move($4));
 }
@@ -232,11 +236,11 @@ smtlib_formula:
 { 
   if($3->symbol->rngSort != logic::Sorts::intSort())
   {
-    error(@3, "Left argument type needs to be Int");
+    throw syntax_error(@3, "Left argument type needs to be Int");
   }
   if($4->symbol->rngSort != logic::Sorts::intSort())
   {
-    error(@4, "Right argument type needs to be Int");
+    throw syntax_error(@4, "Right argument type needs to be Int");
   } 
   $$ = logic::Theory::intLessEqual(std::move($3), std::move($4));
 }
@@ -276,7 +280,7 @@ smtlib_quantvar:
   { 
     if(context.isDeclared($2))
     {
-      error(@2, $2 + " has already been declared");
+      throw syntax_error(@2, $2 + " has already been declared");
     }
     if($3 == "Int")
     { 
@@ -298,7 +302,7 @@ smtlib_quantvar:
     {
       if($3 != "Trace")
       {
-        error(@3, "Only the sorts Int, Bool, Time and Trace are supported");
+        throw syntax_error(@3, "Only the sorts Int, Bool, Time and Trace are supported");
       }
       $$ = logic::Signature::varSymbol($2, logic::Sorts::traceSort());
     }
@@ -315,13 +319,13 @@ SMTLIB_ID
 {
   if(!context.isDeclared($1))
   {
-    error(@1, $1 + " has not been declared");
+    throw syntax_error(@1, $1 + " has not been declared");
   }
   auto symbol = context.fetch($1); 
 
   if(symbol->argSorts.size() > 0)
   {
-      error(@1, "Not enough arguments for term " + symbol->name);
+      throw syntax_error(@1, "Not enough arguments for term " + symbol->name);
   }
   $$ = logic::Terms::func(symbol, std::vector<std::shared_ptr<const logic::Term>>());
 }
@@ -333,19 +337,19 @@ SMTLIB_ID
 {
   if(!context.isDeclared($2))
   {
-    error(@2, $2 + " has not been declared");
+    throw syntax_error(@2, $2 + " has not been declared");
   }
   auto symbol = context.fetch($2); 
 
   if(symbol->argSorts.size() != $3.size())
   {
-      error(@3, "Not enough arguments for term " + symbol->name);
+      throw syntax_error(@3, "Not enough arguments for term " + symbol->name);
   }
   for (int i=0; i < symbol->argSorts.size(); ++i)
   {
       if(symbol->argSorts[i] != $3[i]->symbol->rngSort)
       {
-        error(@3, "Argument has type " + $3[i]->symbol->rngSort->name + " instead of " + symbol->argSorts[i]->name);
+        throw syntax_error(@3, "Argument has type " + $3[i]->symbol->rngSort->name + " instead of " + symbol->argSorts[i]->name);
       }
   }
   $$ = logic::Terms::func(symbol, std::move($3));
@@ -354,11 +358,11 @@ SMTLIB_ID
 {
   if($3->symbol->rngSort != logic::Sorts::intSort())
   {
-    error(@3, "Left argument type needs to be Int");
+    throw syntax_error(@3, "Left argument type needs to be Int");
   }
   if($4->symbol->rngSort != logic::Sorts::intSort())
   {
-    error(@4, "Right argument type needs to be Int");
+    throw syntax_error(@4, "Right argument type needs to be Int");
   } 
   $$ = logic::Theory::intAddition(std::move($3), std::move($4));
 }
@@ -366,11 +370,11 @@ SMTLIB_ID
 {
   if($3->symbol->rngSort != logic::Sorts::intSort())
   {
-    error(@3, "Left argument type needs to be Int");
+    throw syntax_error(@3, "Left argument type needs to be Int");
   }
   if($4->symbol->rngSort != logic::Sorts::intSort())
   {
-    error(@4, "Right argument type needs to be Int");
+    throw syntax_error(@4, "Right argument type needs to be Int");
   } 
   $$ = logic::Theory::intSubtraction(std::move($3), std::move($4));
 }
@@ -378,11 +382,11 @@ SMTLIB_ID
 {
   if($3->symbol->rngSort != logic::Sorts::intSort())
   {
-    error(@3, "Left argument type needs to be Int");
+    throw syntax_error(@3, "Left argument type needs to be Int");
   }
   if($4->symbol->rngSort != logic::Sorts::intSort())
   {
-    error(@4, "Right argument type needs to be Int");
+    throw syntax_error(@4, "Right argument type needs to be Int");
   } 
   $$ = logic::Theory::intModulo(std::move($3), std::move($4));
 }
@@ -390,11 +394,11 @@ SMTLIB_ID
 {
   if($3->symbol->rngSort != logic::Sorts::intSort())
   {
-    error(@3, "Left argument type needs to be Int");
+    throw syntax_error(@3, "Left argument type needs to be Int");
   }
   if($4->symbol->rngSort != logic::Sorts::intSort())
   {
-    error(@4, "Right argument type needs to be Int");
+    throw syntax_error(@4, "Right argument type needs to be Int");
   } 
   $$ = logic::Theory::intMultiplication(std::move($3), std::move($4));
 }
@@ -459,7 +463,7 @@ assignment_statement:
       auto intVariableAccess = std::static_pointer_cast<const program::IntVariableAccess>($1);
       if(intVariableAccess->var->isConstant)
       {
-        error(@1, "Assignment to const var " + intVariableAccess->var->name);
+        throw syntax_error(@1, "Assignment to const var " + intVariableAccess->var->name);
       }
     }
     else
@@ -468,7 +472,7 @@ assignment_statement:
       auto intArrayApplication = std::static_pointer_cast<const program::IntArrayApplication>($1);
       if(intArrayApplication->array->isConstant)
       {
-        error(@1, "Assignment to const var " + intArrayApplication->array->name);
+        throw syntax_error(@1, "Assignment to const var " + intArrayApplication->array->name);
       }
     }
     $$ = std::shared_ptr<const program::IntAssignment>(new program::IntAssignment(@2.begin.line, std::move($1), std::move($3)));
@@ -482,7 +486,7 @@ assignment_statement:
     // construct location
     if($1->isArray)
     {
-      error(@1, "Combined declaration and assignment not allowed, since " + $1->name + " is array variable");
+      throw syntax_error(@1, "Combined declaration and assignment not allowed, since " + $1->name + " is array variable");
     }
     auto intVariableAccess = std::shared_ptr<const program::IntVariableAccess>(new IntVariableAccess(std::move($1)));
    
@@ -544,11 +548,11 @@ var_definition_head:
   {
     if($1 == "Bool")
     {
-      error(@1, "Program variables of type Bool are not supported");
+      throw syntax_error(@1, "Program variables of type Bool are not supported");
     }
     if($1 == "Nat" || $1 == "Time" || $1 == "Trace")
     {
-      error(@1, "Program variables can't have type " + $1);
+      throw syntax_error(@1, "Program variables can't have type " + $1);
     }
     $$ = std::shared_ptr<const program::Variable>(new program::Variable($2, false, false, context.twoTraces));
   }
@@ -556,11 +560,11 @@ var_definition_head:
   {
     if($2 == "Bool")
     {
-      error(@1, "Program variables of type Bool are not supported");
+      throw syntax_error(@1, "Program variables of type Bool are not supported");
     }
     if($2 == "Nat" || $2 == "Time" || $2 == "Trace")
     {
-      error(@2, "Program variables can't have type " + $2);
+      throw syntax_error(@2, "Program variables can't have type " + $2);
     }
     $$ = std::shared_ptr<const program::Variable>(new program::Variable($3, true, false, context.twoTraces));
   }
@@ -568,11 +572,11 @@ var_definition_head:
   {
     if($1 == "Bool")
     {
-      error(@1, "Program variables of type Bool are not supported");
+      throw syntax_error(@1, "Program variables of type Bool are not supported");
     }
     if($1 == "Nat" || $1 == "Time" || $1 == "Trace")
     {
-      error(@1, "Program variables can't have type " + $1);
+      throw syntax_error(@1, "Program variables can't have type " + $1);
     }
     $$ = std::shared_ptr<const program::Variable>(new program::Variable($4, false, true, context.twoTraces));
   }
@@ -580,11 +584,11 @@ var_definition_head:
   {
     if($2 == "Bool")
     {
-      error(@1, "Program variables of type Bool are not supported");
+      throw syntax_error(@1, "Program variables of type Bool are not supported");
     }
     if($2 == "Nat" || $2 == "Time" || $2 == "Trace")
     {
-      error(@2, "Program variables can't have type " + $2);
+      throw syntax_error(@2, "Program variables can't have type " + $2);
     }
     $$ = std::shared_ptr<const program::Variable>(new program::Variable($5, true, true, context.twoTraces));
   }
@@ -620,29 +624,38 @@ location:
   PROGRAM_ID                
   { 
   	auto var = context.getProgramVar($1);
+    if(var == nullptr)
+    {
+      throw syntax_error(@1, "Program variable " + $1 + " has not been declared");
+    }
     if(var->isArray)
     {
-      error(@1, "Array variable " + var->name + " needs index for access");
+      throw syntax_error(@1, "Array variable " + var->name + " needs index for access");
     }
     $$ = std::shared_ptr<const program::IntVariableAccess>(new IntVariableAccess(std::move(var)));
   }
 | PROGRAM_ID LBRA expr RBRA 
   {
 	  auto var = context.getProgramVar($1);
+    if(var == nullptr)
+    {
+      throw syntax_error(@1, "Program variable " + $1 + " has not been declared");
+    }
     if(!var->isArray)
     {
-      error(@1, "Variable " + var->name + " is not an array");
+      throw syntax_error(@1, "Variable " + var->name + " is not an array");
     }
 	  $$ = std::shared_ptr<const program::IntArrayApplication>(new IntArrayApplication(std::move(var), std::move($3)));
   }
 ;
 
 %%
+// records the error in the context. The parser stops at the first error, since the grammar has no error-rules.
 void parser::WhileParser::error(const location_type& l,
                               const std::string& m)
 {
-  std::cout << "Error while parsing location " << l << ":\n" << m << std::endl;
+  std::ostringstream message;
+  message << "Error while parsing location " << l << ":\n" << m;
   context.errorFlag = true;
-  exit(1);
+  context.errorMessage = message.str();
 }
-
@@ -13,20 +13,10 @@
 // not conform to C89.  See Debian bug 333231
 // <http://bugs.debian.org/cgi-bin/bugreport.cgi?bug=333231>.
 # undef yywrap
-# define yywrap() 1
-
-// The location of the current token.
-static parser::Location loc;
-
-void error(const parser::Location& l,
-           const std::string& m)
-{
-    std::cout << l << m << std::endl;
-    exit(1);
-}
+# define yywrap(yyscanner) 1
 
 %}
-%option noyywrap nounput batch debug noinput
+%option reentrant noyywrap nounput batch debug noinput
 IDENT [a-z][a-zA-Z_0-9]*
 NUM   [0-9]+
 BLANK [ \t]
@@ -35,7 +25,8 @@ BLANK [ \t]
 #include "WhileParsingContext.hpp"
 using namespace program;
 // Tell Flex the lexer's prototype ...
-# define YY_DECL parser::WhileParser::symbol_type yylex(parser::WhileParsingContext &context)
+// the scanner is reentrant: its state is kept in yyscanner, and the location of the current token in the context.
+# define YY_DECL parser::WhileParser::symbol_type yylex(parser::WhileParsingContext &context, yyscan_t yyscanner)
 // ... and declare it for the parser's sake.
 YY_DECL;
 %}
@@ -51,6 +42,7 @@ YY_DECL;
 
 %{
   // Code run each time yylex is called.
+  parser::Location& loc = context.location;
   loc.step();
 %}
 
@@ -110,10 +102,10 @@ mod          { return parser::WhileParser::make_MOD(loc); }
   errno = 0;
   long n = strtol (yytext, NULL, 10);
   if (! (INT_MIN <= n && n <= INT_MAX && errno != ERANGE))
-    error(loc, "integer out of range");
+    throw parser::WhileParser::syntax_error(loc, "integer out of range");
   return parser::WhileParser::make_INTEGER(n, loc);
 }
-.            { error(loc, "invalid character");}
+.            { throw parser::WhileParser::syntax_error(loc, "invalid character"); }
 <<EOF>>      { return parser::WhileParser::make_END(loc); }
 
 %%
@@ -0,0 +1,69 @@
+#include "LemmaTasks.hpp"
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Context.hpp"
+
+namespace analysis {
+
+    std::vector<std::shared_ptr<const logic::Formula>> runLemmaTasks(std::vector<LemmaTask> tasks, util::ThreadPool& threadPool, std::vector<std::string>* families)
+    {
+        // each task writes into its own vector, so the tasks don't need to synchronize
+        std::vector<std::vector<std::shared_ptr<const logic::Formula>>> lemmasOfTasks(tasks.size());
+        // the jobs run on the threads of the pool, which need to construct the lemmas in the context of the caller
+        auto& context = logic::Context::current();
+        std::vector<std::function<void()>> jobs;
+        for (size_t i = 0; i < tasks.size(); ++i)
+        {
+            auto& task = tasks[i];
+            auto& lemmasOfTask = lemmasOfTasks[i];
+            jobs.push_back([&context, &task, &lemmasOfTask]{
+                logic::Context::Scope scope(context);
+                task.generate(lemmasOfTask);
+            });
+        }
+        threadPool.run(std::move(jobs));
+
+        std::vector<std::shared_ptr<const logic::Formula>> lemmas;
+        for (size_t i = 0; i < tasks.size(); ++i)
+        {
+            lemmas.insert(lemmas.end(), lemmasOfTasks[i].begin(), lemmasOfTasks[i].end());
+            if (families != nullptr)
+            {
+                families->insert(families->end(), lemmasOfTasks[i].size(), tasks[i].family);
+            }
+        }
+        return lemmas;
+    }
+
+    void collectLoops(const program::Statement* statement, std::vector<const program::WhileStatement*>& loops)
+    {
+        if (statement->type() == program::Statement::Type::IfElse)
+        {
+            auto castedStatement = static_cast<const program::IfElse*>(statement);
+            // recurse on both branches
+            for (const auto& statement : castedStatement->ifStatements)
+            {
+                collectLoops(statement.get(), loops);
+            }
+            for (const auto& statement : castedStatement->elseStatements)
+            {
+                collectLoops(statement.get(), loops);
+            }
+        }
+        else if (statement->type() == program::Statement::Type::WhileStatement)
+        {
+            auto castedStatement = static_cast<const program::WhileStatement*>(statement);
+            loops.push_back(castedStatement);
+            // recurse on body
+            for (const auto& statement : castedStatement->bodyStatements)
+            {
+                collectLoops(statement.get(), loops);
+            }
+        }
+    }
+}
@@ -0,0 +1,34 @@
+#ifndef __LemmaTasks__
+#define __LemmaTasks__
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Formula.hpp"
+#include "Statements.hpp"
+#include "ThreadPool.hpp"
+
+namespace analysis {
+
+    /*
+     * A lemma task generates a part of the lemmas (usually the lemmas of a single family for a single loop) and appends them to lemmas.
+     * Lemma tasks are independent of each other, so they can be run concurrently.
+     */
+    struct LemmaTask
+    {
+        std::string family;
+        std::function<void(std::vector<std::shared_ptr<const logic::Formula>>& lemmas)> generate;
+    };
+
+    // runs the tasks on threadPool and returns the lemmas generated by the tasks, in the order of the tasks.
+    // in particular the result doesn't depend on the number of threads.
+    // if families is not nullptr, the family of each returned lemma is appended to families.
+    std::vector<std::shared_ptr<const logic::Formula>> runLemmaTasks(std::vector<LemmaTask> tasks, util::ThreadPool& threadPool, std::vector<std::string>* families = nullptr);
+
+    // appends the loops occurring in statement (including statement itself and nested loops) to loops, in pre-order
+    void collectLoops(const program::Statement* statement, std::vector<const program::WhileStatement*>& loops);
+}
+
+#endif
@@ -1,7 +1,7 @@
 #include "Semantics.hpp"
 
-#include <algorithm>
 #include <memory>
+#include <unordered_set>
 #include <vector>
 #include <cassert>
 
@@ -15,17 +15,24 @@
 
 namespace analysis {
     
-    std::vector<std::shared_ptr<const program::Variable>> intersection(std::vector<std::shared_ptr<const program::Variable>> v1,
-                                                                       std::vector<std::shared_ptr<const program::Variable>> v2)
+    // returns the variables of v1 which also occur in v2, in the order of v1.
+    // (the result must not be ordered by the addresses of the variables, since it determines the order of conjuncts in the output)
+    std::vector<std::shared_ptr<const program::Variable>> intersection(const std::vector<std::shared_ptr<const program::Variable>>& v1,
+                                                                       const std::vector<std::shared_ptr<const program::Variable>>& v2)
     {
+        std::unordered_set<const program::Variable*> vars2;
+        for (const auto& var : v2)
+        {
+            vars2.insert(var.get());
+        }
         std::vector<std::shared_ptr<const program::Variable>> v3;
-        
-        std::sort(v1.begin(), v1.end());
-        std::sort(v2.begin(), v2.end());
-        
-        std::set_intersection(v1.begin(),v1.end(),
-                              v2.begin(),v2.end(),
-                              back_inserter(v3));
+        for (const auto& var : v1)
+        {
+            if (vars2.count(var.get()) > 0)
+            {
+                v3.push_back(var);
+            }
+        }
         return v3;
     }
 
@@ -5,55 +5,36 @@
 #include "Theory.hpp"
 #include "SymbolDeclarations.hpp"
 #include "SemanticsHelper.hpp"
+#include "ThreadPool.hpp"
 
 namespace analysis
 {
     std::vector<std::shared_ptr<const logic::Formula>> StaticAnalysis::generateStaticAnalysisLemmas()
     {
-        std::vector<std::shared_ptr<const logic::Formula>> lemmas;
-
-        for(const auto& function : program.functions)
-        {
-            std::vector<std::shared_ptr<const logic::Formula>> conjunctsFunction;
-            
-            for (const auto& statement : function->statements)
-            {
-                generateStaticAnalysisLemmas(statement.get(), lemmas);
-            }
-        }
-        
-        return lemmas;
+        util::ThreadPool threadPool(1);
+        return runLemmaTasks(generateTasks(), threadPool);
     }
     
-    void StaticAnalysis::generateStaticAnalysisLemmas(const program::Statement* statement,
-                                                      std::vector<std::shared_ptr<const logic::Formula>>& lemmas)
+    std::vector<LemmaTask> StaticAnalysis::generateTasks()
     {
-        if (statement->type() == program::Statement::Type::IfElse)
+        std::vector<const program::WhileStatement*> loops;
+        for(const auto& function : program.functions)
         {
-            auto castedStatement = static_cast<const program::IfElse*>(statement);
-            // recurse on both branches
-            for (const auto& statement : castedStatement->ifStatements)
-            {
-                generateStaticAnalysisLemmas(statement.get(), lemmas);
-            }
-            for (const auto& statement : castedStatement->elseStatements)
+            for (const auto& statement : function->statements)
             {
-                generateStaticAnalysisLemmas(statement.get(), lemmas);
+                collectLoops(statement.get(), loops);
             }
         }
-        else if (statement->type() == program::Statement::Type::WhileStatement)
+        
+        std::vector<LemmaTask> tasks;
+        for (const auto& loop : loops)
         {
-            auto castedStatement = static_cast<const program::WhileStatement*>(statement);
-            // generate lemmas
-            generateStaticAnalysisLemmasUnassignedVars(castedStatement, lemmas);
-            //generateStaticAnalysisLemmasAssignedVars(castedStatement, lemmas);
-            
-            // recurse on body
-            for (const auto& statement : castedStatement->bodyStatements)
-            {
-                generateStaticAnalysisLemmas(statement.get(), lemmas);
-            }
+            tasks.push_back({"staticAnalysis", [this, loop](std::vector<std::shared_ptr<const logic::Formula>>& lemmas){
+                generateStaticAnalysisLemmasUnassignedVars(loop, lemmas);
+                //generateStaticAnalysisLemmasAssignedVars(loop, lemmas);
+            }});
         }
+        return tasks;
     }
     
     void StaticAnalysis::generateStaticAnalysisLemmasUnassignedVars(const program::WhileStatement* whileStatement,
@@ -11,6 +11,8 @@
 #include "Variable.hpp"
 #include "Formula.hpp"
 
+#include "LemmaTasks.hpp"
+
 namespace analysis
 {
     class StaticAnalysis
@@ -24,17 +26,14 @@ namespace analysis
         twoTraces(twoTraces) {}
         
         std::vector<std::shared_ptr<const logic::Formula>> generateStaticAnalysisLemmas();
+        // the tasks generating the lemmas, in the order in which generateStaticAnalysisLemmas() returns their lemmas (cf. runLemmaTasks)
+        std::vector<LemmaTask> generateTasks();
 
     private:
         const program::Program& program;
         const std::unordered_map<std::string, std::vector<std::shared_ptr<const program::Variable>>> locationToActiveVars;
         const bool twoTraces;
         
-        void generateStaticAnalysisLemmas(const program::Statement* statement,
-                                             std::vector<std::shared_ptr<const logic::Formula>>& lemmas);
-        void generateStaticAnalysisLemmas(const program::WhileStatement* whileStatement,
-                                             std::vector<std::shared_ptr<const logic::Formula>>& lemmas);
-        
         void generateStaticAnalysisLemmasUnassignedVars(const program::WhileStatement* whileStatement,
                                                       std::vector<std::shared_ptr<const logic::Formula>>& lemmas);
 
@@ -9,6 +9,7 @@
 #include "Theory.hpp"
 #include "Options.hpp"
 #include "Output.hpp"
+#include "ThreadPool.hpp"
 
 #include "SymbolDeclarations.hpp"
 #include "SemanticsHelper.hpp"
@@ -21,75 +22,80 @@ namespace analysis {
     
     std::vector<std::shared_ptr<const logic::Formula>> TraceLemmas::generate()
     {
-        std::vector<std::shared_ptr<const logic::Formula>> lemmas;
-        
-        // generate standard induction lemmas for all loops, all variables and the predicates =,<,>,<=,>=.
-        generateStandardInductionLemmas(lemmas);
-        generateAtLeastOneIterationLemmas(lemmas);
-        generateIntermediateValueLemmas(lemmas);
-        // generateValuePreservationLemmas(lemmas);
-        generateIterationInjectivityLemmas(lemmas);
-
-        if (twoTraces)
-        {
-            // generate for each active variable at each loop an induction lemma for equality of the variable on both traces
-            generateTwoTracesLemmas(lemmas);
-            generateNEqualLemmas(lemmas);
-            generateEqualityPreservationLemmas(lemmas);
-            generateOrderingSynchronizationLemmas(lemmas);
-        }
-        return lemmas;
+        util::ThreadPool threadPool(1);
+        return runLemmaTasks(generateTasks(), threadPool);
     }
-
-#pragma mark - Standard Induction Lemmas
-    
-    void TraceLemmas::generateStandardInductionLemmas(std::vector<std::shared_ptr<const logic::Formula>>& lemmas)
     
+    std::vector<LemmaTask> TraceLemmas::generateTasks()
     {
+        std::vector<LemmaTask> tasks;
+        
+        std::vector<const program::WhileStatement*> loops;
         for(const auto& function : program.functions)
         {
-            std::vector<std::shared_ptr<const logic::Formula>> conjunctsFunction;
-            
             for (const auto& statement : function->statements)
             {
-                generateStandardInductionLemmas(statement.get(), lemmas);
+                collectLoops(statement.get(), loops);
             }
         }
-    }
-
-    void TraceLemmas::generateStandardInductionLemmas(const program::Statement* statement,
-                                             std::vector<std::shared_ptr<const logic::Formula>>& lemmas)
-{
-    if (statement->type() == program::Statement::Type::IfElse)
-    {
-        auto castedStatement = static_cast<const program::IfElse*>(statement);
-        // recurse on both branches
-        for (const auto& statement : castedStatement->ifStatements)
+        
+        // generate standard induction lemmas for all loops, all variables and the predicates =,<,>,<=,>=.
+        for (const auto& loop : loops)
         {
-            generateStandardInductionLemmas(statement.get(), lemmas);
+            tasks.push_back({"standardInduction", [this, loop](std::vector<std::shared_ptr<const logic::Formula>>& lemmas){
+                generateStandardInductionLemmas(loop, lemmas, InductionKind::Equal);
+                // generateStandardInductionLemmas(loop, lemmas, InductionKind::Less);
+                // generateStandardInductionLemmas(loop, lemmas, InductionKind::Greater);
+                // generateStandardInductionLemmas(loop, lemmas, InductionKind::LessEqual);
+                // generateStandardInductionLemmas(loop, lemmas, InductionKind::GreaterEqual);
+            }});
         }
-        for (const auto& statement : castedStatement->elseStatements)
+        addTasks(tasks, loops, "atLeastOneIteration", &TraceLemmas::generateAtLeastOneIterationLemmas);
+        addTasks(tasks, loops, "intermediateValue", &TraceLemmas::generateIntermediateValueLemmas);
+        // addTasks(tasks, loops, "valuePreservation", &TraceLemmas::generateValuePreservationLemmas);
+        addTasks(tasks, loops, "iterationInjectivity", &TraceLemmas::generateIterationInjectivityLemmas);
+
+        if (twoTraces)
         {
-            generateStandardInductionLemmas(statement.get(), lemmas);
+            // generate for each active variable at each loop an induction lemma for equality of the variable on both traces
+            addTasks(tasks, loops, "twoTraces", &TraceLemmas::generateTwoTracesLemmas);
+            addTasks(tasks, loops, "nEqual", &TraceLemmas::generateNEqualLemmas);
+            
+            // the equality preservation lemmas are grouped by top-level statement
+            for(const auto& function : program.functions)
+            {
+                for (const auto& statement : function->statements)
+                {
+                    std::vector<const program::WhileStatement*> loopsOfStatement;
+                    collectLoops(statement.get(), loopsOfStatement);
+                    // from zero to right bound
+                    addTasks(tasks, loopsOfStatement, "equalityPreservationZeroToRight", &TraceLemmas::generateEqualityPreservationLemmasZeroToRight);
+                    // from left bound to n
+                    addTasks(tasks, loopsOfStatement, "equalityPreservationLeftToEnd", &TraceLemmas::generateEqualityPreservationLemmasLeftToEnd);
+                    // from left bound to right bound - skipped for now
+                    // addTasks(tasks, loopsOfStatement, "equalityPreservationLeftToRight", &TraceLemmas::generateEqualityPreservationLemmasLeftToRight);
+                }
+            }
+            
+            addTasks(tasks, loops, "orderingSynchronization", &TraceLemmas::generateOrderingSynchronizationLemmas);
         }
+        return tasks;
     }
-    else if (statement->type() == program::Statement::Type::WhileStatement)
+    
+    void TraceLemmas::addTasks(std::vector<LemmaTask>& tasks,
+                               const std::vector<const program::WhileStatement*>& loops,
+                               const std::string& family,
+                               LoopLemmaGenerator generateLemmas)
     {
-        auto castedStatement = static_cast<const program::WhileStatement*>(statement);
-        // generate lemmas
-        generateStandardInductionLemmas(castedStatement, lemmas, InductionKind::Equal);
-        // generateStandardInductionLemmas(castedStatement, lemmas, InductionKind::Less);
-        // generateStandardInductionLemmas(castedStatement, lemmas, InductionKind::Greater);
-        // generateStandardInductionLemmas(castedStatement, lemmas, InductionKind::LessEqual);
-        // generateStandardInductionLemmas(castedStatement, lemmas, InductionKind::GreaterEqual);
-        
-        // recurse on body
-        for (const auto& statement : castedStatement->bodyStatements)
+        for (const auto& loop : loops)
         {
-            generateStandardInductionLemmas(statement.get(), lemmas);
+            tasks.push_back({family, [this, loop, generateLemmas](std::vector<std::shared_ptr<const logic::Formula>>& lemmas){
+                (this->*generateLemmas)(loop, lemmas);
+            }});
         }
     }
-}
+
+#pragma mark - Standard Induction Lemmas
     
     void TraceLemmas::generateStandardInductionLemmas(const program::WhileStatement* whileStatement,
                                                       std::vector<std::shared_ptr<const logic::Formula>>& lemmas,
@@ -302,49 +308,6 @@ namespace analysis {
     }
     
 #pragma mark - Lemmas for two traces
-    void TraceLemmas::generateTwoTracesLemmas(std::vector<std::shared_ptr<const logic::Formula>>& lemmas)
-    {
-        for(const auto& function : program.functions)
-        {
-            std::vector<std::shared_ptr<const logic::Formula>> conjunctsFunction;
-            
-            for (const auto& statement : function->statements)
-            {
-                generateTwoTracesLemmas(statement.get(), lemmas);
-            }
-        }
-    }
-    
-    void TraceLemmas::generateTwoTracesLemmas(const program::Statement* statement,
-                                                      std::vector<std::shared_ptr<const logic::Formula>>& lemmas)
-    {
-        if (statement->type() == program::Statement::Type::IfElse)
-        {
-            auto castedStatement = static_cast<const program::IfElse*>(statement);
-            // recurse on both branches
-            for (const auto& statement : castedStatement->ifStatements)
-            {
-                generateTwoTracesLemmas(statement.get(), lemmas);
-            }
-            for (const auto& statement : castedStatement->elseStatements)
-            {
-                generateTwoTracesLemmas(statement.get(), lemmas);
-            }
-        }
-        else if (statement->type() == program::Statement::Type::WhileStatement)
-        {
-            auto castedStatement = static_cast<const program::WhileStatement*>(statement);
-            // generate lemmas
-            generateTwoTracesLemmas(castedStatement, lemmas);
-            
-            // recurse on body
-            for (const auto& statement : castedStatement->bodyStatements)
-            {
-                generateTwoTracesLemmas(statement.get(), lemmas);
-            }
-        }
-    }
-    
     void TraceLemmas::generateTwoTracesLemmas(const program::WhileStatement* whileStatement,
                                               std::vector<std::shared_ptr<const logic::Formula>>& lemmas)
     {
@@ -470,50 +433,6 @@ namespace analysis {
         }
     }
     
-    void TraceLemmas::generateNEqualLemmas(std::vector<std::shared_ptr<const logic::Formula>>& lemmas)
-    {
-        for(const auto& function : program.functions)
-        {
-            std::vector<std::shared_ptr<const logic::Formula>> conjunctsFunction;
-            
-            for (const auto& statement : function->statements)
-            {
-                generateNEqualLemmas(statement.get(), lemmas);
-            }
-        }
-    }
-    
-    void TraceLemmas::generateNEqualLemmas(const program::Statement* statement,
-                                              std::vector<std::shared_ptr<const logic::Formula>>& lemmas)
-    {
-        if (statement->type() == program::Statement::Type::IfElse)
-        {
-            auto castedStatement = static_cast<const program::IfElse*>(statement);
-            // recurse on both branches
-            for (const auto& statement : castedStatement->ifStatements)
-            {
-                generateNEqualLemmas(statement.get(), lemmas);
-            }
-            for (const auto& statement : castedStatement->elseStatements)
-            {
-                generateNEqualLemmas(statement.get(), lemmas);
-            }
-        }
-        else if (statement->type() == program::Statement::Type::WhileStatement)
-        {
-            auto castedStatement = static_cast<const program::WhileStatement*>(statement);
-            // generate lemmas
-            generateNEqualLemmas(castedStatement, lemmas);
-            
-            // recurse on body
-            for (const auto& statement : castedStatement->bodyStatements)
-            {
-                generateNEqualLemmas(statement.get(), lemmas);
-            }
-        }
-    }
-    
-
     void TraceLemmas::generateNEqualLemmas(const program::WhileStatement* whileStatement,
                                               std::vector<std::shared_ptr<const logic::Formula>>& lemmas)
     {
@@ -567,50 +486,6 @@ namespace analysis {
     }
 
     #pragma mark - Loop Lemma    
-    void TraceLemmas::generateAtLeastOneIterationLemmas(std::vector<std::shared_ptr<const logic::Formula>>& lemmas)
-    
-    {
-        for(const auto& function : program.functions)
-        {
-            std::vector<std::shared_ptr<const logic::Formula>> conjunctsFunction;
-            
-            for (const auto& statement : function->statements)
-            {
-                generateAtLeastOneIterationLemmas(statement.get(), lemmas);
-            }
-        }
-    }
-
-    void TraceLemmas::generateAtLeastOneIterationLemmas(const program::Statement* statement,
-                                             std::vector<std::shared_ptr<const logic::Formula>>& lemmas)
-    {
-        if (statement->type() == program::Statement::Type::IfElse)
-        {
-            auto castedStatement = static_cast<const program::IfElse*>(statement);
-            // recurse on both branches
-            for (const auto& statement : castedStatement->ifStatements)
-            {
-                generateAtLeastOneIterationLemmas(statement.get(), lemmas);
-            }
-            for (const auto& statement : castedStatement->elseStatements)
-            {
-                generateAtLeastOneIterationLemmas(statement.get(), lemmas);
-            }
-        }
-        else if (statement->type() == program::Statement::Type::WhileStatement)
-        {
-            auto castedStatement = static_cast<const program::WhileStatement*>(statement);
-            // generate lemmas
-            generateAtLeastOneIterationLemmas(castedStatement, lemmas);
-               
-            // recurse on body
-            for (const auto& statement : castedStatement->bodyStatements)
-            {
-                generateAtLeastOneIterationLemmas(statement.get(), lemmas);
-            }
-        }
-    }
-
     void TraceLemmas::generateAtLeastOneIterationLemmas(const program::WhileStatement* whileStatement,
                                                       std::vector<std::shared_ptr<const logic::Formula>>& lemmas)
     {               
@@ -663,50 +538,6 @@ namespace analysis {
     #pragma mark - Intermediate Value Lemma
 
 
-    void TraceLemmas::generateIntermediateValueLemmas(std::vector<std::shared_ptr<const logic::Formula>>& lemmas)
-    
-    {
-        for(const auto& function : program.functions)
-        {
-            std::vector<std::shared_ptr<const logic::Formula>> conjunctsFunction;
-            
-            for (const auto& statement : function->statements)
-            {
-                generateIntermediateValueLemmas(statement.get(), lemmas);
-            }
-        }
-    }
-
-    void TraceLemmas::generateIntermediateValueLemmas(const program::Statement* statement,
-                                             std::vector<std::shared_ptr<const logic::Formula>>& lemmas)
-    {
-        if (statement->type() == program::Statement::Type::IfElse)
-        {
-            auto castedStatement = static_cast<const program::IfElse*>(statement);
-            // recurse on both branches
-            for (const auto& statement : castedStatement->ifStatements)
-            {
-                generateIntermediateValueLemmas(statement.get(), lemmas);
-            }
-            for (const auto& statement : castedStatement->elseStatements)
-            {
-                generateIntermediateValueLemmas(statement.get(), lemmas);
-            }
-        }
-        else if (statement->type() == program::Statement::Type::WhileStatement)
-        {
-            auto castedStatement = static_cast<const program::WhileStatement*>(statement);
-            // generate lemmas
-            generateIntermediateValueLemmas(castedStatement, lemmas);
-               
-            // recurse on body
-            for (const auto& statement : castedStatement->bodyStatements)
-            {
-                generateIntermediateValueLemmas(statement.get(), lemmas);
-            }
-        }
-    }
-
     void TraceLemmas::generateIntermediateValueLemmas(const program::WhileStatement* whileStatement,
                                                       std::vector<std::shared_ptr<const logic::Formula>>& lemmas)
     {                 
@@ -887,50 +718,6 @@ namespace analysis {
     }
 
     #pragma mark - Value Preservation Lemma
-    void TraceLemmas::generateValuePreservationLemmas(std::vector<std::shared_ptr<const logic::Formula>>& lemmas)
-    
-    {
-        for(const auto& function : program.functions)
-        {
-            std::vector<std::shared_ptr<const logic::Formula>> conjunctsFunction;
-            
-            for (const auto& statement : function->statements)
-            {
-                generateValuePreservationLemmas(statement.get(), lemmas);
-            }
-        }
-    }
-
-    void TraceLemmas::generateValuePreservationLemmas(const program::Statement* statement,
-                                             std::vector<std::shared_ptr<const logic::Formula>>& lemmas)
-    {
-        if (statement->type() == program::Statement::Type::IfElse)
-        {
-            auto castedStatement = static_cast<const program::IfElse*>(statement);
-            // recurse on both branches
-            for (const auto& statement : castedStatement->ifStatements)
-            {
-                generateValuePreservationLemmas(statement.get(), lemmas);
-            }
-            for (const auto& statement : castedStatement->elseStatements)
-            {
-                generateValuePreservationLemmas(statement.get(), lemmas);
-            }
-        }
-        else if (statement->type() == program::Statement::Type::WhileStatement)
-        {
-            auto castedStatement = static_cast<const program::WhileStatement*>(statement);
-            // generate lemmas
-            generateValuePreservationLemmas(castedStatement, lemmas);
-               
-            // recurse on body
-            for (const auto& statement : castedStatement->bodyStatements)
-            {
-                generateValuePreservationLemmas(statement.get(), lemmas);
-            }
-        }
-    }
-
     void TraceLemmas::generateValuePreservationLemmas(const program::WhileStatement* whileStatement,
                                                       std::vector<std::shared_ptr<const logic::Formula>>& lemmas)
     {                 
@@ -1114,50 +901,6 @@ namespace analysis {
     }
 
         #pragma mark - Iteration Injection Lemma
-    void TraceLemmas::generateIterationInjectivityLemmas(std::vector<std::shared_ptr<const logic::Formula>>& lemmas)
-    
-    {
-        for(const auto& function : program.functions)
-        {
-            std::vector<std::shared_ptr<const logic::Formula>> conjunctsFunction;
-            
-            for (const auto& statement : function->statements)
-            {
-                generateIterationInjectivityLemmas(statement.get(), lemmas);
-            }
-        }
-    }
-
-    void TraceLemmas::generateIterationInjectivityLemmas(const program::Statement* statement,
-                                             std::vector<std::shared_ptr<const logic::Formula>>& lemmas)
-    {
-        if (statement->type() == program::Statement::Type::IfElse)
-        {
-            auto castedStatement = static_cast<const program::IfElse*>(statement);
-            // recurse on both branches
-            for (const auto& statement : castedStatement->ifStatements)
-            {
-                generateIterationInjectivityLemmas(statement.get(), lemmas);
-            }
-            for (const auto& statement : castedStatement->elseStatements)
-            {
-                generateIterationInjectivityLemmas(statement.get(), lemmas);
-            }
-        }
-        else if (statement->type() == program::Statement::Type::WhileStatement)
-        {
-            auto castedStatement = static_cast<const program::WhileStatement*>(statement);
-            // generate lemmas
-            generateIterationInjectivityLemmas(castedStatement, lemmas);
-               
-            // recurse on body
-            for (const auto& statement : castedStatement->bodyStatements)
-            {
-                generateIterationInjectivityLemmas(statement.get(), lemmas);
-            }
-        }
-    }
-
     void TraceLemmas::generateIterationInjectivityLemmas(const program::WhileStatement* whileStatement,
                                                       std::vector<std::shared_ptr<const logic::Formula>>& lemmas)
     {
@@ -1260,56 +1003,6 @@ namespace analysis {
 
 
     #pragma mark - Equality preservation over traces Lemma
-    void TraceLemmas::generateEqualityPreservationLemmas(std::vector<std::shared_ptr<const logic::Formula>>& lemmas)
-
-    {
-        for(const auto& function : program.functions)
-        {
-            std::vector<std::shared_ptr<const logic::Formula>> conjunctsFunction;
-
-            for (const auto& statement : function->statements)
-            {
-                // from zero to right bound
-                generateEqualityPreservationLemmasZeroToRight(statement.get(), lemmas);
-                // from left bound to n
-                generateEqualityPreservationLemmasLeftToEnd(statement.get(), lemmas);
-                // from left bound to right bound - skipped for now
-                // generateEqualityPreservationLemmasLeftToRight(statement.get(), lemmas);
-            }
-        }
-    }
-
-    void TraceLemmas::generateEqualityPreservationLemmasZeroToRight(const program::Statement* statement,
-                                             std::vector<std::shared_ptr<const logic::Formula>>& lemmas)
-    {
-        if (statement->type() == program::Statement::Type::IfElse)
-        {
-            auto castedStatement = static_cast<const program::IfElse*>(statement);
-            // recurse on both branches
-            for (const auto& statement : castedStatement->ifStatements)
-            {
-                generateEqualityPreservationLemmasZeroToRight(statement.get(), lemmas);
-            }
-            for (const auto& statement : castedStatement->elseStatements)
-            {
-                generateEqualityPreservationLemmasZeroToRight(statement.get(), lemmas);
-            }
-        }
-        else if (statement->type() == program::Statement::Type::WhileStatement)
-        {
-            auto castedStatement = static_cast<const program::WhileStatement*>(statement);
-            // generate lemmas
-            // from zero to right bound
-            generateEqualityPreservationLemmasZeroToRight(castedStatement, lemmas);
-
-            // recurse on body
-            for (const auto& statement : castedStatement->bodyStatements)
-            {
-                generateEqualityPreservationLemmasZeroToRight(statement.get(), lemmas);
-            }
-        }
-    }
-
     void TraceLemmas::generateEqualityPreservationLemmasZeroToRight(const program::WhileStatement* whileStatement,
                                                       std::vector<std::shared_ptr<const logic::Formula>>& lemmas)
     {
@@ -1493,37 +1186,6 @@ namespace analysis {
         }
     }
 
-    void TraceLemmas::generateEqualityPreservationLemmasLeftToEnd(const program::Statement* statement,
-                                             std::vector<std::shared_ptr<const logic::Formula>>& lemmas)
-    {
-        if (statement->type() == program::Statement::Type::IfElse)
-        {
-            auto castedStatement = static_cast<const program::IfElse*>(statement);
-            // recurse on both branches
-            for (const auto& statement : castedStatement->ifStatements)
-            {
-                generateEqualityPreservationLemmasLeftToEnd(statement.get(), lemmas);
-            }
-            for (const auto& statement : castedStatement->elseStatements)
-            {
-                generateEqualityPreservationLemmasLeftToEnd(statement.get(), lemmas);
-            }
-        }
-        else if (statement->type() == program::Statement::Type::WhileStatement)
-        {
-            auto castedStatement = static_cast<const program::WhileStatement*>(statement);
-            // generate lemmas
-            // from zero to right bound
-            generateEqualityPreservationLemmasLeftToEnd(castedStatement, lemmas);
-
-            // recurse on body
-            for (const auto& statement : castedStatement->bodyStatements)
-            {
-                generateEqualityPreservationLemmasLeftToEnd(statement.get(), lemmas);
-            }
-        }
-    }
-
     void TraceLemmas::generateEqualityPreservationLemmasLeftToEnd(const program::WhileStatement* whileStatement,
                                                       std::vector<std::shared_ptr<const logic::Formula>>& lemmas)
     {
@@ -1735,37 +1397,6 @@ namespace analysis {
     }
 
 
-    void TraceLemmas::generateEqualityPreservationLemmasLeftToRight(const program::Statement* statement,
-                                             std::vector<std::shared_ptr<const logic::Formula>>& lemmas)
-    {
-        if (statement->type() == program::Statement::Type::IfElse)
-        {
-            auto castedStatement = static_cast<const program::IfElse*>(statement);
-            // recurse on both branches
-            for (const auto& statement : castedStatement->ifStatements)
-            {
-                generateEqualityPreservationLemmasLeftToRight(statement.get(), lemmas);
-            }
-            for (const auto& statement : castedStatement->elseStatements)
-            {
-                generateEqualityPreservationLemmasLeftToRight(statement.get(), lemmas);
-            }
-        }
-        else if (statement->type() == program::Statement::Type::WhileStatement)
-        {
-            auto castedStatement = static_cast<const program::WhileStatement*>(statement);
-            // generate lemmas
-            // from zero to right bound
-            generateEqualityPreservationLemmasLeftToRight(castedStatement, lemmas);
-
-            // recurse on body
-            for (const auto& statement : castedStatement->bodyStatements)
-            {
-                generateEqualityPreservationLemmasLeftToRight(statement.get(), lemmas);
-            }
-        }
-    }
-
     void TraceLemmas::generateEqualityPreservationLemmasLeftToRight(const program::WhileStatement* whileStatement,
                                                       std::vector<std::shared_ptr<const logic::Formula>>& lemmas)
     {
@@ -1955,52 +1586,6 @@ namespace analysis {
     }
 
     #pragma mark - Synchronization of orderings Lemma
-    void TraceLemmas::generateOrderingSynchronizationLemmas(std::vector<std::shared_ptr<const logic::Formula>>& lemmas)
-    
-    {
-        for(const auto& function : program.functions)
-        {
-            std::vector<std::shared_ptr<const logic::Formula>> conjunctsFunction;
-            
-            for (const auto& statement : function->statements)
-            {
-                generateOrderingSynchronizationLemmas(statement.get(), lemmas);
-            }
-        }
-    }
-
-    void TraceLemmas::generateOrderingSynchronizationLemmas(const program::Statement* statement,
-                                             std::vector<std::shared_ptr<const logic::Formula>>& lemmas)
-    {
-        if (statement->type() == program::Statement::Type::IfElse)
-        {
-            auto castedStatement = static_cast<const program::IfElse*>(statement);
-            // recurse on both branches
-            for (const auto& statement : castedStatement->ifStatements)
-            {
-                generateOrderingSynchronizationLemmas(statement.get(), lemmas);
-            }
-            for (const auto& statement : castedStatement->elseStatements)
-            {
-                generateOrderingSynchronizationLemmas(statement.get(), lemmas);
-            }
-        }
-        else if (statement->type() == program::Statement::Type::WhileStatement)
-        {
-            auto castedStatement = static_cast<const program::WhileStatement*>(statement);
-            // generate lemmas
-            generateOrderingSynchronizationLemmas(castedStatement, lemmas);
-               
-            // recurse on body
-            for (const auto& statement : castedStatement->bodyStatements)
-            {
-                generateOrderingSynchronizationLemmas(statement.get(), lemmas);
-            }
-        }
-    }
-
-
-
     void TraceLemmas::generateOrderingSynchronizationLemmas(const program::WhileStatement* whileStatement,
                                                       std::vector<std::shared_ptr<const logic::Formula>>& lemmas)
     {     
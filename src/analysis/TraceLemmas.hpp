@@ -13,6 +13,8 @@
 #include "Variable.hpp"
 #include "Program.hpp"
 
+#include "LemmaTasks.hpp"
+
 namespace analysis {
     
     class TraceLemmas
@@ -26,6 +28,8 @@ namespace analysis {
         twoTraces(twoTraces) {}
         
         std::vector<std::shared_ptr<const logic::Formula>> generate();
+        // the tasks generating the lemmas, in the order in which generate() returns their lemmas (cf. runLemmaTasks)
+        std::vector<LemmaTask> generateTasks();
         
     private:
         const program::Program& program;
@@ -34,80 +38,36 @@ namespace analysis {
         
         enum class InductionKind { Equal, Less, Greater, LessEqual, GreaterEqual};
         
-        void generateStandardInductionLemmas(std::vector<std::shared_ptr<const logic::Formula>>& lemmas);
-        void generateStandardInductionLemmas(const program::Statement* statement,
-                                             std::vector<std::shared_ptr<const logic::Formula>>& lemmas);
+        // each lemma family is generated separately for each loop
+        using LoopLemmaGenerator = void (TraceLemmas::*)(const program::WhileStatement*, std::vector<std::shared_ptr<const logic::Formula>>&);
+        void addTasks(std::vector<LemmaTask>& tasks,
+                      const std::vector<const program::WhileStatement*>& loops,
+                      const std::string& family,
+                      LoopLemmaGenerator generateLemmas);
+        
         void generateStandardInductionLemmas(const program::WhileStatement* whileStatement,
                                              std::vector<std::shared_ptr<const logic::Formula>>& lemmas,
                                              const InductionKind kind);
-        
-        void generateTwoTracesLemmas(std::vector<std::shared_ptr<const logic::Formula>>& lemmas);
-        void generateTwoTracesLemmas(const program::Statement* statement,
-                                             std::vector<std::shared_ptr<const logic::Formula>>& lemmas);
         void generateTwoTracesLemmas(const program::WhileStatement* whileStatement,
-                                             std::vector<std::shared_ptr<const logic::Formula>>& lemmas);
-        
-        void generateNEqualLemmas(std::vector<std::shared_ptr<const logic::Formula>>& lemmas);
-        void generateNEqualLemmas(const program::Statement* statement,
                                      std::vector<std::shared_ptr<const logic::Formula>>& lemmas);
         void generateNEqualLemmas(const program::WhileStatement* whileStatement,
-                                     std::vector<std::shared_ptr<const logic::Formula>>& lemmas);
-
-        void generateAtLeastOneIterationLemmas(std::vector<std::shared_ptr<const logic::Formula>>& lemmas);
-        void generateAtLeastOneIterationLemmas(const program::Statement* statement,
-                                             std::vector<std::shared_ptr<const logic::Formula>>& lemmas);
+                                  std::vector<std::shared_ptr<const logic::Formula>>& lemmas);
         void generateAtLeastOneIterationLemmas(const program::WhileStatement* whileStatement,
-                                             std::vector<std::shared_ptr<const logic::Formula>>& lemmas);
-
-        void generateIntermediateValueLemmas(std::vector<std::shared_ptr<const logic::Formula>>& lemmas);
-        void generateIntermediateValueLemmas(const program::Statement* statement,
-                                             std::vector<std::shared_ptr<const logic::Formula>>& lemmas);
+                                               std::vector<std::shared_ptr<const logic::Formula>>& lemmas);
         void generateIntermediateValueLemmas(const program::WhileStatement* whileStatement,
                                              std::vector<std::shared_ptr<const logic::Formula>>& lemmas);
-
-        void generateValuePreservationLemmas(std::vector<std::shared_ptr<const logic::Formula>>& lemmas);
-        void generateValuePreservationLemmas(const program::Statement* statement,
-                                             std::vector<std::shared_ptr<const logic::Formula>>& lemmas);
         void generateValuePreservationLemmas(const program::WhileStatement* whileStatement,
                                              std::vector<std::shared_ptr<const logic::Formula>>& lemmas);
-
-        void generateEqualityPreservationLemmas(std::vector<std::shared_ptr<const logic::Formula>>& lemmas);
-        void generateEqualityPreservationLemmas(const program::Statement* statement,
-                                             std::vector<std::shared_ptr<const logic::Formula>>& lemmas);
-        void generateEqualityPreservationLemmas(const program::WhileStatement* whileStatement,
-                                             std::vector<std::shared_ptr<const logic::Formula>>& lemmas);
-
-
-        void generateEqualityPreservationLemmasZeroToRight(std::vector<std::shared_ptr<const logic::Formula>>& lemmas);
-        void generateEqualityPreservationLemmasZeroToRight(const program::Statement* statement,
-                                              std::vector<std::shared_ptr<const logic::Formula>>& lemmas);
         void generateEqualityPreservationLemmasZeroToRight(const program::WhileStatement* whileStatement,
-                                                                                  std::vector<std::shared_ptr<const logic::Formula>>& lemmas);
-
-        void generateEqualityPreservationLemmasLeftToEnd(std::vector<std::shared_ptr<const logic::Formula>>& lemmas);
-        void generateEqualityPreservationLemmasLeftToEnd(const program::Statement* statement,
-                                             std::vector<std::shared_ptr<const logic::Formula>>& lemmas);
+                                                           std::vector<std::shared_ptr<const logic::Formula>>& lemmas);
         void generateEqualityPreservationLemmasLeftToEnd(const program::WhileStatement* whileStatement,
-                                             std::vector<std::shared_ptr<const logic::Formula>>& lemmas);
-
-        void generateEqualityPreservationLemmasLeftToRight(std::vector<std::shared_ptr<const logic::Formula>>& lemmas);
-        void generateEqualityPreservationLemmasLeftToRight(const program::Statement* statement,
-                                            std::vector<std::shared_ptr<const logic::Formula>>& lemmas);
+                                                         std::vector<std::shared_ptr<const logic::Formula>>& lemmas);
         void generateEqualityPreservationLemmasLeftToRight(const program::WhileStatement* whileStatement,
-                                            std::vector<std::shared_ptr<const logic::Formula>>& lemmas);
-
-        void generateIterationInjectivityLemmas(std::vector<std::shared_ptr<const logic::Formula>>& lemmas);
-        void generateIterationInjectivityLemmas(const program::Statement* statement,
-                                             std::vector<std::shared_ptr<const logic::Formula>>& lemmas);
+                                                           std::vector<std::shared_ptr<const logic::Formula>>& lemmas);
         void generateIterationInjectivityLemmas(const program::WhileStatement* whileStatement,
-                                             std::vector<std::shared_ptr<const logic::Formula>>& lemmas);
-
-        void generateOrderingSynchronizationLemmas(std::vector<std::shared_ptr<const logic::Formula>>& lemmas);
-        void generateOrderingSynchronizationLemmas(const program::Statement* statement,
-                                             std::vector<std::shared_ptr<const logic::Formula>>& lemmas);
+                                                std::vector<std::shared_ptr<const logic::Formula>>& lemmas);
         void generateOrderingSynchronizationLemmas(const program::WhileStatement* whileStatement,
-                                             std::vector<std::shared_ptr<const logic::Formula>>& lemmas);
-
+                                                   std::vector<std::shared_ptr<const logic::Formula>>& lemmas);
     };
 }
 
@@ -0,0 +1,105 @@
+#include "ProgramGenerator.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <cassert>
+
+namespace bench {
+
+    void ProgramGenerator::generate(std::ostream& ostr)
+    {
+        assert(parameters.numberOfVariables > 0);
+        numberOfEmittedStatements = 0;
+
+        if (parameters.twoTraces)
+        {
+            ostr << "(two-traces)\n";
+        }
+        ostr << "func main()\n{\n";
+        ostr << "\tconst Int n;\n";
+        for (unsigned i = 0; i < parameters.numberOfVariables; ++i)
+        {
+            ostr << "\tInt " << variable(i) << ";\n";
+            ostr << "\tInt[] " << array(i) << ";\n";
+        }
+        for (unsigned level = 0; level < parameters.loopDepth; ++level)
+        {
+            ostr << "\tInt " << counter(level) << ";\n";
+        }
+        ostr << "\n";
+        generateStatements(ostr, 0, std::max(1u, parameters.numberOfStatements), 1);
+        ostr << "}\n\n";
+
+        // the conjecture is irrelevant for the encoding, so we use a trivial one
+        if (parameters.twoTraces)
+        {
+            ostr << "(assert-not\n\t(= (" << variable(0) << " main_end t1) (" << variable(0) << " main_end t2))\n)\n";
+        }
+        else
+        {
+            ostr << "(assert-not\n\t(= (" << variable(0) << " main_end) (" << variable(0) << " main_end))\n)\n";
+        }
+    }
+
+    void ProgramGenerator::generateStatements(std::ostream& ostr, unsigned level, unsigned budget, unsigned indentation)
+    {
+        std::string indent(indentation, '\t');
+        while (budget > 0)
+        {
+            // a loop needs at least 4 statements: the initialization of the counter, the loop itself, the increment and one further statement
+            if (level < parameters.loopDepth && budget >= 4)
+            {
+                // give half of the remaining budget to the loop body, so that each level contains both loops and simple statements
+                auto bodyBudget = std::max(1u, (budget - 3) / 2);
+                ostr << indent << counter(level) << " = 0;\n";
+                ostr << indent << "while(" << counter(level) << " < n)\n";
+                ostr << indent << "{\n";
+                generateStatements(ostr, level + 1, bodyBudget, indentation + 1);
+                ostr << indent << "\t" << counter(level) << " = " << counter(level) << " + 1;\n";
+                ostr << indent << "}\n";
+                budget -= bodyBudget + 3;
+            }
+            else
+            {
+                budget -= generateSimpleStatement(ostr, level, budget, indentation);
+            }
+        }
+    }
+
+    unsigned ProgramGenerator::generateSimpleStatement(std::ostream& ostr, unsigned level, unsigned budget, unsigned indentation)
+    {
+        std::string indent(indentation, '\t');
+        auto k = numberOfEmittedStatements++;
+        // inside of loops, arrays are accessed at the counter of the innermost loop
+        auto index = level > 0 ? counter(level - 1) : "0";
+
+        switch (k % 4)
+        {
+            case 0:
+                ostr << indent << variable(k) << " = " << variable(k) << " + " << array(k) << "[" << index << "];\n";
+                return 1;
+            case 1:
+                ostr << indent << array(k) << "[" << index << "] = " << variable(k + 1) << ";\n";
+                return 1;
+            case 2:
+                ostr << indent << variable(k) << " = " << variable(k + 1) << " - " << variable(k) << ";\n";
+                return 1;
+            default:
+                if (budget < 3)
+                {
+                    ostr << indent << variable(k) << " = " << variable(k) << " + 1;\n";
+                    return 1;
+                }
+                ostr << indent << "if(" << variable(k) << " > " << variable(k + 1) << ")\n";
+                ostr << indent << "{\n";
+                ostr << indent << "\t" << variable(k) << " = " << variable(k + 1) << ";\n";
+                ostr << indent << "}\n";
+                ostr << indent << "else\n";
+                ostr << indent << "{\n";
+                ostr << indent << "\t" << variable(k + 1) << " = " << variable(k) << ";\n";
+                ostr << indent << "}\n";
+                return 3;
+        }
+    }
+}
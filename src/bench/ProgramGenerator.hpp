@@ -0,0 +1,44 @@
+#ifndef __ProgramGenerator__
+#define __ProgramGenerator__
+
+#include <iostream>
+#include <string>
+
+namespace bench {
+
+    /*
+     * Generates synthetic while-programs (including a trivial conjecture) for benchmarking.
+     * The programs are deterministic functions of the parameters, so runs with the same parameters are comparable.
+     */
+    class ProgramGenerator
+    {
+    public:
+        struct Parameters
+        {
+            unsigned numberOfStatements = 20; // number of statements in the program, counting loops, if-else-statements and their bodies
+            unsigned loopDepth = 2; // maximal nesting depth of loops
+            unsigned numberOfVariables = 2; // number of int variables (and of int array variables)
+            bool twoTraces = false;
+        };
+
+        ProgramGenerator(Parameters parameters) : parameters(parameters), numberOfEmittedStatements(0) {}
+
+        // writes the spec, one statement per line (the locations of the statements are derived from their lines)
+        void generate(std::ostream& ostr);
+
+    private:
+        const Parameters parameters;
+        unsigned numberOfEmittedStatements;
+
+        // emits statements with a total size of budget at loop-nesting level
+        void generateStatements(std::ostream& ostr, unsigned level, unsigned budget, unsigned indentation);
+        // emits a single non-loop statement, which has size 1 (assignment) or 3 (if-else with one statement per branch)
+        unsigned generateSimpleStatement(std::ostream& ostr, unsigned level, unsigned budget, unsigned indentation);
+
+        std::string counter(unsigned level) const { return "i" + std::to_string(level); }
+        std::string variable(unsigned index) const { return "v" + std::to_string(index % parameters.numberOfVariables); }
+        std::string array(unsigned index) const { return "a" + std::to_string(index % parameters.numberOfVariables); }
+    };
+}
+
+#endif
@@ -0,0 +1,300 @@
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "logic/Context.hpp"
+#include "logic/Formula.hpp"
+#include "logic/Signature.hpp"
+#include "logic/Term.hpp"
+
+#include "util/Options.hpp"
+#include "util/Statistics.hpp"
+
+#include "spectre/Encoder.hpp"
+
+#include "ProgramGenerator.hpp"
+
+/*
+ * spectre_bench generates synthetic programs for all combinations of the given parameters,
+ * encodes each program with a spectre::Encoder and reports time, memory and output size per stage (cf. util::Statistics::stages).
+ * Each program is encoded in a separate process, so that the peak memory of a run is not affected by the previous runs.
+ */
+
+namespace {
+
+    struct BenchOptions
+    {
+        std::vector<unsigned> numbersOfStatements = {10, 20, 40, 80};
+        std::vector<unsigned> loopDepths = {2};
+        std::vector<unsigned> numbersOfVariables = {2};
+        std::vector<bool> twoTraces = {false};
+        bool json = false;
+        // all other options are passed on to spectre (cf. util::Configuration)
+        std::vector<std::string> spectreOptions;
+    };
+
+    // counts the characters written into it, without storing them
+    class CountingStreambuf : public std::streambuf
+    {
+    public:
+        size_t count = 0;
+
+    protected:
+        int overflow(int c) override
+        {
+            if (c != EOF)
+            {
+                count++;
+            }
+            return c;
+        }
+        std::streamsize xsputn(const char*, std::streamsize n) override
+        {
+            count += n;
+            return n;
+        }
+    };
+
+    bool parseList(const std::string& value, std::vector<unsigned>& list)
+    {
+        list.clear();
+        std::stringstream stream(value);
+        std::string item;
+        while (std::getline(stream, item, ','))
+        {
+            if (item.empty() || item.size() > 9 || item.find_first_not_of("0123456789") != std::string::npos)
+            {
+                return false;
+            }
+            list.push_back(static_cast<unsigned>(std::stoul(item)));
+        }
+        return !list.empty();
+    }
+
+    bool parseOptions(int argc, char *argv[], BenchOptions& options)
+    {
+        for (int i = 1; i < argc; i += 2)
+        {
+            std::string name = argv[i];
+            if (i + 1 >= argc)
+            {
+                std::cerr << "Missing value for option " << name << std::endl;
+                return false;
+            }
+            std::string value = argv[i + 1];
+
+            bool correct = true;
+            if (name == "-statements")
+            {
+                correct = parseList(value, options.numbersOfStatements);
+            }
+            else if (name == "-depth")
+            {
+                correct = parseList(value, options.loopDepths);
+            }
+            else if (name == "-variables")
+            {
+                correct = parseList(value, options.numbersOfVariables);
+                for (auto numberOfVariables : options.numbersOfVariables)
+                {
+                    correct = correct && numberOfVariables > 0;
+                }
+            }
+            else if (name == "-twotraces")
+            {
+                if (value == "off" || value == "on")
+                {
+                    options.twoTraces = {value == "on"};
+                }
+                else if (value == "both")
+                {
+                    options.twoTraces = {false, true};
+                }
+                else
+                {
+                    correct = false;
+                }
+            }
+            else if (name == "-format")
+            {
+                correct = value == "table" || value == "json";
+                options.json = value == "json";
+            }
+            else
+            {
+                options.spectreOptions.push_back(name);
+                options.spectreOptions.push_back(value);
+            }
+            if (!correct)
+            {
+                std::cerr << value << " is not a correct value for option " << name << std::endl;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void outputUsage()
+    {
+        std::cout << "Usage: spectre_bench [-statements N,...] [-depth D,...] [-variables V,...] [-twotraces off|on|both] [-format table|json] [spectre-options]" << std::endl;
+    }
+
+    // encodes the program generated from parameters and writes the results as a table row or JSON object
+    void runBenchmark(const bench::ProgramGenerator::Parameters& parameters, bool json)
+    {
+        std::ostringstream program;
+        bench::ProgramGenerator(parameters).generate(program);
+        auto input = program.str();
+
+        // the program is not written as comment, since the comment is not part of the encoding of the problem
+        auto encoderOptions = spectre::Encoder::Options::fromConfiguration();
+        encoderOptions.comments = false;
+        spectre::Encoder encoder(encoderOptions);
+
+        CountingStreambuf countingStreambuf;
+        std::string errorMessage;
+        auto problem = encoder.encode(input.data(), input.size(), "generated program", errorMessage);
+        if (problem == nullptr)
+        {
+            std::cerr << errorMessage << std::endl;
+            exit(1);
+        }
+        std::ostream ostr(&countingStreambuf);
+        encoder.write(*problem, ostr);
+
+        const auto& results = util::Statistics::stages();
+        auto numberOfLemmas = problem->lemmas.size();
+        size_t numberOfTerms, numberOfFormulas, numberOfSymbols;
+        {
+            logic::Context::Scope scope(*problem->context);
+            numberOfTerms = logic::Terms::numberOfTerms();
+            numberOfFormulas = logic::Formulas::numberOfFormulas();
+            numberOfSymbols = logic::Signature::signature().size();
+        }
+
+        if (json)
+        {
+            std::cout << std::fixed << std::setprecision(6);
+            std::cout << "{\"statements\": " << parameters.numberOfStatements << ", \"depth\": " << parameters.loopDepth
+                      << ", \"variables\": " << parameters.numberOfVariables << ", \"twoTraces\": " << (parameters.twoTraces ? "true" : "false")
+                      << ", \"stages\": {";
+            for (size_t i = 0; i < results.size(); ++i)
+            {
+                std::cout << (i == 0 ? "" : ", ") << "\"" << results[i].name << "\": {\"wall\": " << results[i].wallSeconds
+                          << ", \"cpu\": " << results[i].cpuSeconds << ", \"maxResidentKB\": " << results[i].maxResidentKB << "}";
+            }
+            std::cout << "}, \"lemmas\": " << numberOfLemmas << ", \"terms\": " << numberOfTerms << ", \"formulas\": " << numberOfFormulas
+                      << ", \"symbols\": " << numberOfSymbols << ", \"outputBytes\": " << countingStreambuf.count << "}";
+        }
+        else
+        {
+            std::cout << std::fixed << std::setprecision(3);
+            for (const auto& result : results)
+            {
+                std::cout << std::setw(10) << parameters.numberOfStatements << std::setw(6) << parameters.loopDepth
+                          << std::setw(6) << parameters.numberOfVariables << std::setw(6) << (parameters.twoTraces ? "yes" : "no")
+                          << "  " << std::left << std::setw(16) << result.name << std::right
+                          << std::setw(10) << result.wallSeconds << std::setw(10) << result.cpuSeconds << std::setw(12) << result.maxResidentKB << "\n";
+            }
+            std::cout << std::setw(10) << parameters.numberOfStatements << std::setw(6) << parameters.loopDepth
+                      << std::setw(6) << parameters.numberOfVariables << std::setw(6) << (parameters.twoTraces ? "yes" : "no")
+                      << "  lemmas " << numberOfLemmas << ", terms " << numberOfTerms << ", formulas " << numberOfFormulas
+                      << ", symbols " << numberOfSymbols << ", output bytes " << countingStreambuf.count << "\n";
+        }
+        std::cout.flush();
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    BenchOptions options;
+    if (!parseOptions(argc, argv, options))
+    {
+        outputUsage();
+        return 1;
+    }
+
+    // setAllValues ignores the last argument, since it is the input file for spectre.
+    std::vector<std::string> spectreArguments = {"spectre_bench"};
+    spectreArguments.insert(spectreArguments.end(), options.spectreOptions.begin(), options.spectreOptions.end());
+    spectreArguments.push_back("");
+    std::vector<char*> spectreArgv;
+    for (auto& argument : spectreArguments)
+    {
+        spectreArgv.push_back(&argument[0]);
+    }
+    if (!util::Configuration::instance().setAllValues(static_cast<int>(spectreArgv.size()), spectreArgv.data()))
+    {
+        outputUsage();
+        return 1;
+    }
+
+    if (options.json)
+    {
+        std::cout << "[";
+    }
+    else
+    {
+        std::cout << std::setw(10) << "statements" << std::setw(6) << "depth" << std::setw(6) << "vars" << std::setw(6) << "2tr"
+                  << "  " << std::left << std::setw(16) << "stage" << std::right
+                  << std::setw(10) << "wall[s]" << std::setw(10) << "cpu[s]" << std::setw(12) << "maxRSS[KB]" << "\n";
+    }
+    bool first = true;
+    bool failed = false;
+    for (auto numberOfStatements : options.numbersOfStatements)
+    {
+        for (auto loopDepth : options.loopDepths)
+        {
+            for (auto numberOfVariables : options.numbersOfVariables)
+            {
+                for (auto twoTraces : options.twoTraces)
+                {
+                    bench::ProgramGenerator::Parameters parameters;
+                    parameters.numberOfStatements = numberOfStatements;
+                    parameters.loopDepth = loopDepth;
+                    parameters.numberOfVariables = numberOfVariables;
+                    parameters.twoTraces = twoTraces;
+
+                    if (options.json)
+                    {
+                        std::cout << (first ? "\n  " : ",\n  ");
+                    }
+                    first = false;
+                    std::cout.flush();
+
+                    auto pid = fork();
+                    if (pid == 0)
+                    {
+                        runBenchmark(parameters, options.json);
+                        _exit(0);
+                    }
+                    int status = 0;
+                    if (pid == -1 || waitpid(pid, &status, 0) == -1 || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+                    {
+                        // report the failure and continue with the remaining programs
+                        if (options.json)
+                        {
+                            std::cout << "{\"statements\": " << numberOfStatements << ", \"depth\": " << loopDepth << ", \"variables\": " << numberOfVariables
+                                      << ", \"twoTraces\": " << (twoTraces ? "true" : "false") << ", \"failed\": true}";
+                        }
+                        std::cerr << "Benchmark with " << numberOfStatements << " statements, depth " << loopDepth << ", "
+                                  << numberOfVariables << " variables" << (twoTraces ? " and two traces" : "") << " failed" << std::endl;
+                        failed = true;
+                    }
+                }
+            }
+        }
+    }
+    if (options.json)
+    {
+        std::cout << "\n]" << std::endl;
+    }
+    return failed ? 1 : 0;
+}
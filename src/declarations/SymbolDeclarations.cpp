@@ -4,6 +4,41 @@
 #include <string>
 #include <vector>
 
+#include "Context.hpp"
+
+/*
+ * The symbols are requested many times during the generation of the semantics and the lemmas.
+ * We therefore remember the id of the symbol corresponding to each program object in the logic::Context of the problem,
+ * so that repeated requests neither need to build the name and the argument sorts of the symbol, nor hash its name.
+ * The tags distinguish the different symbols corresponding to the same program object.
+ */
+namespace {
+    enum SymbolTag : unsigned
+    {
+        LocationSymbol,
+        LeftBranchSymbol,
+        RightBranchSymbol,
+        EndLocationSymbol,
+        LastIterationSymbol,
+        ProgramVarSymbol
+    };
+    
+    template <typename Declare>
+    std::shared_ptr<const logic::Symbol> cachedSymbol(SymbolTag tag, const void* key, Declare declare)
+    {
+        auto& context = logic::Context::current();
+        unsigned id;
+        if (context.cachedSymbolId(key, tag, id))
+        {
+            return logic::Signature::fetch(id);
+        }
+        // declaring the symbol is idempotent, so it doesn't matter if another thread declares it concurrently
+        auto symbol = declare();
+        context.cacheSymbolId(key, tag, symbol->id);
+        return symbol;
+    }
+}
+
 std::shared_ptr<const logic::Symbol> locationSymbol(std::string location, unsigned numberOfLoops)
 {
     auto enclosingIteratorTypes = std::vector<const logic::Sort*>();
@@ -17,42 +52,52 @@ std::shared_ptr<const logic::Symbol> locationSymbol(std::string location, unsign
 
 std::shared_ptr<const logic::Symbol> locationSymbolForStatement(const program::Statement* statement)
 {
-    if (statement->type() == program::Statement::Type::WhileStatement)
-    {
-        return locationSymbol(statement->location, statement->enclosingLoops->size() + 1);
-    }
-    else
-    {
-        return locationSymbol(statement->location, statement->enclosingLoops->size());
-    }
+    return cachedSymbol(LocationSymbol, statement, [statement]{
+        if (statement->type() == program::Statement::Type::WhileStatement)
+        {
+            return locationSymbol(statement->location, statement->enclosingLoops->size() + 1);
+        }
+        else
+        {
+            return locationSymbol(statement->location, statement->enclosingLoops->size());
+        }
+    });
 }
 
 std::shared_ptr<const logic::Symbol> locationSymbolLeftBranch(const program::IfElse* ifElse)
 {
-    return locationSymbol(ifElse->location + "_lEnd", ifElse->enclosingLoops->size());
+    return cachedSymbol(LeftBranchSymbol, ifElse, [ifElse]{
+        return locationSymbol(ifElse->location + "_lEnd", ifElse->enclosingLoops->size());
+    });
 }
 std::shared_ptr<const logic::Symbol> locationSymbolRightBranch(const program::IfElse* ifElse)
 {
-    return locationSymbol(ifElse->location + "_rEnd", ifElse->enclosingLoops->size());
+    return cachedSymbol(RightBranchSymbol, ifElse, [ifElse]{
+        return locationSymbol(ifElse->location + "_rEnd", ifElse->enclosingLoops->size());
+    });
 }
 
 std::shared_ptr<const logic::Symbol> locationSymbolEndLocation(const program::Function* function)
 {
-    return locationSymbol(function->name + "_end", 0);
+    return cachedSymbol(EndLocationSymbol, function, [function]{
+        return locationSymbol(function->name + "_end", 0);
+    });
 }
 
 std::shared_ptr<const logic::Symbol> lastIterationSymbol(const program::WhileStatement* statement, bool twoTraces)
 {
-    std::vector<const logic::Sort*> argumentSorts;
-    for (unsigned i=0; i < statement->enclosingLoops->size(); ++i)
-    {
-        argumentSorts.push_back(logic::Sorts::natSort());
-    }
-    if (twoTraces)
-    {
-        argumentSorts.push_back(logic::Sorts::traceSort());
-    }
-    return logic::Signature::fetchOrAdd("n" + statement->location, argumentSorts, logic::Sorts::natSort());
+    return cachedSymbol(LastIterationSymbol, statement, [statement, twoTraces]{
+        std::vector<const logic::Sort*> argumentSorts;
+        for (unsigned i=0; i < statement->enclosingLoops->size(); ++i)
+        {
+            argumentSorts.push_back(logic::Sorts::natSort());
+        }
+        if (twoTraces)
+        {
+            argumentSorts.push_back(logic::Sorts::traceSort());
+        }
+        return logic::Signature::fetchOrAdd("n" + statement->location, argumentSorts, logic::Sorts::natSort());
+    });
 }
 
 std::shared_ptr<const logic::Symbol> iteratorSymbol(const program::WhileStatement* whileStatement)
@@ -85,7 +130,15 @@ void declareSymbolForProgramVar(const program::Variable* var)
         argSorts.push_back(logic::Sorts::traceSort());
     }
     
-    logic::Signature::add(var->name, argSorts, logic::Sorts::intSort());
+    auto symbol = logic::Signature::add(var->name, argSorts, logic::Sorts::intSort());
+    logic::Context::current().cacheSymbolId(var, ProgramVarSymbol, symbol->id);
+}
+
+std::shared_ptr<const logic::Symbol> programVarSymbol(const program::Variable* var)
+{
+    return cachedSymbol(ProgramVarSymbol, var, [var]{
+        return logic::Signature::fetch(var->name);
+    });
 }
 
 void declareSymbolsForTraces()
@@ -19,6 +19,9 @@ std::shared_ptr<const logic::Symbol> lastIterationSymbol(const program::WhileSta
 std::shared_ptr<const logic::Symbol> trace1Symbol();
 std::shared_ptr<const logic::Symbol> trace2Symbol();
 
+// the symbol declared for var by declareSymbolForProgramVar
+std::shared_ptr<const logic::Symbol> programVarSymbol(const program::Variable* var);
+
 /*
  * The parser needs to declare itself the symbols corresponding to variables, locations, last-loop-iterations and (if enabled) traces,
  * since later parts of the parsing (i.e. the smtlib-formula-parsing) require those declarations to exist already.
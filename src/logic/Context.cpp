@@ -0,0 +1,78 @@
+#include "Context.hpp"
+
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <utility>
+#include <cassert>
+
+namespace logic {
+
+    thread_local Context* Context::_current = nullptr;
+
+    Context::Context() : Context(nullptr)
+    {
+    }
+
+    Context::Context(std::shared_ptr<Context> base) :
+    base(std::move(base)),
+    frozen(false),
+#ifndef NDEBUG
+    handles(new char()),
+#endif
+    sorts(new Sorts::Registry(this->base.get())),
+    signature(new Signature::Registry(this->base.get())),
+    theory(new Theory::Registry(this->base.get())),
+    terms(new Terms::Registry(this->base.get())),
+    formulas(new Formulas::Registry(this->base.get())),
+    symbolIdsMutex(),
+    symbolIds()
+    {
+        // the registries only look up symbols, terms and formulas in the base itself, not in the base of the base
+        assert(this->base == nullptr || this->base->base == nullptr);
+        if (this->base != nullptr)
+        {
+            this->base->frozen.store(true, std::memory_order_relaxed);
+        }
+    }
+
+    Context::~Context()
+    {
+        // a context must not be destroyed while it is installed
+        assert(_current != this);
+
+        // the objects of the registries hold handles to each other, so all registries are destroyed before checking for handles which are still alive
+        formulas.reset();
+        terms.reset();
+        theory.reset();
+        signature.reset();
+        sorts.reset();
+#ifndef NDEBUG
+        assert(handles.use_count() == 1 && "a symbol, term or formula outlives its context");
+#endif
+    }
+
+    Context& Context::global()
+    {
+        static Context context;
+        return context;
+    }
+
+    bool Context::cachedSymbolId(const void* object, unsigned tag, unsigned& id)
+    {
+        std::shared_lock<std::shared_timed_mutex> lock(symbolIdsMutex);
+        auto it = symbolIds.find(std::make_pair(object, tag));
+        if (it == symbolIds.end())
+        {
+            return false;
+        }
+        id = it->second;
+        return true;
+    }
+
+    void Context::cacheSymbolId(const void* object, unsigned tag, unsigned id)
+    {
+        std::unique_lock<std::shared_timed_mutex> lock(symbolIdsMutex);
+        symbolIds[std::make_pair(object, tag)] = id;
+    }
+}
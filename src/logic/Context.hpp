@@ -0,0 +1,123 @@
+#ifndef __Context__
+#define __Context__
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <shared_mutex>
+#include <unordered_map>
+#include <utility>
+
+#include "Arena.hpp"
+#include "Formula.hpp"
+#include "Signature.hpp"
+#include "Sort.hpp"
+#include "Term.hpp"
+#include "Theory.hpp"
+
+namespace logic {
+
+    /*
+     * A context owns all symbols, terms and formulas of a problem, together with everything derived from them
+     * (the ids of the theory symbols, the sorts used by the problem, ...), i.e. the state behind the manager-classes
+     * Signature, Terms, Formulas, Theory and Sorts.
+     * Each thread uses the global context, unless it installs another context using a Context::Scope.
+     * This allows to encode several problems concurrently (each in its own context, on its own threads),
+     * and to free everything constructed for a problem by destroying its context.
+     * Threads which help with a problem (e.g. the workers of a util::ThreadPool) need to install the context of the problem.
+     *
+     * A context can be constructed as an overlay of a base context: everything in the base (e.g. the theory symbols and terms,
+     * cf. Theory::declareTheories) is visible in the overlay, but everything constructed in the overlay is owned by the overlay,
+     * so destroying the overlay frees the objects of a single problem while the base is kept for the next problem.
+     * Once an overlay is constructed, the base is frozen, i.e. nothing must be added to it anymore,
+     * so that any number of overlays can read it concurrently without taking locks. Overlays keep their base alive.
+     *
+     * The symbols, terms and formulas are owned by arenas of the context, and the shared_ptrs handed out for them are
+     * non-owning handles without reference counting (cf. handle), so the context must outlive all handles to its objects,
+     * including the ones stored outside of logic (e.g. in the program or the parser result).
+     * In debug builds, the handles share a reference count, and destroying a context while handles to its objects
+     * are still alive fails an assertion.
+     */
+    class Context
+    {
+    public:
+        Context();
+        // constructs an overlay of base, freezing base
+        explicit Context(std::shared_ptr<Context> base);
+        ~Context();
+        Context(const Context&) = delete;
+        Context& operator=(const Context&) = delete;
+
+        // the context of the calling thread
+        static Context& current() { return _current != nullptr ? *_current : global(); }
+
+        // installs a context for the calling thread during the lifetime of the scope
+        class Scope
+        {
+        public:
+            Scope(Context& context) : previous(_current) { _current = &context; }
+            ~Scope() { _current = previous; }
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+
+        private:
+            Context* const previous;
+        };
+
+        // ids of symbols associated with objects outside of logic (e.g. the location symbol of a program statement, cf. SymbolDeclarations),
+        // keyed by the object and a tag distinguishing the different symbols associated with the same object.
+        // can be called concurrently from several threads.
+        bool cachedSymbolId(const void* object, unsigned tag, unsigned& id);
+        void cacheSymbolId(const void* object, unsigned tag, unsigned id);
+
+        // true iff an overlay of the context was constructed, so nothing can be added to it anymore
+        bool isFrozen() const { return frozen.load(std::memory_order_relaxed); }
+
+        // returns a handle to object, which needs to be owned by the context
+        template<class T>
+        std::shared_ptr<T> handle(T* object) const
+        {
+#ifdef NDEBUG
+            return util::nonOwning(object);
+#else
+            return std::shared_ptr<T>(handles, object);
+#endif
+        }
+
+    private:
+        friend class Signature;
+        friend class Terms;
+        friend class Formulas;
+        friend class Theory;
+        friend class Sorts;
+
+        // the base of an overlay, nullptr otherwise
+        const std::shared_ptr<Context> base;
+        std::atomic<bool> frozen;
+
+#ifndef NDEBUG
+        // shares its reference count with all handles to objects of the context (cf. handle)
+        std::shared_ptr<char> handles;
+#endif
+
+        // the registries are destroyed in reverse order, so formulas are destroyed before terms, and terms before symbols
+        std::unique_ptr<Sorts::Registry> sorts;
+        std::unique_ptr<Signature::Registry> signature;
+        std::unique_ptr<Theory::Registry> theory;
+        std::unique_ptr<Terms::Registry> terms;
+        std::unique_ptr<Formulas::Registry> formulas;
+
+        struct SymbolIdKeyHash
+        {
+            size_t operator()(const std::pair<const void*, unsigned>& key) const { return std::hash<const void*>()(key.first) ^ key.second; }
+        };
+        std::shared_timed_mutex symbolIdsMutex;
+        std::unordered_map<std::pair<const void*, unsigned>, unsigned, SymbolIdKeyHash> symbolIds;
+
+        static thread_local Context* _current;
+        static Context& global();
+    };
+}
+
+#endif
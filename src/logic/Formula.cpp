@@ -2,148 +2,27 @@
 
 #include <iostream>
 #include <memory>
+#include <mutex>
+#include <new>
+#include <sstream>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "Context.hpp"
+#include "Hash.hpp"
+#include "SMTLIBWriter.hpp"
+
 namespace logic {
     
     // hack needed for bison: std::vector has no overload for ostream, but these overloads are needed for bison
     std::ostream& operator<<(std::ostream& ostr, const std::vector<std::shared_ptr<const logic::Formula>>& f){ostr << "not implemented"; return ostr;}
     
-    std::string Formula::stringForLabel(unsigned indentation) const
-    {
-        std::string str = "";
-        if (!label.empty())
-        {
-            str += std::string(indentation, ' ') + ";" + label + "\n";
-        }
-        return str;
-    }
-
-    std::string PredicateFormula::toSMTLIB(unsigned indentation) const
-    {
-        std::string str = stringForLabel(indentation);
-        str += std::string(indentation, ' ');
-        if (subterms.size() == 0)
-        {
-            str += symbol->toSMTLIB();
-        }
-        else
-        {
-            str += "(" + symbol->toSMTLIB() + " ";
-            for (unsigned i = 0; i < subterms.size(); i++)
-            {
-                str += subterms[i]->toSMTLIB();
-                str += (i == subterms.size() - 1) ? ")" : " ";
-            }
-        }
-        return str;
-    }
-
-    std::string EqualityFormula::toSMTLIB(unsigned indentation) const
-    {
-        std::string str = stringForLabel(indentation);
-        str += std::string(indentation, ' ');
-        if (polarity)
-        {
-            str += "(= " + left->toSMTLIB() + " " + right->toSMTLIB() + ")";
-        }
-        else
-        {
-            str += "(not (= " + left->toSMTLIB() + " " + right->toSMTLIB() + "))";
-        }
-        return str;
-    }
-
-    std::string ConjunctionFormula::toSMTLIB(unsigned indentation) const
-    {
-        std::string str = stringForLabel(indentation);
-        if (conj.size() == 0)
-        {
-            return str + std::string(indentation, ' ') + "true";
-        }
-        str += std::string(indentation, ' ') + "(and\n";
-        for (unsigned i = 0; i < conj.size(); i++) {
-            str += conj[i]->toSMTLIB(indentation + 3) + "\n";
-        }
-        str += std::string(indentation, ' ') + ")";
-        return str;
-    }
-    
-    std::string DisjunctionFormula::toSMTLIB(unsigned indentation) const
-    {
-        std::string str = stringForLabel(indentation);
-        if (disj.size() == 0)
-        {
-            return str + std::string(indentation, ' ') + "false";
-        }
-        str = std::string(indentation, ' ') + "(or\n";
-        for (unsigned i = 0; i < disj.size(); i++) {
-            str += disj[i]->toSMTLIB(indentation + 3) + "\n";
-        }
-        str += std::string(indentation, ' ') + ")";
-        return str;
-    }
-    
-    std::string NegationFormula::toSMTLIB(unsigned indentation) const
-    {
-        std::string str = stringForLabel(indentation);
-        str += std::string(indentation, ' ') + "(not\n";
-        str += f->toSMTLIB(indentation + 3) + "\n";
-        str += std::string(indentation, ' ') + ")";
-        return  str;
-    }
-    
-    std::string ExistentialFormula::toSMTLIB(unsigned indentation) const
-    {
-        std::string str = stringForLabel(indentation);
-        str += std::string(indentation, ' ') + "(exists ";
-        
-        //list of quantified variables
-        str += "(";
-        for (const auto& var : vars)
-        {
-            str += "(" + var->name + " " + var->rngSort->toSMTLIB() + ")";
-        }
-        str += ")\n";
-        
-        // formula
-        str += f->toSMTLIB(indentation + 3) + "\n";
-        
-        str += std::string(indentation, ' ') + ")";
-        return str;
-    }
-
-    std::string UniversalFormula::toSMTLIB(unsigned indentation) const
-    {
-        std::string str = stringForLabel(indentation);
-        str += std::string(indentation, ' ') + "(forall ";
-        
-        //list of quantified variables
-        str += "(";
-        for (const auto& var : vars)
-        {
-            str += "(" + var->name + " " + var->rngSort->toSMTLIB() + ")";
-        }
-        str += ")\n";
-        
-        // formula
-        str += f->toSMTLIB(indentation + 3) + "\n";
-        
-        str += std::string(indentation, ' ') + ")";
-        return str;
-    }
-    
-    std::string ImplicationFormula::toSMTLIB(unsigned indentation) const
+    std::string Formula::toSMTLIB(unsigned indentation) const
     {
-        std::string str = stringForLabel(indentation);
-
-        str += std::string(indentation, ' ') + "(=>\n";
-        str += f1->toSMTLIB(indentation + 3) + "\n";
-        str += f2->toSMTLIB(indentation + 3) + "\n";
-        str += std::string(indentation, ' ') + ")";
-        return  str;
+        std::ostringstream ostr;
+        SMTLIBWriter(ostr).write(*this, indentation);
+        return ostr.str();
     }
 
     std::string PredicateFormula::prettyString(unsigned indentation) const
@@ -243,45 +122,295 @@ namespace logic {
     }
     
 # pragma mark - Formulas
+    
+    Formulas::Registry& Formulas::registry()
+    {
+        return *Context::current().formulas;
+    }
+    
+    template<class F, class Predicate>
+    std::shared_ptr<const F> Formulas::fetch(size_t hash, Formula::Type type, const std::string& label, Predicate equalTo)
+    {
+        auto& context = Context::current();
+        auto& registry = *context.formulas;
+        if (registry.base != nullptr)
+        {
+            auto& baseShard = registry.base->formulas->shards[hash % numberOfShards];
+            auto range = baseShard.formulas.equal_range(hash);
+            for (auto it = range.first; it != range.second; ++it)
+            {
+                auto candidate = it->second;
+                if (candidate->type() == type && candidate->label == label && equalTo(static_cast<const F&>(*candidate)))
+                {
+                    return registry.base->handle(static_cast<const F*>(candidate));
+                }
+            }
+        }
+        
+        auto& shard = registry.shards[hash % numberOfShards];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto range = shard.formulas.equal_range(hash);
+        for (auto it = range.first; it != range.second; ++it)
+        {
+            auto candidate = it->second;
+            if (candidate->type() == type && candidate->label == label && equalTo(static_cast<const F&>(*candidate)))
+            {
+                return context.handle(static_cast<const F*>(candidate));
+            }
+        }
+        return nullptr;
+    }
+    
+    template<class F, class Construct>
+    std::shared_ptr<const F> Formulas::add(size_t hash, Construct construct)
+    {
+        auto& context = Context::current();
+        assert(!context.isFrozen());
+        auto& shard = context.formulas->shards[hash % numberOfShards];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        
+        const F* formula = shard.arena.create<F>(construct);
+        auto range = shard.formulas.equal_range(hash);
+        for (auto it = range.first; it != range.second; ++it)
+        {
+            if (isEqualNode(*it->second, *formula))
+            {
+                // we still hold the lock, so formula is the last object of the arena
+                shard.arena.destroyLast();
+                return context.handle(static_cast<const F*>(it->second));
+            }
+        }
+        shard.formulas.insert(std::make_pair(hash, formula));
+        return context.handle(formula);
+    }
+    
+    size_t Formulas::numberOfFormulas()
+    {
+        size_t numberOfFormulas = 0;
+        auto& registry = Formulas::registry();
+        for (auto& shard : registry.shards)
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            numberOfFormulas += shard.formulas.size();
+        }
+        if (registry.base != nullptr)
+        {
+            for (const auto& shard : registry.base->formulas->shards)
+            {
+                numberOfFormulas += shard.formulas.size();
+            }
+        }
+        return numberOfFormulas;
+    }
+    
+    bool Formulas::isEqualNode(const Formula& f, const Formula& g)
+    {
+        if (f.type() != g.type() || f.label != g.label)
+        {
+            return false;
+        }
+        switch (f.type())
+        {
+            case Formula::Type::Predicate:
+            {
+                auto& castedF = static_cast<const PredicateFormula&>(f);
+                auto& castedG = static_cast<const PredicateFormula&>(g);
+                return castedF.symbol == castedG.symbol && castedF.subterms == castedG.subterms;
+            }
+            case Formula::Type::Equality:
+            {
+                auto& castedF = static_cast<const EqualityFormula&>(f);
+                auto& castedG = static_cast<const EqualityFormula&>(g);
+                return castedF.polarity == castedG.polarity && castedF.left == castedG.left && castedF.right == castedG.right;
+            }
+            case Formula::Type::Conjunction:
+            {
+                return static_cast<const ConjunctionFormula&>(f).conj == static_cast<const ConjunctionFormula&>(g).conj;
+            }
+            case Formula::Type::Disjunction:
+            {
+                return static_cast<const DisjunctionFormula&>(f).disj == static_cast<const DisjunctionFormula&>(g).disj;
+            }
+            case Formula::Type::Negation:
+            {
+                return static_cast<const NegationFormula&>(f).f == static_cast<const NegationFormula&>(g).f;
+            }
+            case Formula::Type::Existential:
+            {
+                auto& castedF = static_cast<const ExistentialFormula&>(f);
+                auto& castedG = static_cast<const ExistentialFormula&>(g);
+                return castedF.vars == castedG.vars && castedF.f == castedG.f;
+            }
+            case Formula::Type::Universal:
+            {
+                auto& castedF = static_cast<const UniversalFormula&>(f);
+                auto& castedG = static_cast<const UniversalFormula&>(g);
+                return castedF.vars == castedG.vars && castedF.f == castedG.f;
+            }
+            case Formula::Type::Implication:
+            {
+                auto& castedF = static_cast<const ImplicationFormula&>(f);
+                auto& castedG = static_cast<const ImplicationFormula&>(g);
+                return castedF.f1 == castedG.f1 && castedF.f2 == castedG.f2;
+            }
+        }
+        assert(false);
+        return false;
+    }
+    
+    std::shared_ptr<const Formula> Formulas::unlabeled(const std::shared_ptr<const Formula>& f)
+    {
+        return isUnlabeled(f) ? f : f->unlabeledVersion;
+    }
+    
+    std::vector<std::shared_ptr<const Formula>> Formulas::unlabeled(const std::vector<std::shared_ptr<const Formula>>& formulas)
+    {
+        std::vector<std::shared_ptr<const Formula>> unlabeledFormulas;
+        for (const auto& f : formulas)
+        {
+            unlabeledFormulas.push_back(unlabeled(f));
+        }
+        return unlabeledFormulas;
+    }
+    
+    size_t hashForType(Formula::Type type)
+    {
+        return std::hash<int>()(static_cast<int>(type));
+    }
+    
     std::shared_ptr<const PredicateFormula> Formulas::predicate(std::string name, std::vector<std::shared_ptr<const Term>> subterms, std::string label, bool noDeclaration)
     {
-        std::vector<const Sort*> subtermSorts;
+        // only collect the argument sorts if the symbol needs to be added
+        auto symbol = Signature::tryFetch(name);
+        if (symbol == nullptr)
+        {
+            std::vector<const Sort*> subtermSorts;
+            for (const auto& subterm : subterms)
+            {
+                subtermSorts.push_back(subterm->symbol->rngSort);
+            }
+            symbol = Signature::fetchOrAdd(name, std::move(subtermSorts), Sorts::boolSort(), noDeclaration);
+        }
+        assert(symbol->isPredicateSymbol());
+        assert(symbol->noDeclaration == noDeclaration);
+        return predicate(symbol, std::move(subterms), label);
+    }
+    
+    std::shared_ptr<const PredicateFormula> Formulas::predicate(std::shared_ptr<const Symbol> symbol, std::vector<std::shared_ptr<const Term>> subterms, std::string label)
+    {
+        assert(symbol->isPredicateSymbol());
+        
+        auto hash = hashForType(Formula::Type::Predicate);
+        util::hashCombine(hash, std::hash<const Symbol*>()(symbol.get()));
         for (const auto& subterm : subterms)
         {
-            subtermSorts.push_back(subterm->symbol->rngSort);
+            util::hashCombine(hash, subterm->hash);
+        }
+        auto existing = fetch<PredicateFormula>(hash, Formula::Type::Predicate, label, [&](const PredicateFormula& f){
+            return f.symbol == symbol && f.subterms == subterms;
+        });
+        if (existing)
+        {
+            return existing;
         }
-        auto symbol = Signature::fetchOrAdd(name, subtermSorts, Sorts::boolSort(), noDeclaration);
-        return std::shared_ptr<const PredicateFormula>(new PredicateFormula(symbol, subterms, label));
+        
+        auto unlabeledVersion = label.empty() ? nullptr : predicate(symbol, subterms);
+        return add<PredicateFormula>(hash, [&](void* memory){ return new (memory) PredicateFormula(symbol, std::move(subterms), label, hash, unlabeledVersion); });
     }
 
     std::shared_ptr<const EqualityFormula> Formulas::equality(std::shared_ptr<const Term> left, std::shared_ptr<const Term> right, std::string label)
     {
-        return std::shared_ptr<const EqualityFormula>(new EqualityFormula(true, left, right, label));
+        auto hash = hashForType(Formula::Type::Equality);
+        util::hashCombine(hash, left->hash);
+        util::hashCombine(hash, right->hash);
+        auto existing = fetch<EqualityFormula>(hash, Formula::Type::Equality, label, [&](const EqualityFormula& f){
+            return f.polarity && f.left == left && f.right == right;
+        });
+        if (existing)
+        {
+            return existing;
+        }
+        
+        auto unlabeledVersion = label.empty() ? nullptr : equality(left, right);
+        return add<EqualityFormula>(hash, [&](void* memory){ return new (memory) EqualityFormula(true, left, right, label, hash, unlabeledVersion); });
     }
     
     std::shared_ptr<const NegationFormula> Formulas::disequality(std::shared_ptr<const Term> left, std::shared_ptr<const Term> right, std::string label)
     {
-        auto eq = std::shared_ptr<const EqualityFormula>(new EqualityFormula(true, left, right));
-        return std::shared_ptr<const NegationFormula>(new NegationFormula(eq, label));
+        return negation(equality(left, right), label);
     }
     
     std::shared_ptr<const NegationFormula>  Formulas::negation(std::shared_ptr<const Formula> f, std::string label)
     {
-        return std::shared_ptr<const NegationFormula>(new NegationFormula(f, label));
+        auto hash = hashForType(Formula::Type::Negation);
+        util::hashCombine(hash, f->hash);
+        auto existing = fetch<NegationFormula>(hash, Formula::Type::Negation, label, [&](const NegationFormula& g){
+            return g.f == f;
+        });
+        if (existing)
+        {
+            return existing;
+        }
+        
+        auto unlabeledVersion = (label.empty() && isUnlabeled(f)) ? nullptr : negation(unlabeled(f));
+        return add<NegationFormula>(hash, [&](void* memory){ return new (memory) NegationFormula(f, label, hash, unlabeledVersion); });
     }
     
     std::shared_ptr<const ConjunctionFormula> Formulas::conjunction(std::vector<std::shared_ptr<const Formula>> conj, std::string label)
     {
-        return std::shared_ptr<const ConjunctionFormula>(new ConjunctionFormula(conj, label));
+        auto hash = hashForType(Formula::Type::Conjunction);
+        for (const auto& f : conj)
+        {
+            util::hashCombine(hash, f->hash);
+        }
+        auto existing = fetch<ConjunctionFormula>(hash, Formula::Type::Conjunction, label, [&](const ConjunctionFormula& f){
+            return f.conj == conj;
+        });
+        if (existing)
+        {
+            return existing;
+        }
+        
+        auto unlabeledConj = unlabeled(conj);
+        auto unlabeledVersion = (label.empty() && unlabeledConj == conj) ? nullptr : conjunction(unlabeledConj);
+        return add<ConjunctionFormula>(hash, [&](void* memory){ return new (memory) ConjunctionFormula(std::move(conj), label, hash, unlabeledVersion); });
     }
+    
     std::shared_ptr<const DisjunctionFormula> Formulas::disjunction(std::vector<std::shared_ptr<const Formula>> disj, std::string label)
     {
-        return std::shared_ptr<const DisjunctionFormula>(new DisjunctionFormula(disj, label));
+        auto hash = hashForType(Formula::Type::Disjunction);
+        for (const auto& f : disj)
+        {
+            util::hashCombine(hash, f->hash);
+        }
+        auto existing = fetch<DisjunctionFormula>(hash, Formula::Type::Disjunction, label, [&](const DisjunctionFormula& f){
+            return f.disj == disj;
+        });
+        if (existing)
+        {
+            return existing;
+        }
+        
+        auto unlabeledDisj = unlabeled(disj);
+        auto unlabeledVersion = (label.empty() && unlabeledDisj == disj) ? nullptr : disjunction(unlabeledDisj);
+        return add<DisjunctionFormula>(hash, [&](void* memory){ return new (memory) DisjunctionFormula(std::move(disj), label, hash, unlabeledVersion); });
     }
     
     std::shared_ptr<const ImplicationFormula> Formulas::implication(std::shared_ptr<const Formula> f1, std::shared_ptr<const Formula> f2, std::string label)
     {
-        return std::shared_ptr<const ImplicationFormula>(new ImplicationFormula(f1, f2, label));
+        auto hash = hashForType(Formula::Type::Implication);
+        util::hashCombine(hash, f1->hash);
+        util::hashCombine(hash, f2->hash);
+        auto existing = fetch<ImplicationFormula>(hash, Formula::Type::Implication, label, [&](const ImplicationFormula& f){
+            return f.f1 == f1 && f.f2 == f2;
+        });
+        if (existing)
+        {
+            return existing;
+        }
+        
+        auto unlabeledVersion = (label.empty() && isUnlabeled(f1) && isUnlabeled(f2)) ? nullptr : implication(unlabeled(f1), unlabeled(f2));
+        return add<ImplicationFormula>(hash, [&](void* memory){ return new (memory) ImplicationFormula(f1, f2, label, hash, unlabeledVersion); });
     }
     
     std::shared_ptr<const Formula> Formulas::existential(std::vector<std::shared_ptr<const Symbol>> vars, std::shared_ptr<const Formula> f, std::string label)
@@ -290,21 +419,48 @@ namespace logic {
         {
             return f; // TODO: return copy of f which has label
         }
-        else
+        
+        auto hash = hashForType(Formula::Type::Existential);
+        for (const auto& var : vars)
+        {
+            util::hashCombine(hash, std::hash<const Symbol*>()(var.get()));
+        }
+        util::hashCombine(hash, f->hash);
+        auto existing = fetch<ExistentialFormula>(hash, Formula::Type::Existential, label, [&](const ExistentialFormula& g){
+            return g.vars == vars && g.f == f;
+        });
+        if (existing)
         {
-            return std::shared_ptr<const ExistentialFormula>(new ExistentialFormula(std::move(vars), f, label));
+            return existing;
         }
+        
+        auto unlabeledVersion = (label.empty() && isUnlabeled(f)) ? nullptr : existential(vars, unlabeled(f));
+        return add<ExistentialFormula>(hash, [&](void* memory){ return new (memory) ExistentialFormula(std::move(vars), f, label, hash, unlabeledVersion); });
     }
+    
     std::shared_ptr<const Formula> Formulas::universal(std::vector<std::shared_ptr<const Symbol>> vars, std::shared_ptr<const Formula> f, std::string label)
     {
         if (vars.empty())
         {
             return f; // TODO: return copy of f which has label
         }
-        else
+        
+        auto hash = hashForType(Formula::Type::Universal);
+        for (const auto& var : vars)
         {
-            return std::shared_ptr<const UniversalFormula>(new UniversalFormula(std::move(vars), f, label));
+            util::hashCombine(hash, std::hash<const Symbol*>()(var.get()));
         }
+        util::hashCombine(hash, f->hash);
+        auto existing = fetch<UniversalFormula>(hash, Formula::Type::Universal, label, [&](const UniversalFormula& g){
+            return g.vars == vars && g.f == f;
+        });
+        if (existing)
+        {
+            return existing;
+        }
+        
+        auto unlabeledVersion = (label.empty() && isUnlabeled(f)) ? nullptr : universal(vars, unlabeled(f));
+        return add<UniversalFormula>(hash, [&](void* memory){ return new (memory) UniversalFormula(std::move(vars), f, label, hash, unlabeledVersion); });
     }
 }
 
@@ -1,168 +1,187 @@
 #ifndef __Formula__
 #define __Formula__
 
+#include <array>
 #include <iostream>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 #include <cassert>
 
+#include "Arena.hpp"
 #include "Term.hpp"
 
 namespace logic {
     
     class Formula
     {
+        friend class Formulas;
+        
     public:
-        Formula(std::string label) : label(label) {}
+        Formula(std::string label, size_t hash, std::shared_ptr<const Formula> unlabeledVersion) : label(label), hash(hash), unlabeledVersion(unlabeledVersion) {}
         virtual ~Formula() {}
         const std::string label;
         
+        // structural hash, computed once at construction. The hash ignores labels.
+        const size_t hash;
+        
+        enum class Type { Predicate, Equality, Conjunction, Disjunction, Negation, Existential, Universal, Implication };
+        virtual Type type() const = 0;
+        
+        // formulas are hash-consed by the Formulas-class, so two formulas are structurally equal (including labels) iff they are the same object.
+        // unlabeled() returns the formula which is structurally equal to this formula, but contains no labels (neither at the top level nor in any subformula).
+        // In particular, two formulas are structurally equal modulo labels iff their unlabeled formulas are the same object.
+        const Formula* unlabeled() const { return unlabeledVersion ? unlabeledVersion.get() : this; }
+        
         std::string declareSMTLIB(std::string decl, bool conjecture = false) const;
         
-        virtual std::string toSMTLIB(unsigned indentation = 0) const = 0;
+        // convenience method, use SMTLIBWriter to write the formula directly into an ostream
+        std::string toSMTLIB(unsigned indentation = 0) const;
         virtual std::string prettyString(unsigned indentation = 0) const = 0;
         
-    protected:
-        std::string stringForLabel(unsigned indentation) const;
+    private:
+        // nullptr iff the formula contains no labels, i.e. iff the formula is its own unlabeled version
+        const std::shared_ptr<const Formula> unlabeledVersion;
     };
     
     // hack needed for bison: std::vector has no overload for ostream, but these overloads are needed for bison
     std::ostream& operator<<(std::ostream& ostr, const std::vector<std::shared_ptr<const logic::Formula>>& f);
     
-    class PredicateFormula : public Formula
+    class PredicateFormula : public Formula, private CountedNode<PredicateFormula, NodeKind::PredicateFormula>
     {
         friend class Formulas;
         
-    public:
-        PredicateFormula(std::shared_ptr<const Symbol> symbol, std::vector<std::shared_ptr<const Term>> subterms, std::string label = "") : Formula(label), symbol(symbol), subterms(subterms)
+        PredicateFormula(std::shared_ptr<const Symbol> symbol, std::vector<std::shared_ptr<const Term>> subterms, std::string label, size_t hash, std::shared_ptr<const Formula> unlabeledVersion) : Formula(label, hash, unlabeledVersion), symbol(symbol), subterms(std::move(subterms))
         {
-            assert(symbol->argSorts.size() == subterms.size());
-            for (int i=0; i < symbol->argSorts.size(); ++i)
+            assert(this->symbol->argSorts.size() == this->subterms.size());
+            for (int i=0; i < this->symbol->argSorts.size(); ++i)
             {
-                assert(symbol->argSorts[i] == this->subterms[i]->symbol->rngSort);
+                assert(this->symbol->argSorts[i] == this->subterms[i]->symbol->rngSort);
             }
         }
-
+        
+    public:
         std::shared_ptr<const Symbol> symbol;
         const std::vector<std::shared_ptr<const Term>> subterms;
 
-        std::string toSMTLIB(unsigned indentation = 0) const override;
+        Type type() const override { return Type::Predicate; }
         std::string prettyString(unsigned indentation = 0) const override;
     };
     
-    class EqualityFormula : public Formula
+    class EqualityFormula : public Formula, private CountedNode<EqualityFormula, NodeKind::EqualityFormula>
     {
         friend class Formulas;
         
-    public:
         // TODO: refactor polarity into explicit negation everywhere
-        EqualityFormula(bool polarity, std::shared_ptr<const Term> left, std::shared_ptr<const Term> right, std::string label = "")
-        : Formula(label), polarity(polarity), left(left), right(right) {}
-
+        EqualityFormula(bool polarity, std::shared_ptr<const Term> left, std::shared_ptr<const Term> right, std::string label, size_t hash, std::shared_ptr<const Formula> unlabeledVersion)
+        : Formula(label, hash, unlabeledVersion), polarity(polarity), left(left), right(right) {}
+        
+    public:
         const bool polarity;
         const std::shared_ptr<const Term> left;
         const std::shared_ptr<const Term> right;
         
-        std::string toSMTLIB(unsigned indentation = 0) const override;
+        Type type() const override { return Type::Equality; }
         std::string prettyString(unsigned indentation = 0) const override;
     };
     
-    class ConjunctionFormula : public Formula
+    class ConjunctionFormula : public Formula, private CountedNode<ConjunctionFormula, NodeKind::ConjunctionFormula>
     {
         friend class Formulas;
         
-    public:
-        ConjunctionFormula(std::vector<std::shared_ptr<const Formula>> conj, std::string label = "") : Formula(label), conj(conj) {}
+        ConjunctionFormula(std::vector<std::shared_ptr<const Formula>> conj, std::string label, size_t hash, std::shared_ptr<const Formula> unlabeledVersion) : Formula(label, hash, unlabeledVersion), conj(std::move(conj)) {}
         
+    public:
         const std::vector<std::shared_ptr<const Formula>> conj;
 
-        std::string toSMTLIB(unsigned indentation = 0) const override;
+        Type type() const override { return Type::Conjunction; }
         std::string prettyString(unsigned indentation = 0) const override;
     };
     
-    class DisjunctionFormula : public Formula
+    class DisjunctionFormula : public Formula, private CountedNode<DisjunctionFormula, NodeKind::DisjunctionFormula>
     {
         friend class Formulas;
         
-    public:
-        DisjunctionFormula(std::vector<std::shared_ptr<const Formula>> disj, std::string label = "") : Formula(label), disj(disj){}
+        DisjunctionFormula(std::vector<std::shared_ptr<const Formula>> disj, std::string label, size_t hash, std::shared_ptr<const Formula> unlabeledVersion) : Formula(label, hash, unlabeledVersion), disj(std::move(disj)){}
         
+    public:
         const std::vector<std::shared_ptr<const Formula>> disj;
 
-        std::string toSMTLIB(unsigned indentation = 0) const override;
+        Type type() const override { return Type::Disjunction; }
         std::string prettyString(unsigned indentation = 0) const override;
     };
     
-    class NegationFormula : public Formula
+    class NegationFormula : public Formula, private CountedNode<NegationFormula, NodeKind::NegationFormula>
     {
         friend class Formulas;
         
-    public:
-        NegationFormula(std::shared_ptr<const Formula> f, std::string label = "") : Formula(label), f(f) {}
+        NegationFormula(std::shared_ptr<const Formula> f, std::string label, size_t hash, std::shared_ptr<const Formula> unlabeledVersion) : Formula(label, hash, unlabeledVersion), f(f) {}
         
+    public:
         const std::shared_ptr<const Formula> f;
 
-        std::string toSMTLIB(unsigned indentation = 0) const override;
+        Type type() const override { return Type::Negation; }
         std::string prettyString(unsigned indentation = 0) const override;
         
     };
     
-    class ExistentialFormula : public Formula
+    class ExistentialFormula : public Formula, private CountedNode<ExistentialFormula, NodeKind::ExistentialFormula>
     {
         friend class Formulas;
         
-    public:
-        ExistentialFormula(std::vector<std::shared_ptr<const Symbol>> vars, std::shared_ptr<const Formula> f, std::string label = "")
-        : Formula(label), vars(std::move(vars)), f(f)
+        ExistentialFormula(std::vector<std::shared_ptr<const Symbol>> vars, std::shared_ptr<const Formula> f, std::string label, size_t hash, std::shared_ptr<const Formula> unlabeledVersion)
+        : Formula(label, hash, unlabeledVersion), vars(std::move(vars)), f(f)
         {
-            for (const auto& var : vars)
+            for (const auto& var : this->vars)
             {
                 assert(var->argSorts.empty());
             }
         }
         
+    public:
         const std::vector<std::shared_ptr<const Symbol>> vars;
         const std::shared_ptr<const Formula> f;
         
-        std::string toSMTLIB(unsigned indentation = 0) const override;
+        Type type() const override { return Type::Existential; }
         std::string prettyString(unsigned indentation = 0) const override;
     };
     
-    class UniversalFormula : public Formula
+    class UniversalFormula : public Formula, private CountedNode<UniversalFormula, NodeKind::UniversalFormula>
     {
         friend class Formulas;
         
-    public:
-        UniversalFormula(std::vector<std::shared_ptr<const Symbol>> vars, std::shared_ptr<const Formula> f, std::string label = "")
-        : Formula(label), vars(std::move(vars)), f(f)
+        UniversalFormula(std::vector<std::shared_ptr<const Symbol>> vars, std::shared_ptr<const Formula> f, std::string label, size_t hash, std::shared_ptr<const Formula> unlabeledVersion)
+        : Formula(label, hash, unlabeledVersion), vars(std::move(vars)), f(f)
         {
-            for (const auto& var : vars)
+            for (const auto& var : this->vars)
             {
                 assert(var->argSorts.empty());
             }
         }
-
+        
+    public:
         const std::vector<std::shared_ptr<const Symbol>> vars;
         const std::shared_ptr<const Formula> f;
         
-        std::string toSMTLIB(unsigned indentation = 0) const override;
+        Type type() const override { return Type::Universal; }
         std::string prettyString(unsigned indentation = 0) const override;
     };
     
-    class ImplicationFormula : public Formula
+    class ImplicationFormula : public Formula, private CountedNode<ImplicationFormula, NodeKind::ImplicationFormula>
     {
         friend class Formulas;
         
-    public:
-        ImplicationFormula(std::shared_ptr<const Formula> f1, std::shared_ptr<const Formula> f2, std::string label = "")
-        : Formula(label), f1(f1), f2(f2) {}
+        ImplicationFormula(std::shared_ptr<const Formula> f1, std::shared_ptr<const Formula> f2, std::string label, size_t hash, std::shared_ptr<const Formula> unlabeledVersion)
+        : Formula(label, hash, unlabeledVersion), f1(f1), f2(f2) {}
         
+    public:
         const std::shared_ptr<const Formula> f1;
         const std::shared_ptr<const Formula> f2;
         
-        std::string toSMTLIB(unsigned indentation = 0) const override;
+        Type type() const override { return Type::Implication; }
         std::string prettyString(unsigned indentation = 0) const override;
     };
     
@@ -170,13 +189,20 @@ namespace logic {
     
 # pragma mark - Formulas
     
-    // We use Formulas as a manager-class for Formula-instances
+    // We use Formulas as a manager-class for Formula-instances.
+    // Formulas are hash-consed: constructing a formula which is structurally equal (including labels) to an existing formula
+    // returns the existing formula, so all structurally equal formulas share a single node.
+    // Formulas can be constructed concurrently from several threads: the formula bank is split into shards (selected by the hash of the formula),
+    // each guarded by its own lock.
+    // The formulas are owned by the arenas of the shards and live as long as the logic::Context they were constructed in,
+    // the returned shared_ptrs are non-owning handles without reference counting (cf. logic::Context::handle).
     class Formulas
     {
     public:
         
-        // construct new terms
+        // construct new formulas (or fetch the existing structurally equal formula)
         static std::shared_ptr<const PredicateFormula> predicate(std::string name, std::vector<std::shared_ptr<const Term>> subterms, std::string label = "", bool noDeclaration=false);
+        static std::shared_ptr<const PredicateFormula> predicate(std::shared_ptr<const Symbol> symbol, std::vector<std::shared_ptr<const Term>> subterms, std::string label = "");
         
         static std::shared_ptr<const EqualityFormula> equality(std::shared_ptr<const Term> left, std::shared_ptr<const Term> right, std::string label = "");
         static std::shared_ptr<const NegationFormula> disequality(std::shared_ptr<const Term> left, std::shared_ptr<const Term> right, std::string label = "");
@@ -190,6 +216,49 @@ namespace logic {
         
         static std::shared_ptr<const Formula> existential(std::vector<std::shared_ptr<const Symbol>> vars, std::shared_ptr<const Formula> f, std::string label = "");
         static std::shared_ptr<const Formula> universal(std::vector<std::shared_ptr<const Symbol>> vars, std::shared_ptr<const Formula> f, std::string label = "");
+        
+        // the number of formulas constructed so far (including the formulas of the base of an overlay, cf. logic::Context)
+        static size_t numberOfFormulas();
+        
+    private:
+        friend class Context;
+        
+
+        // the formula bank: all formulas constructed so far, bucketed by their hash.
+        // candidates are compared on type, label and (pointers to) their direct children, which is sufficient since the children are already hash-consed.
+        struct Shard
+        {
+            std::mutex mutex;
+            util::Arena arena;
+            std::unordered_multimap<size_t, const Formula*> formulas;
+        };
+        static const size_t numberOfShards = 64;
+        // the formula bank is owned by a registry, and each logic::Context owns its own registry.
+        // all methods operate on the registry of the context of the calling thread.
+        // the registry of an overlay (cf. logic::Context) first looks for formulas in its base, which is read without locking (since it is frozen).
+        struct Registry
+        {
+            Registry(const Context* base) : base(base), shards() {}
+            
+            const Context* const base;
+            std::array<Shard, numberOfShards> shards;
+        };
+        static Registry& registry();
+        
+        // returns the formula in the bank with given hash, type and label, for which equalTo holds, or nullptr if there is no such formula
+        template<class F, class Predicate>
+        static std::shared_ptr<const F> fetch(size_t hash, Formula::Type type, const std::string& label, Predicate equalTo);
+        // constructs the formula with the given hash in the arena of its shard (by calling construct(memory), cf. util::Arena::create), adds it to the bank and returns it.
+        // If another thread added an equal formula since the last fetch, the new formula is destroyed again and the existing formula is returned instead.
+        template<class F, class Construct>
+        static std::shared_ptr<const F> add(size_t hash, Construct construct);
+        // true iff f and g have the same type, label and (pointers to) direct children
+        static bool isEqualNode(const Formula& f, const Formula& g);
+        
+        // helpers for computing the unlabeled version of a formula from the unlabeled versions of its children
+        static std::shared_ptr<const Formula> unlabeled(const std::shared_ptr<const Formula>& f);
+        static std::vector<std::shared_ptr<const Formula>> unlabeled(const std::vector<std::shared_ptr<const Formula>>& formulas);
+        static bool isUnlabeled(const std::shared_ptr<const Formula>& f) { return f->unlabeledVersion == nullptr; }
     };
 }
 
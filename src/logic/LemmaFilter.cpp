@@ -0,0 +1,399 @@
+#include "LemmaFilter.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include <cassert>
+
+namespace logic {
+
+    const size_t LemmaFilter::noOwner = std::numeric_limits<size_t>::max();
+
+    void LemmaFilter::filter(Problem& problem)
+    {
+        auto& lemmas = problem.lemmas;
+        std::vector<bool> removed(lemmas.size(), false);
+
+        // remove duplicates, keeping the first occurrence
+        std::unordered_set<std::string> occurring;
+        for (size_t i = 0; i < lemmas.size(); ++i)
+        {
+            if (!occurring.insert(canonicalString(*lemmas[i])).second)
+            {
+                removed[i] = true;
+                numberOfDuplicates++;
+            }
+        }
+
+        // collect the units asserted by axioms and remaining lemmas
+        for (const auto& axiom : problem.axioms)
+        {
+            addUnits(*axiom, {}, noOwner);
+        }
+        for (size_t i = 0; i < lemmas.size(); ++i)
+        {
+            if (!removed[i])
+            {
+                addUnits(*lemmas[i], {}, i);
+            }
+        }
+
+        // remove subsumed lemmas. Lemmas are checked in order, and removed lemmas can't be used to subsume other lemmas,
+        // so from two lemmas subsuming each other, the first one is removed and the second one is kept.
+        for (size_t i = 0; i < lemmas.size(); ++i)
+        {
+            if (!removed[i] && isSubsumed(*lemmas[i], i, removed))
+            {
+                removed[i] = true;
+                numberOfSubsumed++;
+            }
+        }
+
+        std::vector<std::shared_ptr<const Formula>> remainingLemmas;
+        std::vector<std::string> remainingLemmaFamilies;
+        for (size_t i = 0; i < lemmas.size(); ++i)
+        {
+            if (!removed[i])
+            {
+                remainingLemmas.push_back(lemmas[i]);
+                if (!problem.lemmaFamilies.empty())
+                {
+                    remainingLemmaFamilies.push_back(problem.lemmaFamilies[i]);
+                }
+            }
+        }
+        lemmas = std::move(remainingLemmas);
+        problem.lemmaFamilies = std::move(remainingLemmaFamilies);
+    }
+
+# pragma mark - Subsumption
+
+    // collects the units of f, i.e. the atoms which are (possibly universally quantified) conjuncts of f
+    void LemmaFilter::addUnits(const Formula& f, std::vector<const Symbol*> vars, size_t owner)
+    {
+        auto& body = stripUniversals(f, &vars);
+        if (body.type() == Formula::Type::Conjunction)
+        {
+            for (const auto& conjunct : static_cast<const ConjunctionFormula&>(body).conj)
+            {
+                addUnits(*conjunct, vars, owner);
+            }
+        }
+        else if (isAtom(body))
+        {
+            units[keyOf(body)].push_back(Unit{&body, vars, owner});
+        }
+    }
+
+    // a lemma forall x. (P => C) or forall x. C is subsumed if each atom of the conclusion C is an instance of a unit
+    bool LemmaFilter::isSubsumed(const Formula& lemma, size_t index, const std::vector<bool>& removed)
+    {
+        auto* conclusion = &stripUniversals(lemma);
+        if (conclusion->type() == Formula::Type::Implication)
+        {
+            conclusion = &stripUniversals(*static_cast<const ImplicationFormula&>(*conclusion).f2);
+        }
+
+        std::vector<const Formula*> atoms = {conclusion};
+        for (size_t i = 0; i < atoms.size(); ++i)
+        {
+            auto& atom = stripUniversals(*atoms[i]);
+            if (atom.type() == Formula::Type::Conjunction)
+            {
+                for (const auto& conjunct : static_cast<const ConjunctionFormula&>(atom).conj)
+                {
+                    atoms.push_back(conjunct.get());
+                }
+            }
+            else if (!isAtom(atom) || !isInstance(atom, index, removed))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool LemmaFilter::isInstance(const Formula& atom, size_t index, const std::vector<bool>& removed)
+    {
+        auto it = units.find(keyOf(atom));
+        if (it == units.end())
+        {
+            return false;
+        }
+        for (const auto& unit : it->second)
+        {
+            if (unit.owner != noOwner && (unit.owner == index || removed[unit.owner]))
+            {
+                continue;
+            }
+            std::unordered_map<const Symbol*, const Term*> substitution;
+            if (match(*unit.atom, atom, unit.vars, substitution))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    const Formula& LemmaFilter::stripUniversals(const Formula& f, std::vector<const Symbol*>* vars)
+    {
+        auto* current = &f;
+        while (current->type() == Formula::Type::Universal)
+        {
+            auto& castedFormula = static_cast<const UniversalFormula&>(*current);
+            if (vars != nullptr)
+            {
+                for (const auto& var : castedFormula.vars)
+                {
+                    vars->push_back(var.get());
+                }
+            }
+            current = castedFormula.f.get();
+        }
+        return *current;
+    }
+
+    bool LemmaFilter::isAtom(const Formula& f)
+    {
+        if (f.type() == Formula::Type::Negation)
+        {
+            auto& negatedFormula = *static_cast<const NegationFormula&>(f).f;
+            return negatedFormula.type() == Formula::Type::Predicate || negatedFormula.type() == Formula::Type::Equality;
+        }
+        return f.type() == Formula::Type::Predicate || f.type() == Formula::Type::Equality;
+    }
+
+    // atoms can only be instances of each other if they agree on their key, which is the predicate symbol for predicates.
+    // since equalities are matched modulo symmetry, all equalities share the key nullptr.
+    const Symbol* LemmaFilter::keyOf(const Formula& atom)
+    {
+        auto& positiveAtom = (atom.type() == Formula::Type::Negation) ? *static_cast<const NegationFormula&>(atom).f : atom;
+        if (positiveAtom.type() == Formula::Type::Predicate)
+        {
+            return static_cast<const PredicateFormula&>(positiveAtom).symbol.get();
+        }
+        assert(positiveAtom.type() == Formula::Type::Equality);
+        return nullptr;
+    }
+
+    bool LemmaFilter::match(const Formula& pattern, const Formula& target, const std::vector<const Symbol*>& vars, std::unordered_map<const Symbol*, const Term*>& substitution)
+    {
+        if (pattern.type() != target.type())
+        {
+            return false;
+        }
+        switch (pattern.type())
+        {
+            case Formula::Type::Negation:
+            {
+                return match(*static_cast<const NegationFormula&>(pattern).f, *static_cast<const NegationFormula&>(target).f, vars, substitution);
+            }
+            case Formula::Type::Predicate:
+            {
+                auto& castedPattern = static_cast<const PredicateFormula&>(pattern);
+                auto& castedTarget = static_cast<const PredicateFormula&>(target);
+                if (castedPattern.symbol != castedTarget.symbol)
+                {
+                    return false;
+                }
+                for (size_t i = 0; i < castedPattern.subterms.size(); ++i)
+                {
+                    if (!match(*castedPattern.subterms[i], *castedTarget.subterms[i], vars, substitution))
+                    {
+                        return false;
+                    }
+                }
+                return true;
+            }
+            case Formula::Type::Equality:
+            {
+                auto& castedPattern = static_cast<const EqualityFormula&>(pattern);
+                auto& castedTarget = static_cast<const EqualityFormula&>(target);
+                if (castedPattern.polarity != castedTarget.polarity)
+                {
+                    return false;
+                }
+                auto substitutionCopy = substitution;
+                if (match(*castedPattern.left, *castedTarget.left, vars, substitution) &&
+                    match(*castedPattern.right, *castedTarget.right, vars, substitution))
+                {
+                    return true;
+                }
+                // equality is symmetric
+                substitution = std::move(substitutionCopy);
+                return match(*castedPattern.left, *castedTarget.right, vars, substitution) &&
+                       match(*castedPattern.right, *castedTarget.left, vars, substitution);
+            }
+            default:
+            {
+                return false;
+            }
+        }
+    }
+
+    bool LemmaFilter::match(const Term& pattern, const Term& target, const std::vector<const Symbol*>& vars, std::unordered_map<const Symbol*, const Term*>& substitution)
+    {
+        // variables of parsed formulas are represented as constants without declaration
+        bool isNullary = (pattern.type() == Term::Type::Variable) || static_cast<const FuncTerm&>(pattern).subterms.empty();
+        if (isNullary && std::find(vars.begin(), vars.end(), pattern.symbol.get()) != vars.end())
+        {
+            if (pattern.symbol->rngSort != target.symbol->rngSort)
+            {
+                return false;
+            }
+            auto pair = substitution.insert(std::make_pair(pattern.symbol.get(), &target));
+            return pair.second || pair.first->second == &target;
+        }
+
+        if (pattern.type() != Term::Type::FuncTerm || target.type() != Term::Type::FuncTerm || pattern.symbol != target.symbol)
+        {
+            return false;
+        }
+        auto& patternSubterms = static_cast<const FuncTerm&>(pattern).subterms;
+        auto& targetSubterms = static_cast<const FuncTerm&>(target).subterms;
+        for (size_t i = 0; i < patternSubterms.size(); ++i)
+        {
+            if (!match(*patternSubterms[i], *targetSubterms[i], vars, substitution))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+# pragma mark - Alpha-equivalence
+
+    std::string LemmaFilter::canonicalString(const Formula& f)
+    {
+        std::unordered_map<const Symbol*, unsigned> boundVars;
+        std::string out;
+        writeCanonical(f, boundVars, 0, out);
+        return out;
+    }
+
+    // bound variables are replaced by their de-Bruijn-level, i.e. by the number of variables bound before them
+    void LemmaFilter::writeCanonical(const Formula& f, std::unordered_map<const Symbol*, unsigned>& boundVars, unsigned depth, std::string& out)
+    {
+        switch (f.type())
+        {
+            case Formula::Type::Predicate:
+            {
+                auto& castedFormula = static_cast<const PredicateFormula&>(f);
+                out += '(';
+                out += castedFormula.symbol->name;
+                for (const auto& subterm : castedFormula.subterms)
+                {
+                    out += ' ';
+                    writeCanonical(*subterm, boundVars, out);
+                }
+                out += ')';
+                break;
+            }
+            case Formula::Type::Equality:
+            {
+                auto& castedFormula = static_cast<const EqualityFormula&>(f);
+                out += castedFormula.polarity ? "(= " : "(!= ";
+                writeCanonical(*castedFormula.left, boundVars, out);
+                out += ' ';
+                writeCanonical(*castedFormula.right, boundVars, out);
+                out += ')';
+                break;
+            }
+            case Formula::Type::Conjunction:
+            case Formula::Type::Disjunction:
+            {
+                bool isConjunction = f.type() == Formula::Type::Conjunction;
+                auto& subformulas = isConjunction ? static_cast<const ConjunctionFormula&>(f).conj : static_cast<const DisjunctionFormula&>(f).disj;
+                out += isConjunction ? "(and" : "(or";
+                for (const auto& subformula : subformulas)
+                {
+                    out += ' ';
+                    writeCanonical(*subformula, boundVars, depth, out);
+                }
+                out += ')';
+                break;
+            }
+            case Formula::Type::Negation:
+            {
+                out += "(not ";
+                writeCanonical(*static_cast<const NegationFormula&>(f).f, boundVars, depth, out);
+                out += ')';
+                break;
+            }
+            case Formula::Type::Existential:
+            case Formula::Type::Universal:
+            {
+                bool isUniversal = f.type() == Formula::Type::Universal;
+                auto& vars = isUniversal ? static_cast<const UniversalFormula&>(f).vars : static_cast<const ExistentialFormula&>(f).vars;
+                auto& body = isUniversal ? *static_cast<const UniversalFormula&>(f).f : *static_cast<const ExistentialFormula&>(f).f;
+
+                // bind the variables, remembering shadowed bindings
+                std::vector<std::pair<const Symbol*, unsigned>> shadowed;
+                out += isUniversal ? "(forall (" : "(exists (";
+                for (const auto& var : vars)
+                {
+                    auto it = boundVars.find(var.get());
+                    if (it != boundVars.end())
+                    {
+                        shadowed.push_back(*it);
+                    }
+                    boundVars[var.get()] = depth;
+                    out += var->rngSort->name;
+                    out += ' ';
+                    depth++;
+                }
+                out += ") ";
+                writeCanonical(body, boundVars, depth, out);
+                out += ')';
+
+                for (const auto& var : vars)
+                {
+                    boundVars.erase(var.get());
+                }
+                boundVars.insert(shadowed.begin(), shadowed.end());
+                break;
+            }
+            case Formula::Type::Implication:
+            {
+                auto& castedFormula = static_cast<const ImplicationFormula&>(f);
+                out += "(=> ";
+                writeCanonical(*castedFormula.f1, boundVars, depth, out);
+                out += ' ';
+                writeCanonical(*castedFormula.f2, boundVars, depth, out);
+                out += ')';
+                break;
+            }
+        }
+    }
+
+    void LemmaFilter::writeCanonical(const Term& t, const std::unordered_map<const Symbol*, unsigned>& boundVars, std::string& out)
+    {
+        auto it = boundVars.find(t.symbol.get());
+        if (it != boundVars.end())
+        {
+            out += '#';
+            out += std::to_string(it->second);
+            return;
+        }
+
+        if (t.type() == Term::Type::Variable || static_cast<const FuncTerm&>(t).subterms.empty())
+        {
+            out += t.symbol->name;
+            return;
+        }
+        auto& subterms = static_cast<const FuncTerm&>(t).subterms;
+        out += '(';
+        out += t.symbol->name;
+        for (const auto& subterm : subterms)
+        {
+            out += ' ';
+            writeCanonical(*subterm, boundVars, out);
+        }
+        out += ')';
+    }
+}
@@ -0,0 +1,65 @@
+#ifndef __LemmaFilter__
+#define __LemmaFilter__
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Formula.hpp"
+#include "Problem.hpp"
+#include "Term.hpp"
+
+namespace logic {
+
+    /*
+     * Removes redundant lemmas from a problem:
+     * - duplicates: lemmas which are equal to a previous lemma up to renaming of bound variables (and labels)
+     * - subsumed lemmas: lemmas of the form forall x. (P => C) or forall x. C, where each atom of the conclusion C
+     *   is an instance of an unconditional atom asserted by an axiom or by another (remaining) lemma,
+     *   e.g. the induction lemma for a variable which the static analysis already asserts to be constant in the loop.
+     * Instances are computed by matching (modulo symmetry of equality), so the check is cheap but incomplete.
+     */
+    class LemmaFilter
+    {
+    public:
+        LemmaFilter() : numberOfDuplicates(0), numberOfSubsumed(0), units() {}
+
+        void filter(Problem& problem);
+
+        unsigned numberOfDuplicates;
+        unsigned numberOfSubsumed;
+
+    private:
+        // an atom (equality, predicate or their negation) which is asserted for all values of vars
+        struct Unit
+        {
+            const Formula* atom;
+            std::vector<const Symbol*> vars;
+            size_t owner; // index of the lemma asserting the unit, or noOwner for axioms
+        };
+        static const size_t noOwner;
+
+        // units, bucketed by the symbol of the atom (cf. keyOf)
+        std::unordered_map<const Symbol*, std::vector<Unit>> units;
+
+        void addUnits(const Formula& f, std::vector<const Symbol*> vars, size_t owner);
+        bool isSubsumed(const Formula& lemma, size_t index, const std::vector<bool>& removed);
+        bool isInstance(const Formula& atom, size_t index, const std::vector<bool>& removed);
+
+        static const Formula& stripUniversals(const Formula& f, std::vector<const Symbol*>* vars = nullptr);
+        static bool isAtom(const Formula& f);
+        static const Symbol* keyOf(const Formula& atom);
+
+        static bool match(const Formula& pattern, const Formula& target, const std::vector<const Symbol*>& vars, std::unordered_map<const Symbol*, const Term*>& substitution);
+        static bool match(const Term& pattern, const Term& target, const std::vector<const Symbol*>& vars, std::unordered_map<const Symbol*, const Term*>& substitution);
+
+        // representation of f which is invariant under renaming of bound variables and ignores labels
+        static std::string canonicalString(const Formula& f);
+        static void writeCanonical(const Formula& f, std::unordered_map<const Symbol*, unsigned>& boundVars, unsigned depth, std::string& out);
+        static void writeCanonical(const Term& t, const std::unordered_map<const Symbol*, unsigned>& boundVars, std::string& out);
+    };
+}
+
+#endif
@@ -0,0 +1,89 @@
+#include "NodeStatistics.hpp"
+
+#include <array>
+#include <atomic>
+#include <iomanip>
+#include <iostream>
+
+namespace logic {
+
+    std::array<NodeStatistics::Counters, NodeStatistics::numberOfKinds> NodeStatistics::counters;
+
+    void NodeStatistics::allocated(NodeKind kind, size_t bytes)
+    {
+        auto& counter = counters[static_cast<size_t>(kind)];
+        counter.total++;
+
+        // raise the peaks to the new live values, unless another thread already raised them further
+        auto live = ++counter.live;
+        auto peak = counter.peak.load();
+        while (peak < live && !counter.peak.compare_exchange_weak(peak, live)) {}
+
+        auto liveBytes = counter.liveBytes += bytes;
+        auto peakBytes = counter.peakBytes.load();
+        while (peakBytes < liveBytes && !counter.peakBytes.compare_exchange_weak(peakBytes, liveBytes)) {}
+    }
+
+    void NodeStatistics::freed(NodeKind kind, size_t bytes)
+    {
+        auto& counter = counters[static_cast<size_t>(kind)];
+        counter.live--;
+        counter.liveBytes -= bytes;
+    }
+
+    const char* NodeStatistics::nameOf(NodeKind kind)
+    {
+        switch (kind)
+        {
+            case NodeKind::Symbol:
+                return "Symbol";
+            case NodeKind::LVariable:
+                return "LVariable";
+            case NodeKind::FuncTerm:
+                return "FuncTerm";
+            case NodeKind::PredicateFormula:
+                return "PredicateFormula";
+            case NodeKind::EqualityFormula:
+                return "EqualityFormula";
+            case NodeKind::ConjunctionFormula:
+                return "ConjunctionFormula";
+            case NodeKind::DisjunctionFormula:
+                return "DisjunctionFormula";
+            case NodeKind::NegationFormula:
+                return "NegationFormula";
+            case NodeKind::ExistentialFormula:
+                return "ExistentialFormula";
+            case NodeKind::UniversalFormula:
+                return "UniversalFormula";
+            case NodeKind::ImplicationFormula:
+                return "ImplicationFormula";
+        }
+        return "";
+    }
+
+    void NodeStatistics::output(std::ostream& ostr)
+    {
+        ostr << "Node statistics:\n";
+        ostr << "  " << std::left << std::setw(20) << "kind" << std::right
+             << std::setw(10) << "total" << std::setw(10) << "live" << std::setw(10) << "peak"
+             << std::setw(14) << "live bytes" << std::setw(14) << "peak bytes" << "\n";
+
+        // the sum of the peaks of the kinds is an upper bound for the overall peak, since the kinds may peak at different times
+        size_t total = 0, live = 0, peak = 0, liveBytes = 0, peakBytes = 0;
+        for (size_t i = 0; i < numberOfKinds; ++i)
+        {
+            const auto& counter = counters[i];
+            ostr << "  " << std::left << std::setw(20) << nameOf(static_cast<NodeKind>(i)) << std::right
+                 << std::setw(10) << counter.total << std::setw(10) << counter.live << std::setw(10) << counter.peak
+                 << std::setw(14) << counter.liveBytes << std::setw(14) << counter.peakBytes << "\n";
+            total += counter.total;
+            live += counter.live;
+            peak += counter.peak;
+            liveBytes += counter.liveBytes;
+            peakBytes += counter.peakBytes;
+        }
+        ostr << "  " << std::left << std::setw(20) << "all" << std::right
+             << std::setw(10) << total << std::setw(10) << live << std::setw(10) << peak
+             << std::setw(14) << liveBytes << std::setw(14) << peakBytes << "\n";
+    }
+}
@@ -0,0 +1,79 @@
+#ifndef __NodeStatistics__
+#define __NodeStatistics__
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <iostream>
+
+namespace logic {
+
+    enum class NodeKind
+    {
+        Symbol,
+        LVariable,
+        FuncTerm,
+        PredicateFormula,
+        EqualityFormula,
+        ConjunctionFormula,
+        DisjunctionFormula,
+        NegationFormula,
+        ExistentialFormula,
+        UniversalFormula,
+        ImplicationFormula
+    };
+
+    /*
+     * Counts the live and peak number of objects and bytes for each kind of node (symbols, terms and formulas).
+     * The counters are only compiled in if SPECTRE_NODE_STATISTICS is defined (cmake -DSPECTRE_NODE_STATISTICS=ON),
+     * otherwise CountedNode is empty and the nodes have neither space nor time overhead.
+     * The nodes are owned by the arenas of their logic::Context, and the handles to them (cf. util::nonOwning) have no control block,
+     * so the bytes of a node are the size of the node object in its arena. Not included are the padding and the unused
+     * space of the arena blocks, and the out-of-line storage of vectors and strings owned by the node.
+     * A node is freed when its context is destroyed, or right away if it turns out to be equal to an existing formula (cf. Formulas::add).
+     */
+    class NodeStatistics
+    {
+    public:
+        static void allocated(NodeKind kind, size_t bytes);
+        static void freed(NodeKind kind, size_t bytes);
+
+        // writes a table with the counters of all kinds (and their sums) into ostr
+        static void output(std::ostream& ostr);
+
+        // the number of objects of kind which are alive, which were alive at the same time at most, and which were ever allocated
+        static size_t live(NodeKind kind) { return counters[static_cast<size_t>(kind)].live; }
+        static size_t peak(NodeKind kind) { return counters[static_cast<size_t>(kind)].peak; }
+        static size_t total(NodeKind kind) { return counters[static_cast<size_t>(kind)].total; }
+
+    private:
+        struct Counters
+        {
+            std::atomic<size_t> live{0};
+            std::atomic<size_t> peak{0};
+            std::atomic<size_t> total{0};
+            std::atomic<size_t> liveBytes{0};
+            std::atomic<size_t> peakBytes{0};
+        };
+        static const size_t numberOfKinds = static_cast<size_t>(NodeKind::ImplicationFormula) + 1;
+        static std::array<Counters, numberOfKinds> counters;
+        static const char* nameOf(NodeKind kind);
+    };
+
+    // a node class Node of kind K derives privately from CountedNode<Node, K> to be counted
+#ifdef SPECTRE_NODE_STATISTICS
+    template<class Node, NodeKind kind>
+    class CountedNode
+    {
+    protected:
+        CountedNode() { NodeStatistics::allocated(kind, sizeof(Node)); }
+        CountedNode(const CountedNode&) { NodeStatistics::allocated(kind, sizeof(Node)); }
+        ~CountedNode() { NodeStatistics::freed(kind, sizeof(Node)); }
+    };
+#else
+    template<class Node, NodeKind kind>
+    class CountedNode {};
+#endif
+}
+
+#endif
@@ -1,42 +1,155 @@
 #include "Problem.hpp"
 
+#include <algorithm>
+#include <functional>
 #include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
 #include <cassert>
 
+#include "Context.hpp"
+#include "Options.hpp"
 #include "Output.hpp"
+#include "SMTLIBWriter.hpp"
+#include "Statistics.hpp"
 
 namespace logic {
     
     void Problem::outputSMTLIB(std::ostream& ostr)
-    {        
-        // output sort declarations
-        for(const auto& pair : Sorts::nameToSort())
+    {
+        util::ThreadPool threadPool(1);
+        outputSMTLIB(ostr, threadPool);
+    }
+    
+    void Problem::outputSMTLIB(std::ostream& ostr, util::ThreadPool& threadPool)
+    {
+        const auto& configuration = util::Configuration::instance();
+        auto sharing = configuration.sharing().getValue();
+        outputSMTLIB(ostr,
+                     threadPool,
+                     sharing == "let" ? SMTLIBWriter::Sharing::Let :
+                     sharing == "define-fun" ? SMTLIBWriter::Sharing::DefineFun :
+                     SMTLIBWriter::Sharing::None,
+                     configuration.compact().getValue(),
+                     configuration.labels().getValue());
+    }
+    
+    void Problem::outputSMTLIB(std::ostream& ostr, util::ThreadPool& threadPool, SMTLIBWriter::Sharing sharing, bool compact, bool labels, bool withConjecture)
+    {
+        std::unique_ptr<Context::Scope> scope(context != nullptr ? new Context::Scope(*context) : nullptr);
+        
+        if (!prefix.empty())
         {
-            ostr << declareSortSMTLIB(*pair.second);
+            // the definitions of define-fun depend on the conjecture, so they can't be part of a prefix
+            assert(sharing != SMTLIBWriter::Sharing::DefineFun);
+            ostr << prefix;
         }
+        else
+        {
+            if (!comments.empty())
+            {
+                ostr << util::Output::comment << comments << util::Output::nocomment;
+            }
+            
+            // output sort declarations
+            for(const auto& sort : Sorts::nameToSort())
+            {
+                ostr << declareSortSMTLIB(*sort);
+            }
+            
+            // output symbol definitions
+            for (const auto& symbol : Signature::signature())
+            {
+                ostr << symbol->declareSymbolSMTLIB();
+            }
+        }
+        
+        SMTLIBWriter writer(ostr, sharing, compact, labels);
         
-        // output symbol definitions
-        for (const auto& pairStringSymbol : Signature::signature())
+        // output definitions of subterms shared over the whole problem
+        if (sharing == SMTLIBWriter::Sharing::DefineFun)
         {
-            ostr << pairStringSymbol.second->declareSymbolSMTLIB();
+            std::vector<std::shared_ptr<const Formula>> formulas(axioms);
+            formulas.insert(formulas.end(), lemmas.begin(), lemmas.end());
+            assert(conjecture != nullptr);
+            formulas.push_back(conjecture);
+            writer.writeDefinitions(formulas);
         }
         
-        // output each axiom
-        for (const auto& axiom : axioms)
+        // collect the assertions: each axiom, each lemma (unless they are part of the prefix) and the conjecture
+        std::vector<std::pair<std::string, const Formula*>> assertions;
+        if (prefix.empty())
         {
-            ostr << "\n(assert\n" << axiom->toSMTLIB(3) + "\n)\n";
+            for (const auto& axiom : axioms)
+            {
+                assertions.push_back(std::make_pair("assert", axiom.get()));
+            }
+            for (const auto& lemma : lemmas)
+            {
+                // TODO: improve handling for lemmas:
+                // custom smtlib-extension
+                assertions.push_back(std::make_pair("assert", lemma.get()));
+            }
         }
-
-        // output each lemma
-        for (const auto& lemma : lemmas)
+        if (withConjecture)
+        {
+            assert(conjecture != nullptr);
+            assertions.push_back(std::make_pair("assert-not", conjecture.get()));
+        }
+        
+        // with statistics, the assertions are buffered even on a single thread, so that their sizes can be reported
+        if (threadPool.numberOfThreads() == 1 && !util::Statistics::enabled())
+        {
+            for (const auto& assertion : assertions)
+            {
+                writer.writeAssertion(assertion.first, *assertion.second);
+            }
+            return;
+        }
+        
+        // format each assertion into its own buffer. The assertions are split into contiguous chunks,
+        // and each chunk uses a separate writer which shares the definitions of writer.
+        // there are more chunks than threads, so that threads which finish early can steal chunks.
+        std::vector<std::string> buffers(assertions.size());
+        auto numberOfChunks = std::min(assertions.size(), static_cast<size_t>(8 * threadPool.numberOfThreads()));
+        auto& context = Context::current();
+        std::vector<std::function<void()>> tasks;
+        for (size_t chunk = 0; chunk < numberOfChunks; ++chunk)
         {
-            // TODO: improve handling for lemmas:
-            // custom smtlib-extension
-            ostr << "\n(assert\n" << lemma->toSMTLIB(3) + "\n)\n";
+            auto begin = chunk * assertions.size() / numberOfChunks;
+            auto end = (chunk + 1) * assertions.size() / numberOfChunks;
+            tasks.push_back([&, begin, end]{
+                Context::Scope scope(context);
+                std::ostringstream buffer;
+                SMTLIBWriter chunkWriter(buffer, writer);
+                for (auto i = begin; i < end; ++i)
+                {
+                    buffer.str("");
+                    chunkWriter.writeAssertion(assertions[i].first, *assertions[i].second);
+                    buffers[i] = buffer.str();
+                }
+            });
         }
+        threadPool.run(std::move(tasks));
         
-        // output conjecture
-        assert(conjecture != nullptr);
-        ostr << "\n(assert-not\n" << conjecture->toSMTLIB(3) + "\n)\n";
+        size_t numberOfBytes = 0;
+        for (const auto& buffer : buffers)
+        {
+            ostr << buffer;
+            numberOfBytes += buffer.size();
+        }
+        
+        if (util::Statistics::enabled())
+        {
+            util::Statistics::setCounter("assertionBytes", numberOfBytes);
+            // the lemmas are the assertions after the axioms
+            for (size_t i = 0; prefix.empty() && i < lemmaFamilies.size(); ++i)
+            {
+                util::Statistics::addLemmaFamily(lemmaFamilies[i], 1, buffers[axioms.size() + i].size());
+            }
+        }
     }
 }
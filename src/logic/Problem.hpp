@@ -3,9 +3,13 @@
 
 #include <iostream>
 #include <memory>
+#include <string>
 #include <vector>
 
+#include "Context.hpp"
 #include "Formula.hpp"
+#include "SMTLIBWriter.hpp"
+#include "ThreadPool.hpp"
 
 namespace logic {
     
@@ -14,14 +18,37 @@ namespace logic {
     class Problem
     {
     public:
-        Problem() : axioms(), conjecture(nullptr), lemmas() {}
+        Problem() : context(nullptr), comments(), prefix(), axioms(), conjecture(nullptr), lemmas(), lemmaFamilies() {}
+        
+        // the context containing the symbols, terms and formulas of the problem, if the problem owns it (cf. spectre::Encoder).
+        // otherwise the problem lives in the context of the calling thread.
+        // declared first, so that the formulas are released before the context is destroyed.
+        std::unique_ptr<Context> context;
+        
+        // written as smtlib-comments at the start of the output (e.g. the program the problem was generated from)
+        std::string comments;
+        
+        // if not empty, the output of everything except the conjecture (comments, declarations, axioms and lemmas),
+        // which is written instead of comments, axioms and lemmas (e.g. taken from a cache, cf. spectre::Encoder)
+        std::string prefix;
         
         std::vector<std::shared_ptr<const Formula>> axioms;
         std::shared_ptr<const Formula> conjecture;
         
         std::vector<std::shared_ptr<const Formula>> lemmas;
+        // the name of the family of each lemma, which is only used for statistics (cf. util::Statistics).
+        // either empty or of the same size as lemmas.
+        std::vector<std::string> lemmaFamilies;
         
+        // the output is canonical: the sorts and the symbols are declared in the order of their names, followed by the axioms, the lemmas and the conjecture
+        // in the order of the problem. In particular, it doesn't depend on the number of threads or on the addresses of the symbols, terms and formulas.
         void outputSMTLIB(std::ostream& ostr);
+        // if threadPool has more than one thread, each assertion is formatted into its own buffer on threadPool,
+        // and the buffers are written to ostr in the original order afterwards
+        // the sharing, compact and labels options are taken from util::Configuration
+        void outputSMTLIB(std::ostream& ostr, util::ThreadPool& threadPool);
+        // without the conjecture, the output is the prefix of the problem
+        void outputSMTLIB(std::ostream& ostr, util::ThreadPool& threadPool, SMTLIBWriter::Sharing sharing, bool compact, bool labels, bool withConjecture = true);
     };
 }
 #endif
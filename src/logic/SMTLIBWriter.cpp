@@ -0,0 +1,619 @@
+#include "SMTLIBWriter.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include <cassert>
+
+namespace logic {
+
+    void SMTLIBWriter::write(const Term& term)
+    {
+        if (!names.empty())
+        {
+            auto it = names.find(&term);
+            if (it != names.end())
+            {
+                ostr << it->second;
+                return;
+            }
+        }
+
+        if (term.type() == Term::Type::Variable)
+        {
+            ostr << term.symbol->name;
+        }
+        else
+        {
+            assert(term.type() == Term::Type::FuncTerm);
+            auto& castedTerm = static_cast<const FuncTerm&>(term);
+            writeApplication(*castedTerm.symbol, castedTerm.subterms);
+        }
+    }
+
+    void SMTLIBWriter::write(const Formula& formula, unsigned indentation)
+    {
+        if (sharing == Sharing::None)
+        {
+            writeFormula(formula, indentation);
+            return;
+        }
+
+        // determine the let-bindings of all scopes of the formula
+        scopes.clear();
+        scopes.emplace_back(nullptr);
+        openScopes = {0};
+        collectOccurrences(formula);
+        unsigned letCounter = 0;
+        for (auto& scope : scopes)
+        {
+            computeBindings(scope, "Let", letCounter);
+        }
+
+        nextScope = 0;
+        writeScope(formula, indentation);
+        assert(nextScope == scopes.size());
+        scopes.clear();
+    }
+
+    void SMTLIBWriter::writeDefinitions(const std::vector<std::shared_ptr<const Formula>>& formulas)
+    {
+        if (sharing != Sharing::DefineFun)
+        {
+            return;
+        }
+
+        // count the occurrences of ground subterms over all formulas, using a single top-level scope
+        scopes.clear();
+        scopes.emplace_back(nullptr);
+        for (const auto& formula : formulas)
+        {
+            openScopes = {0};
+            collectOccurrences(*formula);
+        }
+        auto& globalScope = scopes[0];
+        computeBindings(globalScope, "Def", definitionCounter);
+
+        // define-funs are sequential, so writing the levels in order ensures that each definition only uses previous ones
+        for (const auto& level : globalScope.bindings)
+        {
+            for (const auto& binding : level)
+            {
+                auto& term = static_cast<const FuncTerm&>(*binding.first);
+                ostr << "(define-fun " << binding.second << " () " << term.symbol->rngSort->toSMTLIB() << ' ';
+                writeApplication(*term.symbol, term.subterms);
+                ostr << ")\n";
+                names[binding.first] = binding.second;
+            }
+        }
+        scopes.clear();
+    }
+
+    void SMTLIBWriter::writeAssertion(const std::string& command, const Formula& formula)
+    {
+        if (compact)
+        {
+            ostr << '(' << command << ' ';
+            write(formula);
+            ostr << ")\n";
+        }
+        else
+        {
+            ostr << "\n(" << command << "\n";
+            write(formula, 3);
+            ostr << "\n)\n";
+        }
+    }
+
+# pragma mark - Collecting shared subterms
+
+    void SMTLIBWriter::collectOccurrences(const Formula& formula)
+    {
+        switch (formula.type())
+        {
+            case Formula::Type::Predicate:
+            {
+                for (const auto& subterm : static_cast<const PredicateFormula&>(formula).subterms)
+                {
+                    collectOccurrences(*subterm);
+                }
+                break;
+            }
+            case Formula::Type::Equality:
+            {
+                auto& castedFormula = static_cast<const EqualityFormula&>(formula);
+                collectOccurrences(*castedFormula.left);
+                collectOccurrences(*castedFormula.right);
+                break;
+            }
+            case Formula::Type::Conjunction:
+            {
+                for (const auto& conjunct : static_cast<const ConjunctionFormula&>(formula).conj)
+                {
+                    collectOccurrences(*conjunct);
+                }
+                break;
+            }
+            case Formula::Type::Disjunction:
+            {
+                for (const auto& disjunct : static_cast<const DisjunctionFormula&>(formula).disj)
+                {
+                    collectOccurrences(*disjunct);
+                }
+                break;
+            }
+            case Formula::Type::Negation:
+            {
+                collectOccurrences(*static_cast<const NegationFormula&>(formula).f);
+                break;
+            }
+            case Formula::Type::Existential:
+            case Formula::Type::Universal:
+            {
+                auto& vars = formula.type() == Formula::Type::Existential ? static_cast<const ExistentialFormula&>(formula).vars
+                                                                          : static_cast<const UniversalFormula&>(formula).vars;
+                auto& body = formula.type() == Formula::Type::Existential ? *static_cast<const ExistentialFormula&>(formula).f
+                                                                          : *static_cast<const UniversalFormula&>(formula).f;
+                openScopes.push_back(scopes.size());
+                scopes.emplace_back(&vars);
+                collectOccurrences(body);
+                openScopes.pop_back();
+                break;
+            }
+            case Formula::Type::Implication:
+            {
+                auto& castedFormula = static_cast<const ImplicationFormula&>(formula);
+                collectOccurrences(*castedFormula.f1);
+                collectOccurrences(*castedFormula.f2);
+                break;
+            }
+        }
+    }
+
+    void SMTLIBWriter::collectOccurrences(const Term& term)
+    {
+        // variables and constants are never bound
+        if (term.type() == Term::Type::Variable || static_cast<const FuncTerm&>(term).subterms.empty())
+        {
+            return;
+        }
+        // ground subterms which are shared over the whole problem are already defined by define-funs
+        if (names.count(&term) > 0)
+        {
+            return;
+        }
+
+        auto& scope = scopes[scopeOf(term)];
+        if (scope.occurrences[&term]++ == 0)
+        {
+            // first occurrence: the subterms of all further occurrences are shared with this one, so only count them once
+            scope.terms.push_back(&term);
+            for (const auto& subterm : static_cast<const FuncTerm&>(term).subterms)
+            {
+                collectOccurrences(*subterm);
+            }
+        }
+    }
+
+    const std::vector<const Symbol*>& SMTLIBWriter::variableSymbolsOf(const Term& term)
+    {
+        auto it = variableSymbols.find(&term);
+        if (it != variableSymbols.end())
+        {
+            return it->second;
+        }
+
+        std::vector<const Symbol*> symbols;
+        if (term.type() == Term::Type::Variable)
+        {
+            symbols.push_back(term.symbol.get());
+        }
+        else
+        {
+            auto& subterms = static_cast<const FuncTerm&>(term).subterms;
+            if (subterms.empty())
+            {
+                // variables bound by quantifiers of parsed formulas are represented as constants without declaration
+                if (term.symbol->noDeclaration)
+                {
+                    symbols.push_back(term.symbol.get());
+                }
+            }
+            else
+            {
+                for (const auto& subterm : subterms)
+                {
+                    for (const auto symbol : variableSymbolsOf(*subterm))
+                    {
+                        if (std::find(symbols.begin(), symbols.end(), symbol) == symbols.end())
+                        {
+                            symbols.push_back(symbol);
+                        }
+                    }
+                }
+            }
+        }
+        return variableSymbols.emplace(&term, std::move(symbols)).first->second;
+    }
+
+    // returns the innermost open scope binding one of the variables of term
+    unsigned SMTLIBWriter::scopeOf(const Term& term)
+    {
+        auto& symbols = variableSymbolsOf(term);
+        for (unsigned i = openScopes.size() - 1; i > 0; --i)
+        {
+            for (const auto& var : *scopes[openScopes[i]].vars)
+            {
+                if (std::find(symbols.begin(), symbols.end(), var.get()) != symbols.end())
+                {
+                    return openScopes[i];
+                }
+            }
+        }
+        return openScopes[0];
+    }
+
+    void SMTLIBWriter::computeBindings(Scope& scope, const std::string& prefix, unsigned& counter)
+    {
+        // only bind a term if this shrinks the output, i.e. if the saved occurrences are larger than the binding itself
+        std::unordered_set<const Term*> bound;
+        for (const auto term : scope.terms)
+        {
+            auto occurrences = scope.occurrences[term];
+            auto nameSize = prefix.size() + std::to_string(counter + bound.size()).size() + 3;
+            if (occurrences > 1 && (occurrences - 1) * writtenSize(*term) > (occurrences + 1) * nameSize + 3)
+            {
+                bound.insert(term);
+            }
+        }
+
+        std::unordered_map<const Term*, unsigned> levels;
+        for (const auto term : scope.terms)
+        {
+            if (bound.count(term) > 0)
+            {
+                auto level = bindingLevel(scope, *term, bound, levels);
+                if (scope.bindings.size() <= level)
+                {
+                    scope.bindings.resize(level + 1);
+                }
+                scope.bindings[level].push_back(std::make_pair(term, std::string()));
+            }
+        }
+        for (auto& level : scope.bindings)
+        {
+            for (auto& binding : level)
+            {
+                binding.second = "|" + prefix + "#" + std::to_string(counter++) + "|";
+            }
+        }
+    }
+
+    // the number of characters needed to write term in full
+    size_t SMTLIBWriter::writtenSize(const Term& term)
+    {
+        auto it = writtenSizes.find(&term);
+        if (it != writtenSizes.end())
+        {
+            return it->second;
+        }
+
+        size_t size = term.symbol->toSMTLIB().size();
+        if (term.type() == Term::Type::FuncTerm)
+        {
+            auto& subterms = static_cast<const FuncTerm&>(term).subterms;
+            if (!subterms.empty())
+            {
+                size += 2;
+                for (const auto& subterm : subterms)
+                {
+                    size += 1 + writtenSize(*subterm);
+                }
+            }
+        }
+        writtenSizes[&term] = size;
+        return size;
+    }
+
+    // the level of a bound term is one more than the maximal level of the bound terms of the same scope it contains.
+    // terms with level 0 only use bindings of enclosing scopes.
+    unsigned SMTLIBWriter::bindingLevel(const Scope& scope, const Term& term, const std::unordered_set<const Term*>& bound, std::unordered_map<const Term*, unsigned>& levels)
+    {
+        auto it = levels.find(&term);
+        if (it != levels.end())
+        {
+            return it->second;
+        }
+
+        unsigned level = 0;
+        for (const auto& subterm : static_cast<const FuncTerm&>(term).subterms)
+        {
+            // subterms which are not counted in this scope belong to an enclosing scope
+            if (scope.occurrences.count(subterm.get()) > 0)
+            {
+                auto subtermLevel = bindingLevel(scope, *subterm, bound, levels);
+                level = std::max(level, bound.count(subterm.get()) > 0 ? subtermLevel + 1 : subtermLevel);
+            }
+        }
+        levels[&term] = level;
+        return level;
+    }
+
+# pragma mark - Writing
+
+    // writes formula, wrapped into the let-bindings of the next scope
+    void SMTLIBWriter::writeScope(const Formula& formula, unsigned indentation)
+    {
+        auto& scope = scopes[nextScope++];
+        if (scope.bindings.empty())
+        {
+            writeFormula(formula, indentation);
+            return;
+        }
+
+        // a subterm can already be bound by an enclosing scope if a quantifier shadows one of its variables
+        std::vector<std::pair<const Term*, std::string>> shadowed;
+        for (const auto& level : scope.bindings)
+        {
+            writeIndentation(indentation);
+            ostr << "(let (";
+            for (unsigned i = 0; i < level.size(); ++i)
+            {
+                auto& term = static_cast<const FuncTerm&>(*level[i].first);
+                ostr << (i == 0 ? "(" : " (") << level[i].second << ' ';
+                writeApplication(*term.symbol, term.subterms);
+                ostr << ')';
+            }
+            ostr << ')';
+            writeSeparator();
+
+            // the bindings of a let are parallel, so they are only visible after the whole level
+            for (const auto& binding : level)
+            {
+                auto it = names.find(binding.first);
+                if (it != names.end())
+                {
+                    shadowed.push_back(*it);
+                    it->second = binding.second;
+                }
+                else
+                {
+                    names.insert(binding);
+                }
+            }
+        }
+
+        // the body is not indented any further, so that the bindings don't increase the size of the remaining output
+        writeFormula(formula, indentation);
+        if (!compact)
+        {
+            ostr << '\n';
+            writeIndentation(indentation);
+        }
+        ostr << std::string(scope.bindings.size(), ')');
+
+        for (const auto& level : scope.bindings)
+        {
+            for (const auto& binding : level)
+            {
+                names.erase(binding.first);
+            }
+        }
+        names.insert(shadowed.begin(), shadowed.end());
+    }
+
+    void SMTLIBWriter::writeFormula(const Formula& formula, unsigned indentation)
+    {
+        writeLabel(formula, indentation);
+        writeIndentation(indentation);
+
+        switch (formula.type())
+        {
+            case Formula::Type::Predicate:
+            {
+                auto& castedFormula = static_cast<const PredicateFormula&>(formula);
+                writeApplication(*castedFormula.symbol, castedFormula.subterms);
+                break;
+            }
+            case Formula::Type::Equality:
+            {
+                auto& castedFormula = static_cast<const EqualityFormula&>(formula);
+                ostr << (castedFormula.polarity ? "(= " : "(not (= ");
+                write(*castedFormula.left);
+                ostr << ' ';
+                write(*castedFormula.right);
+                ostr << (castedFormula.polarity ? ")" : "))");
+                break;
+            }
+            case Formula::Type::Conjunction:
+            {
+                auto& castedFormula = static_cast<const ConjunctionFormula&>(formula);
+                if (castedFormula.conj.size() == 0)
+                {
+                    ostr << "true";
+                }
+                else
+                {
+                    ostr << "(and";
+                    writeLineBreak();
+                    for (const auto& conjunct : castedFormula.conj)
+                    {
+                        writeSubformula(*conjunct, indentation);
+                    }
+                    writeClosingParenthesis(indentation);
+                }
+                break;
+            }
+            case Formula::Type::Disjunction:
+            {
+                auto& castedFormula = static_cast<const DisjunctionFormula&>(formula);
+                if (castedFormula.disj.size() == 0)
+                {
+                    ostr << "false";
+                }
+                else
+                {
+                    ostr << "(or";
+                    writeLineBreak();
+                    for (const auto& disjunct : castedFormula.disj)
+                    {
+                        writeSubformula(*disjunct, indentation);
+                    }
+                    writeClosingParenthesis(indentation);
+                }
+                break;
+            }
+            case Formula::Type::Negation:
+            {
+                auto& castedFormula = static_cast<const NegationFormula&>(formula);
+                ostr << "(not";
+                writeLineBreak();
+                writeSubformula(*castedFormula.f, indentation);
+                writeClosingParenthesis(indentation);
+                break;
+            }
+            case Formula::Type::Existential:
+            {
+                auto& castedFormula = static_cast<const ExistentialFormula&>(formula);
+                ostr << "(exists ";
+                writeQuantifiedVars(castedFormula.vars);
+                writeQuantifiedBody(*castedFormula.f, indentation);
+                writeClosingParenthesis(indentation);
+                break;
+            }
+            case Formula::Type::Universal:
+            {
+                auto& castedFormula = static_cast<const UniversalFormula&>(formula);
+                ostr << "(forall ";
+                writeQuantifiedVars(castedFormula.vars);
+                writeQuantifiedBody(*castedFormula.f, indentation);
+                writeClosingParenthesis(indentation);
+                break;
+            }
+            case Formula::Type::Implication:
+            {
+                auto& castedFormula = static_cast<const ImplicationFormula&>(formula);
+                ostr << "(=>";
+                writeLineBreak();
+                writeSubformula(*castedFormula.f1, indentation);
+                writeSubformula(*castedFormula.f2, indentation);
+                writeClosingParenthesis(indentation);
+                break;
+            }
+        }
+    }
+
+    void SMTLIBWriter::writeIndentation(unsigned indentation)
+    {
+        if (compact)
+        {
+            return;
+        }
+        static const char spaces[] = "                                ";
+        const unsigned chunkSize = sizeof(spaces) - 1;
+        while (indentation > 0)
+        {
+            auto n = std::min(indentation, chunkSize);
+            ostr.write(spaces, n);
+            indentation -= n;
+        }
+    }
+
+    void SMTLIBWriter::writeLabel(const Formula& formula, unsigned indentation)
+    {
+        // labels are written as comments, so even in compact mode they need to be terminated by a line break
+        if (labels && !formula.label.empty())
+        {
+            writeIndentation(indentation);
+            ostr << ';' << formula.label << '\n';
+        }
+    }
+
+    void SMTLIBWriter::writeApplication(const Symbol& symbol, const std::vector<std::shared_ptr<const Term>>& subterms)
+    {
+        if (subterms.size() == 0)
+        {
+            ostr << symbol.toSMTLIB();
+        }
+        else
+        {
+            ostr << '(' << symbol.toSMTLIB();
+            for (const auto& subterm : subterms)
+            {
+                ostr << ' ';
+                write(*subterm);
+            }
+            ostr << ')';
+        }
+    }
+
+    void SMTLIBWriter::writeQuantifiedVars(const std::vector<std::shared_ptr<const Symbol>>& vars)
+    {
+        ostr << '(';
+        for (const auto& var : vars)
+        {
+            ostr << '(' << var->name << ' ' << var->rngSort->toSMTLIB() << ')';
+        }
+        ostr << ')';
+        writeLineBreak();
+    }
+
+    // subformulas are written on their own line, with increased indentation
+    // (or separated by a single space in compact mode)
+    void SMTLIBWriter::writeSubformula(const Formula& subformula, unsigned indentation)
+    {
+        if (compact)
+        {
+            ostr << ' ';
+            writeFormula(subformula, indentation);
+        }
+        else
+        {
+            writeFormula(subformula, indentation + 3);
+            ostr << '\n';
+        }
+    }
+    
+    // the body of a quantifier opens a new scope, so it can start with let-bindings
+    void SMTLIBWriter::writeQuantifiedBody(const Formula& body, unsigned indentation)
+    {
+        if (scopes.empty())
+        {
+            writeSubformula(body, indentation);
+        }
+        else if (compact)
+        {
+            ostr << ' ';
+            writeScope(body, indentation);
+        }
+        else
+        {
+            writeScope(body, indentation + 3);
+            ostr << '\n';
+        }
+    }
+
+    void SMTLIBWriter::writeLineBreak()
+    {
+        if (!compact)
+        {
+            ostr << '\n';
+        }
+    }
+
+    void SMTLIBWriter::writeSeparator()
+    {
+        ostr << (compact ? ' ' : '\n');
+    }
+
+    void SMTLIBWriter::writeClosingParenthesis(unsigned indentation)
+    {
+        writeIndentation(indentation);
+        ostr << ')';
+    }
+}
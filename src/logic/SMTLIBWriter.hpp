@@ -0,0 +1,118 @@
+#ifndef __SMTLIBWriter__
+#define __SMTLIBWriter__
+
+#include <iostream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "Term.hpp"
+#include "Formula.hpp"
+
+namespace logic {
+
+    /*
+     * Writes the smtlib-representation of terms and formulas directly into an ostream.
+     * In contrast to Term::toSMTLIB() and Formula::toSMTLIB(), no intermediate strings are built,
+     * so the cost of writing a formula is linear in the size of its output.
+     */
+    class SMTLIBWriter
+    {
+    public:
+        /*
+         * Determines how subterms which occur more than once are written:
+         * - None: each occurrence is written in full
+         * - Let: each non-constant subterm occurring more than once in a formula is bound by a let,
+         *   which is placed directly inside the innermost quantifier binding one of the variables of the subterm
+         *   (or at the top of the formula, if the subterm contains no bound variables)
+         * - DefineFun: same as Let, but each ground subterm occurring more than once in the whole problem
+         *   is introduced by a top-level define-fun instead (cf. writeDefinitions)
+         * Since terms are hash-consed, occurrences of the same subterm are detected by pointer-comparison.
+         * The bound subterms are named by quoted symbols containing a #, e.g. |Let#0| or |Def#0|,
+         * which can't clash with symbols of the signature or variables, since their names never contain a #.
+         */
+        enum class Sharing { None, Let, DefineFun };
+
+        // in compact mode, formulas are written without indentation and line breaks (except after labels).
+        // if labels is false, the labels of formulas are not written.
+        SMTLIBWriter(std::ostream& ostr, Sharing sharing = Sharing::None, bool compact = false, bool labels = true) :
+        ostr(ostr), sharing(sharing), compact(compact), labels(labels) {}
+
+        // constructs a writer into ostr with the same settings and the same top-level definitions as other (cf. writeDefinitions),
+        // so that the assertions of a problem can be written independently (e.g. concurrently) into separate streams
+        SMTLIBWriter(std::ostream& ostr, const SMTLIBWriter& other) :
+        ostr(ostr), sharing(other.sharing), compact(other.compact), labels(other.labels), names(other.names), definitionCounter(other.definitionCounter) {}
+
+        void write(const Term& term);
+        void write(const Formula& formula, unsigned indentation = 0);
+
+        // writes the command (e.g. assert) applied to formula
+        void writeAssertion(const std::string& command, const Formula& formula);
+
+        // for Sharing::DefineFun, writes a define-fun for each ground subterm occurring more than once in formulas.
+        // needs to be called before any of the formulas is written. Does nothing for the other modes.
+        void writeDefinitions(const std::vector<std::shared_ptr<const Formula>>& formulas);
+
+    private:
+        std::ostream& ostr;
+        const Sharing sharing;
+        const bool compact;
+        const bool labels;
+
+        // names of the subterms which are currently bound (by a let or a define-fun)
+        std::unordered_map<const Term*, std::string> names;
+        unsigned definitionCounter = 0;
+
+        // a scope in which let-bindings can be placed, i.e. either the top level of a formula or the body of a quantifier.
+        // scopes are numbered in the order in which they are entered while writing the formula.
+        struct Scope
+        {
+            Scope(const std::vector<std::shared_ptr<const Symbol>>* vars) : vars(vars), terms(), occurrences(), bindings() {}
+
+            const std::vector<std::shared_ptr<const Symbol>>* vars; // nullptr for the top level
+
+            // the subterms whose innermost bound variable is bound by this scope, in order of their first occurrence,
+            // and their number of occurrences in the term-DAG (occurrences inside a repeated subterm are only counted once)
+            std::vector<const Term*> terms;
+            std::unordered_map<const Term*, unsigned> occurrences;
+
+            // the let-bindings of the scope, grouped into levels such that each binding only uses bindings of lower levels
+            std::vector<std::vector<std::pair<const Term*, std::string>>> bindings;
+        };
+        std::vector<Scope> scopes;
+        std::vector<unsigned> openScopes;
+        unsigned nextScope = 0;
+
+        // for each term, the variable-symbols occurring in it and the size of its smtlib-representation
+        // (cached, since terms are shared between formulas)
+        std::unordered_map<const Term*, std::vector<const Symbol*>> variableSymbols;
+        std::unordered_map<const Term*, size_t> writtenSizes;
+
+        void collectOccurrences(const Formula& formula);
+        void collectOccurrences(const Term& term);
+        const std::vector<const Symbol*>& variableSymbolsOf(const Term& term);
+        unsigned scopeOf(const Term& term);
+        // names the bindings prefix#counter, prefix#counter+1, ... (as quoted symbols, cf. Sharing)
+        void computeBindings(Scope& scope, const std::string& prefix, unsigned& counter);
+        size_t writtenSize(const Term& term);
+        unsigned bindingLevel(const Scope& scope, const Term& term, const std::unordered_set<const Term*>& bound, std::unordered_map<const Term*, unsigned>& levels);
+
+        void writeFormula(const Formula& formula, unsigned indentation);
+        void writeScope(const Formula& formula, unsigned indentation);
+
+        void writeIndentation(unsigned indentation);
+        void writeLabel(const Formula& formula, unsigned indentation);
+        void writeApplication(const Symbol& symbol, const std::vector<std::shared_ptr<const Term>>& subterms);
+        void writeQuantifiedVars(const std::vector<std::shared_ptr<const Symbol>>& vars);
+        void writeSubformula(const Formula& subformula, unsigned indentation);
+        void writeQuantifiedBody(const Formula& body, unsigned indentation);
+        void writeClosingParenthesis(unsigned indentation);
+        void writeLineBreak();
+        void writeSeparator();
+    };
+}
+
+#endif
@@ -2,13 +2,19 @@
 
 #include <algorithm>
 #include <iostream>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <new>
+#include <shared_mutex>
 #include <string>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 #include <cassert>
 
+#include "Context.hpp"
+
 namespace logic {
     
 #pragma mark - Symbol
@@ -49,7 +55,7 @@ namespace logic {
         }
     }
     
-    std::string Symbol::toSMTLIB() const
+    std::string Symbol::smtlibNameFor(const std::string& name)
     {
         // if non-negative integer constant
         if (std::all_of(name.begin(), name.end(), ::isdigit))
@@ -70,57 +76,196 @@ namespace logic {
     
 #pragma mark - Signature
     
-    std::unordered_map<std::string, std::shared_ptr<const Symbol>> Signature::_signature;
+    Signature::Registry::Registry(const Context* base) :
+    base(base),
+    shards(),
+    varSymbolsMutex(),
+    varSymbols(),
+    symbolChunks(),
+    symbolsMutex(),
+    ownedSymbolChunks(),
+    numberOfSymbols(0),
+    symbolArena()
+    {
+        for (auto& chunk : symbolChunks)
+        {
+            chunk.store(nullptr, std::memory_order_relaxed);
+        }
+        if (base != nullptr)
+        {
+            auto& baseRegistry = *base->signature;
+            auto numberOfBaseChunks = (baseRegistry.numberOfSymbols + symbolChunkSize - 1) / symbolChunkSize;
+            for (unsigned i = 0; i < numberOfBaseChunks; ++i)
+            {
+                symbolChunks[i].store(baseRegistry.symbolChunks[i].load(std::memory_order_acquire), std::memory_order_relaxed);
+            }
+            numberOfSymbols = numberOfBaseChunks * symbolChunkSize;
+        }
+    }
+    
+    Signature::Registry& Signature::registry()
+    {
+        return *Context::current().signature;
+    }
+    
+    std::shared_ptr<const Symbol> Signature::newSymbol(std::string name, std::vector<const Sort*> argSorts, const Sort* rngSort, bool noDeclaration)
+    {
+        auto& context = Context::current();
+        assert(!context.isFrozen());
+        auto& registry = Signature::registry();
+        std::lock_guard<std::mutex> lock(registry.symbolsMutex);
+        
+        auto id = registry.numberOfSymbols;
+        auto chunkIndex = id / symbolChunkSize;
+        assert(chunkIndex < maxNumberOfSymbolChunks);
+        auto chunk = registry.symbolChunks[chunkIndex].load(std::memory_order_relaxed);
+        if (chunk == nullptr)
+        {
+            registry.ownedSymbolChunks.emplace_back(new std::shared_ptr<const Symbol>[symbolChunkSize]);
+            chunk = registry.ownedSymbolChunks.back().get();
+            registry.symbolChunks[chunkIndex].store(chunk, std::memory_order_release);
+        }
+        
+        auto symbol = context.handle<const Symbol>(registry.symbolArena.create<Symbol>([&](void* memory){ return new (memory) Symbol(id, name, std::move(argSorts), rngSort, noDeclaration); }));
+        chunk[id % symbolChunkSize] = symbol;
+        registry.numberOfSymbols++;
+        return symbol;
+    }
+    
+    // assumes that the caller holds the exclusive lock of shard
+    std::shared_ptr<const Symbol> Signature::addToShard(Shard& shard, std::string name, std::vector<const Sort*> argSorts, const Sort* rngSort, bool noDeclaration)
+    {
+        auto symbol = newSymbol(name, std::move(argSorts), rngSort, noDeclaration);
+        auto pair = shard.symbols.insert(std::make_pair(name, symbol));
+        assert(pair.second); // must succeed since the caller checked that no such symbols existed before the insertion
+        return pair.first->second;
+    }
     
     bool Signature::isDeclared(std::string name)
     {
-        auto it = _signature.find(name);
-        return (it != _signature.end());
+        return tryFetch(name) != nullptr;
     }
     
     std::shared_ptr<const Symbol> Signature::add(std::string name, std::vector<const Sort*> argSorts, const Sort* rngSort, bool noDeclaration)
     {
         // there must be no symbol with name name already added
-        assert(_signature.count(name) == 0);
+        assert(!isDeclared(name));
         
-        auto pair = _signature.insert(std::make_pair(name,std::unique_ptr<Symbol>(new Symbol(name, argSorts, rngSort, noDeclaration))));
-        assert(pair.second); // must succeed since we checked that no such symbols existed before the insertion
-        return pair.first->second;
+        auto& shard = shardOf(registry(), name);
+        std::unique_lock<std::shared_timed_mutex> lock(shard.mutex);
+        assert(shard.symbols.count(name) == 0);
+        
+        return addToShard(shard, name, std::move(argSorts), rngSort, noDeclaration);
     }
     
     std::shared_ptr<const Symbol> Signature::fetch(std::string name)
     {
-        auto it = _signature.find(name);
-        assert(it != _signature.end());
+        auto symbol = tryFetch(name);
+        assert(symbol != nullptr);
         
-        return it->second;
+        return symbol;
+    }
+    
+    std::shared_ptr<const Symbol> Signature::tryFetch(const std::string& name)
+    {
+        auto& registry = Signature::registry();
+        {
+            auto& shard = shardOf(registry, name);
+            std::shared_lock<std::shared_timed_mutex> lock(shard.mutex);
+            
+            auto it = shard.symbols.find(name);
+            if (it != shard.symbols.end())
+            {
+                return it->second;
+            }
+        }
+        if (registry.base != nullptr)
+        {
+            auto& baseShard = shardOf(*registry.base->signature, name);
+            auto it = baseShard.symbols.find(name);
+            if (it != baseShard.symbols.end())
+            {
+                return it->second;
+            }
+        }
+        return nullptr;
     }
     
     std::shared_ptr<const Symbol> Signature::fetchOrAdd(std::string name, std::vector<const Sort*> argSorts, const Sort* rngSort, bool noDeclaration)
     {
-        auto pair = _signature.insert(std::make_pair(name, std::shared_ptr<Symbol>(new Symbol(name, argSorts, rngSort, noDeclaration))));
-        
-        auto symbol = pair.first->second;
-        // if a symbol with the name already exist, make sure it has the same sorts
-        if (!pair.second)
+        auto symbol = tryFetch(name);
+        if (symbol == nullptr)
         {
-            assert(argSorts.size() == symbol->argSorts.size());
-            for (int i=0; i < argSorts.size(); ++i)
+            auto& shard = shardOf(registry(), name);
+            std::unique_lock<std::shared_timed_mutex> lock(shard.mutex);
+            
+            // another thread could have added the symbol after our lookup
+            auto it = shard.symbols.find(name);
+            if (it == shard.symbols.end())
             {
-                assert(argSorts[i] == symbol->argSorts[i]);
+                return addToShard(shard, name, std::move(argSorts), rngSort, noDeclaration);
             }
-            assert(rngSort = symbol->rngSort);
-            assert(noDeclaration == symbol->noDeclaration);
+            symbol = it->second;
         }
+
+        // if a symbol with the name already exist, make sure it has the same sorts
+        assert(argSorts == symbol->argSorts);
+        assert(rngSort == symbol->rngSort);
+        assert(noDeclaration == symbol->noDeclaration);
         return symbol;
     }
     
     std::shared_ptr<const Symbol> Signature::varSymbol(std::string name, const Sort* rngSort)
     {
         // there must be no symbol with name name already added
-        assert(_signature.count(name) == 0);
+        assert(!isDeclared(name));
         
-        return std::shared_ptr<Symbol>(new Symbol(name, rngSort, true));
+        auto& registry = Signature::registry();
+        auto key = std::make_pair(name, rngSort);
+        if (registry.base != nullptr)
+        {
+            auto& baseVarSymbols = registry.base->signature->varSymbols;
+            auto it = baseVarSymbols.find(key);
+            if (it != baseVarSymbols.end())
+            {
+                return it->second;
+            }
+        }
+        std::lock_guard<std::mutex> lock(registry.varSymbolsMutex);
+        auto it = registry.varSymbols.find(key);
+        if (it != registry.varSymbols.end())
+        {
+            return it->second;
+        }
+        auto symbol = newSymbol(name, {}, rngSort, true);
+        registry.varSymbols.insert(std::make_pair(key, symbol));
+        return symbol;
+    }
+    
+    std::vector<std::shared_ptr<const Symbol>> Signature::signature()
+    {
+        std::vector<std::shared_ptr<const Symbol>> symbols;
+        auto& registry = Signature::registry();
+        for (auto& shard : registry.shards)
+        {
+            std::shared_lock<std::shared_timed_mutex> lock(shard.mutex);
+            for (const auto& pair : shard.symbols)
+            {
+                symbols.push_back(pair.second);
+            }
+        }
+        if (registry.base != nullptr)
+        {
+            for (const auto& shard : registry.base->signature->shards)
+            {
+                for (const auto& pair : shard.symbols)
+                {
+                    symbols.push_back(pair.second);
+                }
+            }
+        }
+        std::sort(symbols.begin(), symbols.end(), [](const std::shared_ptr<const Symbol>& s1, const std::shared_ptr<const Symbol>& s2) { return s1->name < s2->name; });
+        return symbols;
     }
 
 }
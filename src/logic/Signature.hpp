@@ -1,47 +1,62 @@
 #ifndef __Signature__
 #define __Signature__
 
+#include <array>
+#include <atomic>
 #include <cstddef>
 #include <functional>
 #include <iostream>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <string>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 #include <cassert>
 
+#include "Arena.hpp"
+#include "NodeStatistics.hpp"
 #include "Sort.hpp"
 
 # pragma mark - Symbol
 
 namespace logic {
     
-    class Symbol {
+    class Context;
+
+
+    class Symbol : private CountedNode<Symbol, NodeKind::Symbol> {
         // we need each symbol to be either declared in the signature or to be a variable (which will be declared by the quantifier)
         // We use the Signature-class below as a manager-class for symbols of the first kind
         friend class Signature;
         
     private:
-        Symbol(std::string name, const Sort* rngSort, bool noDeclaration) :
+        Symbol(unsigned id, std::string name, const Sort* rngSort, bool noDeclaration) :
+        id(id),
         name(name),
         argSorts(),
         rngSort(rngSort),
-        noDeclaration(noDeclaration)
+        noDeclaration(noDeclaration),
+        smtlibName(smtlibNameFor(name))
         {
             assert(!name.empty());
         }
 
-        Symbol(std::string name, std::vector<const Sort*> argSorts, const Sort* rngSort, bool noDeclaration) :
+        Symbol(unsigned id, std::string name, std::vector<const Sort*> argSorts, const Sort* rngSort, bool noDeclaration) :
+        id(id),
         name(name),
         argSorts(std::move(argSorts)),
         rngSort(rngSort),
-        noDeclaration(noDeclaration)
+        noDeclaration(noDeclaration),
+        smtlibName(smtlibNameFor(name))
         {
             assert(!name.empty());
         }
      
     public:
+        const unsigned id; // dense index of the symbol, which can be used to fetch the symbol without hashing its name (cf. Signature::fetch)
         const std::string name;
         const std::vector<const Sort*> argSorts;
         const Sort* rngSort;
@@ -49,11 +64,16 @@ namespace logic {
 
         bool isPredicateSymbol() const { return rngSort == Sorts::boolSort(); }
          
-        std::string toSMTLIB() const;
+        const std::string& toSMTLIB() const { return smtlibName; }
         std::string declareSymbolSMTLIB() const;
         std::string declareSymbolColorSMTLIB() const;
         
         bool operator==(const Symbol &s) const {return name == s.name;}
+        
+    private:
+        // the smtlib-representation of the symbol, computed once at construction
+        const std::string smtlibName;
+        static std::string smtlibNameFor(const std::string& name);
     };
     
     // hack needed for bison: std::vector has no overload for ostream, but these overloads are needed for bison
@@ -89,7 +109,13 @@ namespace logic {
         size_t operator()(const std::unique_ptr<Symbol>& ptr) const {return std::hash<Symbol>()(*ptr);}
     };
     
-    // We use Signature as a manager-class for Symbol-instances
+    // We use Signature as a manager-class for Symbol-instances.
+    // All methods can be called concurrently from several threads:
+    // the signature is split into shards (selected by the hash of the name), each guarded by a readers-writer-lock,
+    // so that lookups of already declared symbols only take a shared lock of a single shard,
+    // and symbols are stored in chunks which are never moved, so that fetching a symbol by its id takes no lock at all.
+    // The symbols are owned by an arena and live as long as the logic::Context they were added to,
+    // the returned shared_ptrs are non-owning handles without reference counting (cf. logic::Context::handle).
     class Signature
     {
     public:
@@ -99,16 +125,67 @@ namespace logic {
         static std::shared_ptr<const Symbol> add(std::string name, std::vector<const Sort*> argSorts, const Sort* rngSort, bool noDeclaration=false);
         static std::shared_ptr<const Symbol> fetch(std::string name);
         static std::shared_ptr<const Symbol> fetchOrAdd(std::string name, std::vector<const Sort*> argSorts, const Sort* rngSort, bool noDeclaration=false);
+        // returns nullptr if no symbol with the given name was added
+        static std::shared_ptr<const Symbol> tryFetch(const std::string& name);
+        // fetch a symbol (either declared in the signature or a variable symbol) by its id, without any hashing or locking
+        static const std::shared_ptr<const Symbol>& fetch(unsigned id)
+        {
+            auto chunk = registry().symbolChunks[id / symbolChunkSize].load(std::memory_order_acquire);
+            assert(chunk != nullptr);
+            return chunk[id % symbolChunkSize];
+        }
 
         // check that variable doesn't use name which already occurs in Signature
         // return Symbol without adding it to Signature
+        // variable symbols are unique per name and sort, so repeated calls return the same Symbol
         static std::shared_ptr<const Symbol> varSymbol(std::string name, const Sort* rngSort);
 
-        static const std::unordered_map<std::string, std::shared_ptr<const Symbol>>& signature(){return _signature;}
+        // returns all symbols added to the signature so far, ordered by their name
+        // (and not by their id, since ids depend on the order in which concurrent threads added the symbols)
+        static std::vector<std::shared_ptr<const Symbol>> signature();
         
     private:
-        // _signature collects all symbols used so far.
-        static std::unordered_map<std::string, std::shared_ptr<const Symbol>> _signature;
+        friend class Context;
+        
+        // the symbols are owned by a registry, and each logic::Context owns its own registry.
+        // all methods operate on the registry of the context of the calling thread.
+        // the registry of an overlay (cf. logic::Context) also finds the symbols of its base, which is read without locking (since it is frozen).
+        struct Shard
+        {
+            std::shared_timed_mutex mutex;
+            std::unordered_map<std::string, std::shared_ptr<const Symbol>> symbols;
+        };
+        static const size_t numberOfShards = 64;
+        static const unsigned symbolChunkSize = 1024;
+        static const unsigned maxNumberOfSymbolChunks = 4096;
+        struct Registry
+        {
+            Registry(const Context* base);
+            
+            const Context* const base;
+            
+            // shards collect all symbols of the signature, selected by the hash of the name.
+            std::array<Shard, numberOfShards> shards;
+            
+            // varSymbols collects all variable symbols used so far (which are not part of the signature)
+            std::mutex varSymbolsMutex;
+            std::map<std::pair<std::string, const Sort*>, std::shared_ptr<const Symbol>> varSymbols;
+            
+            // symbolChunks collects all symbols (both the ones in the signature and the variable symbols), indexed by their id.
+            // a chunk is published (atomically) before any of its symbols, and is never moved afterwards.
+            // an overlay shares the chunks of its base, and numbers its own symbols starting with the first chunk after them,
+            // so that fetching a symbol by its id doesn't need to distinguish between the base and the overlay.
+            std::array<std::atomic<std::shared_ptr<const Symbol>*>, maxNumberOfSymbolChunks> symbolChunks;
+            std::mutex symbolsMutex;
+            std::vector<std::unique_ptr<std::shared_ptr<const Symbol>[]>> ownedSymbolChunks;
+            unsigned numberOfSymbols;
+            util::Arena symbolArena; // guarded by symbolsMutex
+        };
+        static Registry& registry();
+        static Shard& shardOf(Registry& registry, const std::string& name) { return registry.shards[std::hash<std::string>()(name) % numberOfShards]; }
+        
+        static std::shared_ptr<const Symbol> newSymbol(std::string name, std::vector<const Sort*> argSorts, const Sort* rngSort, bool noDeclaration);
+        static std::shared_ptr<const Symbol> addToShard(Shard& shard, std::string name, std::vector<const Sort*> argSorts, const Sort* rngSort, bool noDeclaration);
     };
 }
 #endif
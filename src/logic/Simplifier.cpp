@@ -0,0 +1,370 @@
+#include "Simplifier.hpp"
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <cassert>
+
+#include "Theory.hpp"
+
+namespace logic {
+
+    std::shared_ptr<const Formula> Simplifier::simplify(const std::shared_ptr<const Formula>& f)
+    {
+        auto it = simplified.find(f.get());
+        if (it != simplified.end())
+        {
+            return it->second;
+        }
+        auto result = simplifyUncached(f);
+        simplified[f.get()] = result;
+        return result;
+    }
+
+    void Simplifier::simplify(Problem& problem)
+    {
+        std::vector<std::shared_ptr<const Formula>> axioms;
+        for (const auto& axiom : problem.axioms)
+        {
+            auto simplifiedAxiom = simplify(axiom);
+            if (!isTrue(*simplifiedAxiom))
+            {
+                axioms.push_back(simplifiedAxiom);
+            }
+        }
+        problem.axioms = std::move(axioms);
+
+        std::vector<std::shared_ptr<const Formula>> lemmas;
+        std::vector<std::string> lemmaFamilies;
+        for (size_t i = 0; i < problem.lemmas.size(); ++i)
+        {
+            auto simplifiedLemma = simplify(problem.lemmas[i]);
+            if (!isTrue(*simplifiedLemma))
+            {
+                lemmas.push_back(simplifiedLemma);
+                if (!problem.lemmaFamilies.empty())
+                {
+                    lemmaFamilies.push_back(problem.lemmaFamilies[i]);
+                }
+            }
+        }
+        problem.lemmas = std::move(lemmas);
+        problem.lemmaFamilies = std::move(lemmaFamilies);
+
+        assert(problem.conjecture != nullptr);
+        problem.conjecture = simplify(problem.conjecture);
+    }
+
+    std::shared_ptr<const Formula> Simplifier::simplifyUncached(const std::shared_ptr<const Formula>& f)
+    {
+        switch (f->type())
+        {
+            case Formula::Type::Predicate:
+            {
+                auto castedFormula = std::static_pointer_cast<const PredicateFormula>(f);
+                bool value;
+                if (Theory::evaluateIntComparison(*castedFormula, value))
+                {
+                    return value ? Theory::boolTrue(labelOf(*f)) : Theory::boolFalse(labelOf(*f));
+                }
+                if (labelOf(*f) != f->label)
+                {
+                    return Formulas::predicate(castedFormula->symbol, castedFormula->subterms);
+                }
+                return f;
+            }
+            case Formula::Type::Equality:
+            {
+                auto castedFormula = std::static_pointer_cast<const EqualityFormula>(f);
+                // terms are hash-consed, so identical terms are the same object, and distinct integer constants have distinct values
+                int leftValue, rightValue;
+                if (castedFormula->left == castedFormula->right)
+                {
+                    return castedFormula->polarity ? Theory::boolTrue(labelOf(*f)) : Theory::boolFalse(labelOf(*f));
+                }
+                if (Theory::isIntConstant(*castedFormula->left, leftValue) && Theory::isIntConstant(*castedFormula->right, rightValue))
+                {
+                    return castedFormula->polarity ? Theory::boolFalse(labelOf(*f)) : Theory::boolTrue(labelOf(*f));
+                }
+                if (labelOf(*f) != f->label)
+                {
+                    auto equality = Formulas::equality(castedFormula->left, castedFormula->right);
+                    return castedFormula->polarity ? std::shared_ptr<const Formula>(equality) : Formulas::negation(equality);
+                }
+                return f;
+            }
+            case Formula::Type::Conjunction:
+            {
+                return simplifyJunction(*f, true);
+            }
+            case Formula::Type::Disjunction:
+            {
+                return simplifyJunction(*f, false);
+            }
+            case Formula::Type::Negation:
+            {
+                auto castedFormula = std::static_pointer_cast<const NegationFormula>(f);
+                auto subformula = simplify(castedFormula->f);
+                if (isTrue(*subformula))
+                {
+                    return Theory::boolFalse(labelOf(*f));
+                }
+                if (isFalse(*subformula))
+                {
+                    return Theory::boolTrue(labelOf(*f));
+                }
+                if (subformula->type() == Formula::Type::Negation && isMergeable(*subformula))
+                {
+                    return replacement(static_cast<const NegationFormula&>(*subformula).f, *f);
+                }
+                return Formulas::negation(subformula, labelOf(*f));
+            }
+            case Formula::Type::Existential:
+            {
+                return simplifyQuantifier(*f, false);
+            }
+            case Formula::Type::Universal:
+            {
+                return simplifyQuantifier(*f, true);
+            }
+            case Formula::Type::Implication:
+            {
+                auto castedFormula = std::static_pointer_cast<const ImplicationFormula>(f);
+                auto premise = simplify(castedFormula->f1);
+                auto conclusion = simplify(castedFormula->f2);
+                if (isFalse(*premise) || isTrue(*conclusion))
+                {
+                    return Theory::boolTrue(labelOf(*f));
+                }
+                if (isTrue(*premise))
+                {
+                    return replacement(conclusion, *f);
+                }
+                if (isFalse(*conclusion))
+                {
+                    return replacement(simplify(Formulas::negation(premise)), *f);
+                }
+                return Formulas::implication(premise, conclusion, labelOf(*f));
+            }
+        }
+        assert(false);
+        return f;
+    }
+
+    std::shared_ptr<const Formula> Simplifier::simplifyJunction(const Formula& f, bool isConjunction)
+    {
+        auto& subformulas = isConjunction ? static_cast<const ConjunctionFormula&>(f).conj
+                                          : static_cast<const DisjunctionFormula&>(f).disj;
+        // the neutral element is dropped, the absorbing element absorbs the whole junction
+        auto isNeutral = isConjunction ? isTrue : isFalse;
+        auto isAbsorbing = isConjunction ? isFalse : isTrue;
+        auto junctionType = isConjunction ? Formula::Type::Conjunction : Formula::Type::Disjunction;
+
+        std::vector<std::shared_ptr<const Formula>> result;
+        std::unordered_set<const Formula*> occurring;
+        auto add = [&](const std::shared_ptr<const Formula>& g) {
+            if (occurring.insert(g.get()).second)
+            {
+                result.push_back(g);
+            }
+        };
+
+        for (const auto& subformula : subformulas)
+        {
+            auto g = simplify(subformula);
+            if (isNeutral(*g))
+            {
+                continue;
+            }
+            if (isAbsorbing(*g))
+            {
+                return isConjunction ? Theory::boolFalse(labelOf(f)) : Theory::boolTrue(labelOf(f));
+            }
+            // g is already simplified, so its own subformulas are already flattened
+            if (g->type() == junctionType && isMergeable(*g))
+            {
+                auto& nested = isConjunction ? static_cast<const ConjunctionFormula&>(*g).conj
+                                             : static_cast<const DisjunctionFormula&>(*g).disj;
+                for (const auto& h : nested)
+                {
+                    add(h);
+                }
+            }
+            else
+            {
+                add(g);
+            }
+        }
+
+        if (result.empty())
+        {
+            return isConjunction ? Theory::boolTrue(labelOf(f)) : Theory::boolFalse(labelOf(f));
+        }
+        if (result.size() == 1 && labelOf(f).empty())
+        {
+            return result[0];
+        }
+        if (isConjunction)
+        {
+            return Formulas::conjunction(std::move(result), labelOf(f));
+        }
+        return Formulas::disjunction(std::move(result), labelOf(f));
+    }
+
+    std::shared_ptr<const Formula> Simplifier::simplifyQuantifier(const Formula& f, bool isUniversal)
+    {
+        auto& vars = isUniversal ? static_cast<const UniversalFormula&>(f).vars : static_cast<const ExistentialFormula&>(f).vars;
+        auto body = simplify(isUniversal ? static_cast<const UniversalFormula&>(f).f : static_cast<const ExistentialFormula&>(f).f);
+
+        // sorts are non-empty, so quantifying over true or false doesn't change anything
+        if (isTrue(*body) || isFalse(*body))
+        {
+            return replacement(body, f);
+        }
+
+        std::vector<std::shared_ptr<const Symbol>> occurringVars;
+        auto& symbols = variableSymbolsOf(*body);
+        for (const auto& var : vars)
+        {
+            if (symbols.count(var.get()) > 0)
+            {
+                occurringVars.push_back(var);
+            }
+        }
+        if (occurringVars.empty())
+        {
+            return replacement(body, f);
+        }
+        if (isUniversal)
+        {
+            return Formulas::universal(std::move(occurringVars), body, labelOf(f));
+        }
+        return Formulas::existential(std::move(occurringVars), body, labelOf(f));
+    }
+
+    std::shared_ptr<const Formula> Simplifier::replacement(const std::shared_ptr<const Formula>& simplified, const Formula& f)
+    {
+        auto label = labelOf(f);
+        if (label.empty() || simplified->label == label)
+        {
+            return simplified;
+        }
+        if (isTrue(*simplified))
+        {
+            return Theory::boolTrue(label);
+        }
+        if (isFalse(*simplified))
+        {
+            return Theory::boolFalse(label);
+        }
+        // there is no way to attach a second label to a formula, so we keep a single conjunct carrying the label
+        return Formulas::conjunction({simplified}, label);
+    }
+
+    const std::unordered_set<const Symbol*>& Simplifier::variableSymbolsOf(const Formula& f)
+    {
+        auto it = variableSymbols.find(&f);
+        if (it != variableSymbols.end())
+        {
+            return it->second;
+        }
+
+        std::unordered_set<const Symbol*> symbols;
+        switch (f.type())
+        {
+            case Formula::Type::Predicate:
+            {
+                for (const auto& subterm : static_cast<const PredicateFormula&>(f).subterms)
+                {
+                    collectVariableSymbols(*subterm, symbols);
+                }
+                break;
+            }
+            case Formula::Type::Equality:
+            {
+                collectVariableSymbols(*static_cast<const EqualityFormula&>(f).left, symbols);
+                collectVariableSymbols(*static_cast<const EqualityFormula&>(f).right, symbols);
+                break;
+            }
+            case Formula::Type::Conjunction:
+            case Formula::Type::Disjunction:
+            {
+                auto& subformulas = (f.type() == Formula::Type::Conjunction) ? static_cast<const ConjunctionFormula&>(f).conj
+                                                                            : static_cast<const DisjunctionFormula&>(f).disj;
+                for (const auto& subformula : subformulas)
+                {
+                    auto& subformulaSymbols = variableSymbolsOf(*subformula);
+                    symbols.insert(subformulaSymbols.begin(), subformulaSymbols.end());
+                }
+                break;
+            }
+            case Formula::Type::Negation:
+            {
+                symbols = variableSymbolsOf(*static_cast<const NegationFormula&>(f).f);
+                break;
+            }
+            case Formula::Type::Existential:
+            {
+                symbols = variableSymbolsOf(*static_cast<const ExistentialFormula&>(f).f);
+                break;
+            }
+            case Formula::Type::Universal:
+            {
+                symbols = variableSymbolsOf(*static_cast<const UniversalFormula&>(f).f);
+                break;
+            }
+            case Formula::Type::Implication:
+            {
+                auto& castedFormula = static_cast<const ImplicationFormula&>(f);
+                symbols = variableSymbolsOf(*castedFormula.f1);
+                auto& conclusionSymbols = variableSymbolsOf(*castedFormula.f2);
+                symbols.insert(conclusionSymbols.begin(), conclusionSymbols.end());
+                break;
+            }
+        }
+        return variableSymbols.emplace(&f, std::move(symbols)).first->second;
+    }
+
+    void Simplifier::collectVariableSymbols(const Term& t, std::unordered_set<const Symbol*>& symbols)
+    {
+        if (t.type() == Term::Type::Variable)
+        {
+            symbols.insert(t.symbol.get());
+            return;
+        }
+        auto& subterms = static_cast<const FuncTerm&>(t).subterms;
+        if (subterms.empty())
+        {
+            // variables bound by quantifiers of parsed formulas are represented as constants without declaration
+            if (t.symbol->noDeclaration)
+            {
+                symbols.insert(t.symbol.get());
+            }
+            return;
+        }
+        for (const auto& subterm : subterms)
+        {
+            collectVariableSymbols(*subterm, symbols);
+        }
+    }
+
+    bool Simplifier::isTrue(const Formula& f)
+    {
+        if (f.type() == Formula::Type::Conjunction)
+        {
+            return static_cast<const ConjunctionFormula&>(f).conj.empty();
+        }
+        return f.unlabeled() == Theory::boolTrue().get();
+    }
+
+    bool Simplifier::isFalse(const Formula& f)
+    {
+        if (f.type() == Formula::Type::Disjunction)
+        {
+            return static_cast<const DisjunctionFormula&>(f).disj.empty();
+        }
+        return f.unlabeled() == Theory::boolFalse().get();
+    }
+}
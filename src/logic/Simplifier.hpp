@@ -0,0 +1,61 @@
+#ifndef __Simplifier__
+#define __Simplifier__
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "Formula.hpp"
+#include "Problem.hpp"
+
+namespace logic {
+
+    /*
+     * Removes trivial structure from formulas, without changing their semantics:
+     * - nested conjunctions and disjunctions are flattened, duplicate conjuncts and disjuncts are removed
+     * - true and false are propagated through all connectives (e.g. (=> true f) becomes f)
+     * - double negations are removed
+     * - quantified variables which don't occur in the body are removed (and so are quantifiers without variables)
+     * - comparisons of integer constants and equalities between identical terms are evaluated
+     * If keepLabels is true, labeled subformulas are never merged into their parents, so that the labels are preserved.
+     * Otherwise all labels are removed.
+     * Since formulas are hash-consed, each distinct subformula is only simplified once.
+     */
+    class Simplifier
+    {
+    public:
+        Simplifier(bool keepLabels = true) : keepLabels(keepLabels), simplified(), variableSymbols() {}
+
+        std::shared_ptr<const Formula> simplify(const std::shared_ptr<const Formula>& f);
+
+        // simplifies all formulas of the problem, and removes axioms and lemmas which simplify to true
+        void simplify(Problem& problem);
+
+    private:
+        const bool keepLabels;
+
+        std::unordered_map<const Formula*, std::shared_ptr<const Formula>> simplified;
+        std::unordered_map<const Formula*, std::unordered_set<const Symbol*>> variableSymbols;
+
+        std::shared_ptr<const Formula> simplifyUncached(const std::shared_ptr<const Formula>& f);
+        std::shared_ptr<const Formula> simplifyJunction(const Formula& f, bool isConjunction);
+        std::shared_ptr<const Formula> simplifyQuantifier(const Formula& f, bool isUniversal);
+
+        // returns simplified as replacement for f, preserving the label of f (if labels are kept)
+        std::shared_ptr<const Formula> replacement(const std::shared_ptr<const Formula>& simplified, const Formula& f);
+
+        // the symbols of nullary terms and variables occurring in f (which include the symbols of all variables occurring in f)
+        const std::unordered_set<const Symbol*>& variableSymbolsOf(const Formula& f);
+        void collectVariableSymbols(const Term& t, std::unordered_set<const Symbol*>& symbols);
+
+        std::string labelOf(const Formula& f) const { return keepLabels ? f.label : ""; }
+        bool isMergeable(const Formula& f) const { return !keepLabels || f.label.empty(); }
+
+        static bool isTrue(const Formula& f);
+        static bool isFalse(const Formula& f);
+    };
+}
+
+#endif
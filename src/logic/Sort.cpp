@@ -1,48 +1,57 @@
 #include "Sort.hpp"
 
+#include <atomic>
 #include <iostream>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <string>
 #include <utility>
+#include <cassert>
 
+#include "Context.hpp"
 #include "Options.hpp"
 
 namespace logic {
     
 #pragma mark - Sort
     
-    std::string Sort::toSMTLIB() const
+    Sort::Kind Sort::kindForName(const std::string& name)
     {
         if (name == "Int")
         {
-            return "Int";
+            return Kind::Int;
         }
         else if (name == "Bool")
         {
-            return "Bool";
+            return Kind::Bool;
+        }
+        else if (name == "Nat")
+        {
+            return Kind::Nat;
         }
         else
         {
-            return name;
+            return Kind::Uninterpreted;
         }
     }
     
     std::string declareSortSMTLIB(const Sort& s)
     {
-        if (s.toSMTLIB() == "Int" || s.toSMTLIB() == "Bool")
-        {
-            // SMTLIB already knows Int and Bool.
-            return "";
-        }
-        else if (s.toSMTLIB() == "Nat")
+        switch (s.kind)
         {
-            return "(declare-datatypes ((Nat 0)) (( (zero) (s (p Nat)) )) )\n";
-        }
-        else
-        {
-            return "(declare-sort " + s.toSMTLIB() + " 0)\n";
+            case Sort::Kind::Int:
+            case Sort::Kind::Bool:
+                // SMTLIB already knows Int and Bool.
+                return "";
+            case Sort::Kind::Nat:
+                return "(declare-datatypes ((Nat 0)) (( (zero) (s (p Nat)) )) )\n";
+            case Sort::Kind::Uninterpreted:
+                return "(declare-sort " + s.toSMTLIB() + " 0)\n";
         }
+        assert(false);
+        return "";
     }
     
     bool Sort::operator==(Sort& o)
@@ -57,22 +66,61 @@ namespace logic {
     
 #pragma mark - Sorts
 
+    std::shared_timed_mutex Sorts::_sortsMutex;
     std::map<std::string, std::unique_ptr<Sort>> Sorts::_sorts;
+    
+    Sorts::Registry::Registry(const Context* base) : base(base), used()
+    {
+        for (auto& flag : used)
+        {
+            flag.store(false, std::memory_order_relaxed);
+        }
+    }
+    
+    Sorts::Registry& Sorts::registry()
+    {
+        return *Context::current().sorts;
+    }
 
     Sort* Sorts::fetchOrDeclare(std::string name)
     {
-        auto it = _sorts.find(name);
+        {
+            std::shared_lock<std::shared_timed_mutex> lock(_sortsMutex);
+            auto it = _sorts.find(name);
+            if (it != _sorts.end())
+            {
+                return (*it).second.get();
+            }
+        }
         
-        if (it == _sorts.end())
+        std::unique_lock<std::shared_timed_mutex> lock(_sortsMutex);
+        // if another thread declared the sort in the meantime, the insertion fails and returns the existing sort
+        auto ret = _sorts.insert(std::make_pair(name, std::unique_ptr<Sort>(nullptr)));
+        if (ret.second)
         {
-            auto ret = _sorts.insert(std::make_pair(name, std::unique_ptr<Sort>(new Sort(name))));
-            return ret.first->second.get();
+            auto index = static_cast<unsigned>(_sorts.size() - 1);
+            assert(index < maxNumberOfSorts);
+            ret.first->second.reset(new Sort(name, index));
         }
-        else
+        return ret.first->second.get();
+    }
+    
+    std::vector<const Sort*> Sorts::nameToSort()
+    {
+        auto& registry = Sorts::registry();
+        auto baseRegistry = registry.base != nullptr ? registry.base->sorts.get() : nullptr;
+        std::shared_lock<std::shared_timed_mutex> lock(_sortsMutex);
+        std::vector<const Sort*> sorts;
+        for (const auto& pair : _sorts)
         {
-            return (*it).second.get();
+            auto index = pair.second->index;
+            if (registry.used[index].load(std::memory_order_relaxed) ||
+                (baseRegistry != nullptr && baseRegistry->used[index].load(std::memory_order_relaxed)))
+            {
+                sorts.push_back(pair.second.get());
+            }
         }
+        return sorts;
     }
     
 }
-
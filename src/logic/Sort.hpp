@@ -1,13 +1,19 @@
 #ifndef __Sort__
 #define __Sort__
 
+#include <array>
+#include <atomic>
 #include <iostream>
 #include <map>
 #include <memory>
+#include <shared_mutex>
 #include <string>
+#include <vector>
 
 namespace logic {
     
+    class Context;
+
 #pragma mark - Sort
 
     class Sort
@@ -18,14 +24,25 @@ namespace logic {
         
     private:
         // constructor is private to prevent accidental usage.
-        Sort(std::string name) : name(name){};
+        Sort(std::string name, unsigned index) : name(name), kind(kindForName(name)), index(index) {};
         
     public:
         const std::string name;
         
+        // Int and Bool are builtin in smtlib, Nat is declared as datatype, all other sorts are uninterpreted.
+        // the kind is computed once at construction, so that the output doesn't need to compare names.
+        enum class Kind { Int, Bool, Nat, Uninterpreted };
+        const Kind kind;
+        
         bool operator==(Sort& o);
         
-        std::string toSMTLIB() const;
+        const std::string& toSMTLIB() const { return name; }
+        
+    private:
+        static Kind kindForName(const std::string& name);
+        
+        // dense index of the sort, in the order of declaration (cf. Sorts::Registry)
+        const unsigned index;
     };
     std::ostream& operator<<(std::ostream& ostr, const Sort& s);
     
@@ -35,22 +52,50 @@ namespace logic {
 #pragma mark - Sorts
 
     // we need each sort to be unique.
-    // We therefore use Sorts as a manager-class for Sort-instances
+    // We therefore use Sorts as a manager-class for Sort-instances.
+    // Sorts can be declared concurrently from several threads. The builtin sorts are cached after their first use,
+    // so fetching them takes no lock. Sorts are shared by all logic::Contexts and never deleted,
+    // only the information which sorts are used is owned by each context.
     class Sorts
     {
     public:
         // construct various sorts
-        static Sort* boolSort() { return fetchOrDeclare("Bool"); }
-        static Sort* intSort() { return fetchOrDeclare("Int"); }
-        static Sort* natSort() { return fetchOrDeclare("Nat"); }
-        static Sort* timeSort() { return fetchOrDeclare("Time"); }
-        static Sort* traceSort() { return fetchOrDeclare("Trace"); }
+        static Sort* boolSort() { static Sort* const sort = fetchOrDeclare("Bool"); return use(sort); }
+        static Sort* intSort() { static Sort* const sort = fetchOrDeclare("Int"); return use(sort); }
+        static Sort* natSort() { static Sort* const sort = fetchOrDeclare("Nat"); return use(sort); }
+        static Sort* timeSort() { static Sort* const sort = fetchOrDeclare("Time"); return use(sort); }
+        static Sort* traceSort() { static Sort* const sort = fetchOrDeclare("Trace"); return use(sort); }
 
-        // returns map containing all previously constructed sorts as pairs (nameOfSort, Sort)
-        static const std::map<std::string, std::unique_ptr<Sort>>& nameToSort(){return _sorts;};
+        // returns all sorts used in the context of the calling thread, ordered by their name
+        static std::vector<const Sort*> nameToSort();
         
     private:
+        friend class Context;
+        
+        static const unsigned maxNumberOfSorts = 64;
+        // used[i] is true iff the sort with index i was used in the context owning the registry, i.e. iff it needs to be declared in the output.
+        // the sorts used in the base of an overlay are used in the overlay as well.
+        // all methods operate on the registry of the context of the calling thread.
+        struct Registry
+        {
+            Registry(const Context* base);
+            const Context* const base;
+            std::array<std::atomic<bool>, maxNumberOfSorts> used;
+        };
+        static Registry& registry();
+        
         static Sort* fetchOrDeclare(std::string name);
+        static Sort* use(Sort* sort)
+        {
+            auto& used = registry().used[sort->index];
+            // check first, so that the common case doesn't write to shared memory
+            if (!used.load(std::memory_order_relaxed))
+            {
+                used.store(true, std::memory_order_relaxed);
+            }
+            return sort;
+        }
+        static std::shared_timed_mutex _sortsMutex;
         static std::map<std::string, std::unique_ptr<Sort>> _sorts;
     };
 
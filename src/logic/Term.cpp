@@ -2,20 +2,27 @@
 
 #include <iostream>
 #include <memory>
+#include <mutex>
+#include <new>
+#include <sstream>
 #include <string>
 #include <vector>
 
+#include "Context.hpp"
+#include "Hash.hpp"
+#include "SMTLIBWriter.hpp"
+
 namespace logic {
 
     // hack needed for bison: std::vector has no overload for ostream, but these overloads are needed for bison
     std::ostream& operator<<(std::ostream& ostr, const std::vector<std::shared_ptr<const logic::Term>>& t){ostr << "not implemented"; return ostr;}
     std::ostream& operator<<(std::ostream& ostr, const std::vector<std::shared_ptr<const logic::LVariable>>& v){ostr << "not implemented"; return ostr;}
 
-  unsigned LVariable::freshId = 0;
-
-    std::string LVariable::toSMTLIB() const
+    std::string Term::toSMTLIB() const
     {
-        return symbol->name;
+        std::ostringstream ostr;
+        SMTLIBWriter(ostr).write(*this);
+        return ostr.str();
     }
     
     std::string LVariable::prettyString() const
@@ -23,24 +30,6 @@ namespace logic {
         return symbol->name;
     }
 
-    std::string FuncTerm::toSMTLIB() const
-    {
-        if (subterms.size() == 0)
-        {
-            return symbol->toSMTLIB();
-        }
-        else
-        {
-            std::string str = "(" + symbol->toSMTLIB() + " ";
-            for (unsigned i = 0; i < subterms.size(); i++)
-            {
-                str += subterms[i]->toSMTLIB();
-                str += (i == subterms.size() - 1) ? ")" : " ";
-            }
-            return str;
-        }
-    }
-    
     std::string FuncTerm::prettyString() const
     {
         if (subterms.size() == 0)
@@ -69,25 +58,123 @@ namespace logic {
     
 # pragma mark - Terms
     
+    Terms::Registry::Registry(const Context* base) :
+    base(base),
+    shards(),
+    freshVariableId(base != nullptr ? base->terms->freshVariableId.load() : 0)
+    {
+    }
+    
+    Terms::Registry& Terms::registry()
+    {
+        return *Context::current().terms;
+    }
+    
     std::shared_ptr<const LVariable> Terms::var(std::shared_ptr<const Symbol> symbol)
     {
-        return std::shared_ptr<const LVariable>(new LVariable(symbol));
+        auto hash = std::hash<const Symbol*>()(symbol.get());
+        auto& context = Context::current();
+        auto& registry = *context.terms;
+        if (registry.base != nullptr)
+        {
+            auto& baseShard = registry.base->terms->shards[hash % numberOfShards];
+            auto it = baseShard.variables.find(symbol.get());
+            if (it != baseShard.variables.end())
+            {
+                return registry.base->handle(it->second);
+            }
+        }
+        
+        auto& shard = registry.shards[hash % numberOfShards];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.variables.find(symbol.get());
+        if (it != shard.variables.end())
+        {
+            return context.handle(it->second);
+        }
+        assert(!context.isFrozen());
+        auto variable = shard.arena.create<LVariable>([&](void* memory){ return new (memory) LVariable(symbol, registry.freshVariableId++, hash); });
+        shard.variables.insert(std::make_pair(variable->symbol.get(), variable));
+        return context.handle<const LVariable>(variable);
     }
     
     std::shared_ptr<const FuncTerm> Terms::func(std::string name, std::vector<std::shared_ptr<const Term>> subterms, const Sort* sort, bool noDeclaration)
     {
-        std::vector<const Sort*> subtermSorts;
-        for (const auto& subterm : subterms)
+        // only collect the argument sorts if the symbol needs to be added
+        auto symbol = Signature::tryFetch(name);
+        if (symbol == nullptr)
         {
-            subtermSorts.push_back(subterm->symbol->rngSort);
+            std::vector<const Sort*> subtermSorts;
+            for (const auto& subterm : subterms)
+            {
+                subtermSorts.push_back(subterm->symbol->rngSort);
+            }
+            symbol = Signature::fetchOrAdd(name, std::move(subtermSorts), sort, noDeclaration);
         }
-        auto symbol = Signature::fetchOrAdd(name, subtermSorts, sort, noDeclaration);
-        return std::shared_ptr<const FuncTerm>(new FuncTerm(symbol, subterms));
+        assert(symbol->rngSort == sort);
+        assert(symbol->noDeclaration == noDeclaration);
+        return func(symbol, std::move(subterms));
     }
     
     std::shared_ptr<const FuncTerm> Terms::func(std::shared_ptr<const Symbol> symbol, std::vector<std::shared_ptr<const Term>> subterms)
     {
-        return std::shared_ptr<const FuncTerm>(new FuncTerm(symbol, subterms));
+        auto hash = std::hash<const Symbol*>()(symbol.get());
+        for (const auto& subterm : subterms)
+        {
+            util::hashCombine(hash, subterm->hash);
+        }
+        
+        // return existing term if there is one
+        auto& context = Context::current();
+        auto& registry = *context.terms;
+        if (registry.base != nullptr)
+        {
+            auto& baseShard = registry.base->terms->shards[hash % numberOfShards];
+            auto range = baseShard.funcTerms.equal_range(hash);
+            for (auto it = range.first; it != range.second; ++it)
+            {
+                auto candidate = it->second;
+                if (candidate->symbol == symbol && candidate->subterms == subterms)
+                {
+                    return registry.base->handle(candidate);
+                }
+            }
+        }
+        
+        auto& shard = registry.shards[hash % numberOfShards];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto range = shard.funcTerms.equal_range(hash);
+        for (auto it = range.first; it != range.second; ++it)
+        {
+            auto candidate = it->second;
+            if (candidate->symbol == symbol && candidate->subterms == subterms)
+            {
+                return context.handle(candidate);
+            }
+        }
+        
+        assert(!context.isFrozen());
+        auto term = shard.arena.create<FuncTerm>([&](void* memory){ return new (memory) FuncTerm(symbol, std::move(subterms), hash); });
+        shard.funcTerms.insert(std::make_pair(hash, term));
+        return context.handle<const FuncTerm>(term);
+    }
+    
+    size_t Terms::numberOfTerms()
+    {
+        size_t numberOfTerms = 0;
+        auto& registry = Terms::registry();
+        for (auto& shard : registry.shards)
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            numberOfTerms += shard.variables.size() + shard.funcTerms.size();
+        }
+        if (registry.base != nullptr)
+        {
+            for (const auto& shard : registry.base->terms->shards)
+            {
+                numberOfTerms += shard.variables.size() + shard.funcTerms.size();
+            }
+        }
+        return numberOfTerms;
     }
 }
-
@@ -1,13 +1,18 @@
 #ifndef __Term__
 #define __Term__
 
+#include <array>
+#include <atomic>
 #include <iostream>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 #include <cassert>
 
+#include "Arena.hpp"
 #include "Signature.hpp"
 #include "Sort.hpp"
 
@@ -16,37 +21,43 @@ namespace logic {
     class Term
     {
     public:
-        Term(std::shared_ptr<const Symbol> symbol) : symbol(symbol) {}
+        Term(std::shared_ptr<const Symbol> symbol, size_t hash) : symbol(symbol), hash(hash) {}
         virtual ~Term() {}
 
         std::shared_ptr<const Symbol> symbol;
         
-        virtual std::string toSMTLIB() const = 0;
+        // structural hash, computed once at construction.
+        // Terms are hash-consed by the Terms-class, so two terms are structurally equal iff they are the same object.
+        const size_t hash;
+        
+        enum class Type { Variable, FuncTerm };
+        virtual Type type() const = 0;
+        
+        // convenience method, use SMTLIBWriter to write the term directly into an ostream
+        std::string toSMTLIB() const;
         virtual std::string prettyString() const = 0;
     };
     
-    class LVariable : public Term
+    class LVariable : public Term, private CountedNode<LVariable, NodeKind::LVariable>
     {
         friend class Terms;
         
-        LVariable(std::shared_ptr<const Symbol> symbol) : Term(symbol), id(freshId++){}
+        LVariable(std::shared_ptr<const Symbol> symbol, unsigned id, size_t hash) : Term(symbol, hash), id(id){}
 
     public:
         const unsigned id;
 
-        std::string toSMTLIB() const override;
+        Type type() const override { return Type::Variable; }
         virtual std::string prettyString() const override;
-        
-        static unsigned freshId;
     };
     
     bool compareLVarPointers(const LVariable* p1, const LVariable* p2);
     bool eqLVarPointers(const LVariable* p1, const LVariable* p2);
     
-    class FuncTerm : public Term
+    class FuncTerm : public Term, private CountedNode<FuncTerm, NodeKind::FuncTerm>
     {
         friend class Terms;
-        FuncTerm(std::shared_ptr<const Symbol> symbol, std::vector<std::shared_ptr<const Term>> subterms) : Term(symbol), subterms(std::move(subterms))
+        FuncTerm(std::shared_ptr<const Symbol> symbol, std::vector<std::shared_ptr<const Term>> subterms, size_t hash) : Term(symbol, hash), subterms(std::move(subterms))
         {
             assert(this->symbol->argSorts.size() == this->subterms.size());
             for (int i=0; i < this->symbol->argSorts.size(); ++i)
@@ -58,7 +69,7 @@ namespace logic {
     public:
         const std::vector<std::shared_ptr<const Term>> subterms;
         
-        std::string toSMTLIB() const override;
+        Type type() const override { return Type::FuncTerm; }
         virtual std::string prettyString() const override;
     };
     
@@ -70,15 +81,54 @@ namespace logic {
 
 # pragma mark - Terms
     
-    // We use Terms as a manager-class for Term-instances
+    // We use Terms as a manager-class for Term-instances.
+    // Terms are hash-consed: constructing a term which is structurally equal to an existing term returns the existing term,
+    // so all structurally equal terms share a single node.
+    // Terms can be constructed concurrently from several threads: the term bank is split into shards (selected by the hash of the term),
+    // each guarded by its own lock.
+    // The terms are owned by the arenas of the shards and live as long as the logic::Context they were constructed in,
+    // the returned shared_ptrs are non-owning handles without reference counting (cf. logic::Context::handle).
     class Terms
     {
     public:
 
-        // construct new terms
+        // construct new terms (or fetch the existing structurally equal term)
         static std::shared_ptr<const LVariable> var(std::shared_ptr<const Symbol> symbol);
         static std::shared_ptr<const FuncTerm> func(std::string name, std::vector<std::shared_ptr<const Term>> subterms, const Sort* sort, bool noDeclaration=false);
         static std::shared_ptr<const FuncTerm> func(std::shared_ptr<const Symbol> symbol, std::vector<std::shared_ptr<const Term>> subterms);
+        
+        // the number of terms constructed so far (including the terms of the base of an overlay, cf. logic::Context)
+        static size_t numberOfTerms();
+        
+    private:
+        friend class Context;
+        
+
+        // the term bank: all terms constructed so far.
+        // variables are unique per symbol (variable symbols are unique per name and sort, cf. Signature::varSymbol).
+        // function terms are bucketed by their hash and compared on symbol and (pointers to) subterms,
+        // which is sufficient since the subterms are already hash-consed.
+        struct Shard
+        {
+            std::mutex mutex;
+            util::Arena arena;
+            std::unordered_map<const Symbol*, const LVariable*> variables;
+            std::unordered_multimap<size_t, const FuncTerm*> funcTerms;
+        };
+        static const size_t numberOfShards = 64;
+        // the term bank is owned by a registry, and each logic::Context owns its own registry.
+        // all methods operate on the registry of the context of the calling thread.
+        // the registry of an overlay (cf. logic::Context) first looks for terms in its base, which is read without locking (since it is frozen),
+        // and continues the numbering of the variables of the base.
+        struct Registry
+        {
+            Registry(const Context* base);
+            
+            const Context* const base;
+            std::array<Shard, numberOfShards> shards;
+            std::atomic<unsigned> freshVariableId;
+        };
+        static Registry& registry();
     };
 }
 #endif
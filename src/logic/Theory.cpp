@@ -1,7 +1,16 @@
 #include "Theory.hpp"
 
+#include <algorithm>
+#include <limits>
 #include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Context.hpp"
 
 namespace logic {
 
@@ -29,79 +38,226 @@ namespace logic {
         natSub(zero, zero);
     }
 
+    Theory::Registry::Registry(const Context* base) :
+    base(base),
+    intTheorySymbols(base != nullptr ? base->theory->intTheorySymbols : nullptr),
+    natTheorySymbols(base != nullptr ? base->theory->natTheorySymbols : nullptr),
+    intConstantsMutex(),
+    intConstants()
+    {
+    }
+
+    Theory::Registry& Theory::registry()
+    {
+        return *Context::current().theory;
+    }
+
+    const Theory::IntTheorySymbols& Theory::intTheorySymbols()
+    {
+        auto& registry = Theory::registry();
+        if (registry.intTheorySymbols == nullptr)
+        {
+            auto intSort = Sorts::intSort();
+            std::vector<const Sort*> binary = {intSort, intSort};
+            registry.intTheorySymbols = std::shared_ptr<const IntTheorySymbols>(new IntTheorySymbols {
+                Signature::fetchOrAdd("+", binary, intSort, true)->id,
+                Signature::fetchOrAdd("-", binary, intSort, true)->id,
+                Signature::fetchOrAdd("mod", binary, intSort, true)->id,
+                Signature::fetchOrAdd("*", binary, intSort, true)->id,
+                Signature::fetchOrAdd("abs", {intSort}, intSort, true)->id,
+                Signature::fetchOrAdd("<", binary, Sorts::boolSort(), true)->id,
+                Signature::fetchOrAdd("<=", binary, Sorts::boolSort(), true)->id,
+                Signature::fetchOrAdd(">", binary, Sorts::boolSort(), true)->id,
+                Signature::fetchOrAdd(">=", binary, Sorts::boolSort(), true)->id,
+                Signature::fetchOrAdd("true", {}, Sorts::boolSort(), true)->id,
+                Signature::fetchOrAdd("false", {}, Sorts::boolSort(), true)->id
+            });
+        }
+        return *registry.intTheorySymbols;
+    }
+
+    const Theory::NatTheorySymbols& Theory::natTheorySymbols()
+    {
+        auto& registry = Theory::registry();
+        if (registry.natTheorySymbols == nullptr)
+        {
+            auto natSort = Sorts::natSort();
+            registry.natTheorySymbols = std::shared_ptr<const NatTheorySymbols>(new NatTheorySymbols {
+                Signature::fetchOrAdd("zero", {}, natSort, true)->id,
+                Signature::fetchOrAdd("s", {natSort}, natSort, true)->id,
+                Signature::fetchOrAdd("p", {natSort}, natSort, true)->id
+            });
+        }
+        return *registry.natTheorySymbols;
+    }
+
+    bool Theory::intConstantId(Registry& registry, int i, unsigned& id)
+    {
+        if (registry.base != nullptr)
+        {
+            auto& baseIntConstants = registry.base->theory->intConstants;
+            auto it = baseIntConstants.find(i);
+            if (it != baseIntConstants.end())
+            {
+                id = it->second;
+                return true;
+            }
+        }
+        std::shared_lock<std::shared_timed_mutex> lock(registry.intConstantsMutex);
+        auto it = registry.intConstants.find(i);
+        if (it == registry.intConstants.end())
+        {
+            return false;
+        }
+        id = it->second;
+        return true;
+    }
+
     std::shared_ptr<const FuncTerm> Theory::intConstant(int i)
     {
-        return Terms::func(std::to_string(i), {}, Sorts::intSort(), true);
+        auto& registry = Theory::registry();
+        unsigned id;
+        if (intConstantId(registry, i, id))
+        {
+            return Terms::func(Signature::fetch(id), {});
+        }
+        auto symbol = Signature::fetchOrAdd(std::to_string(i), {}, Sorts::intSort(), true);
+        {
+            std::unique_lock<std::shared_timed_mutex> lock(registry.intConstantsMutex);
+            registry.intConstants.insert(std::make_pair(i, symbol->id));
+        }
+        return Terms::func(symbol, {});
     }
     
     std::shared_ptr<const FuncTerm> Theory::intAddition(std::shared_ptr<const Term> t1, std::shared_ptr<const Term> t2)
     {
-        return Terms::func("+", {t1,t2}, Sorts::intSort(), true);
+        return Terms::func(Signature::fetch(intTheorySymbols().addition), {t1,t2});
     }
     
     std::shared_ptr<const FuncTerm> Theory::intSubtraction(std::shared_ptr<const Term> t1, std::shared_ptr<const Term> t2)
     {
-        return Terms::func("-", {t1,t2}, Sorts::intSort(), true);
+        return Terms::func(Signature::fetch(intTheorySymbols().subtraction), {t1,t2});
     }
 
     std::shared_ptr<const FuncTerm> Theory::intModulo(std::shared_ptr<const Term> t1, std::shared_ptr<const Term> t2)
     {
-        return Terms::func("mod", {t1,t2}, Sorts::intSort(), true);
+        return Terms::func(Signature::fetch(intTheorySymbols().modulo), {t1,t2});
     }
     
     std::shared_ptr<const FuncTerm> Theory::intMultiplication(std::shared_ptr<const Term> t1, std::shared_ptr<const Term> t2)
     {
-        return Terms::func("*", {t1,t2}, Sorts::intSort(), true);
+        return Terms::func(Signature::fetch(intTheorySymbols().multiplication), {t1,t2});
     }
     
     std::shared_ptr<const FuncTerm> Theory::intAbsolute(std::shared_ptr<const Term> t)
     {
-        return Terms::func("abs", {t}, Sorts::intSort(), true);
+        return Terms::func(Signature::fetch(intTheorySymbols().absolute), {t});
     }
     
     std::shared_ptr<const Formula> Theory::intLess(std::shared_ptr<const Term> t1, std::shared_ptr<const Term> t2, std::string label)
     {
-        return Formulas::predicate("<", {t1,t2}, label, true);
+        return Formulas::predicate(Signature::fetch(intTheorySymbols().less), {t1,t2}, label);
     }
     
     std::shared_ptr<const Formula> Theory::intLessEqual(std::shared_ptr<const Term> t1, std::shared_ptr<const Term> t2, std::string label)
     {
-        return Formulas::predicate("<=", {t1,t2}, label, true);
+        return Formulas::predicate(Signature::fetch(intTheorySymbols().lessEqual), {t1,t2}, label);
     }
 
     std::shared_ptr<const Formula> Theory::intGreater(std::shared_ptr<const Term> t1, std::shared_ptr<const Term> t2,  std::string label)
     {
-        return Formulas::predicate(">", {t1,t2}, label, true);
+        return Formulas::predicate(Signature::fetch(intTheorySymbols().greater), {t1,t2}, label);
     }
     
     std::shared_ptr<const Formula> Theory::intGreaterEqual(std::shared_ptr<const Term> t1, std::shared_ptr<const Term> t2, std::string label)
     {
-        return Formulas::predicate(">=", {t1,t2}, label, true);
+        return Formulas::predicate(Signature::fetch(intTheorySymbols().greaterEqual), {t1,t2}, label);
     }
     
     std::shared_ptr<const Formula> Theory::boolTrue(std::string label)
     {
-        return Formulas::predicate("true", {}, label, true);
+        return Formulas::predicate(Signature::fetch(intTheorySymbols().boolTrue), {}, label);
     }
     
     std::shared_ptr<const Formula> Theory::boolFalse(std::string label)
     {
-        return Formulas::predicate("false", {}, label, true);
+        return Formulas::predicate(Signature::fetch(intTheorySymbols().boolFalse), {}, label);
     }
     
     std::shared_ptr<const FuncTerm> Theory::natZero()
     {
-        return Terms::func("zero", {}, Sorts::natSort(), true);
+        return Terms::func(Signature::fetch(natTheorySymbols().zero), {});
     }
     
     std::shared_ptr<const FuncTerm> Theory::natSucc(std::shared_ptr<const Term> term)
     {
-        return Terms::func("s", {term}, Sorts::natSort(), true);
+        return Terms::func(Signature::fetch(natTheorySymbols().succ), {term});
     }
     
     std::shared_ptr<const FuncTerm> Theory::natPre(std::shared_ptr<const Term> term)
     {
-        return Terms::func("p", {term}, Sorts::natSort(), true);
+        return Terms::func(Signature::fetch(natTheorySymbols().pre), {term});
+    }
+    
+    bool Theory::isIntConstant(const Term& term, int& value)
+    {
+        if (term.type() != Term::Type::FuncTerm || !static_cast<const FuncTerm&>(term).subterms.empty())
+        {
+            return false;
+        }
+        // the names of integer constants are the decimal representation of their value, which fits into an int
+        auto& name = term.symbol->name;
+        auto digits = (name[0] == '-') ? name.begin() + 1 : name.begin();
+        if (digits == name.end() || name.end() - digits > 10 || !std::all_of(digits, name.end(), ::isdigit))
+        {
+            return false;
+        }
+        auto parsedValue = std::stoll(name);
+        if (parsedValue < std::numeric_limits<int>::min() || parsedValue > std::numeric_limits<int>::max())
+        {
+            return false;
+        }
+        unsigned id;
+        if (!intConstantId(registry(), static_cast<int>(parsedValue), id) || id != term.symbol->id)
+        {
+            return false;
+        }
+        value = static_cast<int>(parsedValue);
+        return true;
+    }
+    
+    bool Theory::evaluateIntComparison(const PredicateFormula& f, bool& value)
+    {
+        int left, right;
+        auto& symbols = registry().intTheorySymbols;
+        if (symbols == nullptr || f.subterms.size() != 2 ||
+            !isIntConstant(*f.subterms[0], left) || !isIntConstant(*f.subterms[1], right))
+        {
+            return false;
+        }
+        
+        auto id = f.symbol->id;
+        if (id == symbols->less)
+        {
+            value = left < right;
+        }
+        else if (id == symbols->lessEqual)
+        {
+            value = left <= right;
+        }
+        else if (id == symbols->greater)
+        {
+            value = left > right;
+        }
+        else if (id == symbols->greaterEqual)
+        {
+            value = left >= right;
+        }
+        else
+        {
+            return false;
+        }
+        return true;
     }
     
     std::shared_ptr<const Formula> Theory::natSub(std::shared_ptr<const Term> t1, std::shared_ptr<const Term> t2, std::string label)
@@ -2,7 +2,9 @@
 #define __Theory__
 
 #include <memory>
+#include <shared_mutex>
 #include <string>
+#include <unordered_map>
 
 #include "Term.hpp"
 #include "Formula.hpp"
@@ -32,6 +34,51 @@ namespace logic {
         static std::shared_ptr<const FuncTerm> natSucc(std::shared_ptr<const Term> term);
         static std::shared_ptr<const FuncTerm> natPre(std::shared_ptr<const Term> term);
         static std::shared_ptr<const Formula> natSub(std::shared_ptr<const Term> t1, std::shared_ptr<const Term> t2, std::string label="");
+        
+        // returns true iff term was constructed using intConstant, in which case its value is stored in value
+        static bool isIntConstant(const Term& term, int& value);
+        // returns true iff f is a comparison (<, <=, >, >=) of two integer constants, in which case its truth value is stored in value
+        static bool evaluateIntComparison(const PredicateFormula& f, bool& value);
+        
+    private:
+        friend class Context;
+        
+
+        // ids of the theory symbols, so that they can be fetched without hashing their names.
+        // the symbols of a theory are added to the signature on the first use of the theory,
+        // so that unused theories don't show up in the output.
+        // the lazy initialization is not synchronized, so declareTheories() needs to be called before the theories are used concurrently.
+        struct IntTheorySymbols
+        {
+            unsigned addition, subtraction, modulo, multiplication, absolute;
+            unsigned less, lessEqual, greater, greaterEqual;
+            unsigned boolTrue, boolFalse;
+        };
+        struct NatTheorySymbols
+        {
+            unsigned zero, succ, pre;
+        };
+        static const IntTheorySymbols& intTheorySymbols();
+        static const NatTheorySymbols& natTheorySymbols();
+        
+        // the ids refer to the symbols of a single logic::Context, so each context owns its own registry.
+        // all methods operate on the registry of the context of the calling thread.
+        // the registry of an overlay (cf. logic::Context) shares the theory symbols declared in its base,
+        // and looks up integer constants in its base as well, which is read without locking (since it is frozen).
+        struct Registry
+        {
+            Registry(const Context* base);
+            
+            const Context* const base;
+            std::shared_ptr<const IntTheorySymbols> intTheorySymbols;
+            std::shared_ptr<const NatTheorySymbols> natTheorySymbols;
+            std::shared_timed_mutex intConstantsMutex;
+            std::unordered_map<int, unsigned> intConstants;
+        };
+        static Registry& registry();
+        
+        // the id of the symbol of the integer constant i, returns false if the constant wasn't constructed yet
+        static bool intConstantId(Registry& registry, int i, unsigned& id);
     };
     
 }
@@ -1,60 +1,350 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
 #include <fstream>
+#include <functional>
 #include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
 #include <string>
+#include <utility>
+#include <vector>
 
-#include "logic/Theory.hpp"
-#include "logic/Problem.hpp"
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
-#include "program/Program.hpp"
+#include "logic/NodeStatistics.hpp"
 
 #include "util/Options.hpp"
 #include "util/Output.hpp"
+#include "util/Statistics.hpp"
+#include "util/ThreadPool.hpp"
 
-#include "parser/WhileParserWrapper.hpp"
-
-#include "analysis/Semantics.hpp"
-#include "analysis/TraceLemmas.hpp"
-#include "analysis/StaticAnalysis.hpp"
+#include "spectre/Encoder.hpp"
+#include "spectre/Prover.hpp"
+#include "spectre/Server.hpp"
 
 void outputUsage()
 {
-    std::cout << "Usage: spectre <filename>" << std::endl;
+    std::cout << "Usage: spectre <filename, or - to read from stdin>" << std::endl;
+    std::cout << "       spectre -batch <directory or file listing one spec per line> [-j <number of specs encoded concurrently>]" << std::endl;
+    std::cout << "       spectre -serve <stdin or path of a unix domain socket>" << std::endl;
+    std::cout << "       spectre -prover <prover command> [-results <directory caching the prover results>] <filename>" << std::endl;
 }
 
-int main(int argc, char *argv[])
+// encodes the problem in inputFile and writes it into util::Output::stream().
+// returns false (after reporting the error on stderr) if inputFile can't be parsed.
+bool encode(const std::string& inputFile, spectre::Encoder& encoder)
+{
+    std::string errorMessage;
+    auto problem = encoder.encodeFile(inputFile, errorMessage);
+    if (problem == nullptr)
+    {
+        std::cerr << errorMessage << std::endl;
+        return false;
+    }
+    auto proverCommand = util::Configuration::instance().prover().getValue();
+    if (proverCommand.empty())
+    {
+        encoder.write(*problem, util::Output::stream());
+    }
+    else
+    {
+        std::string smtlib;
+        encoder.write(*problem, smtlib);
+        util::Output::stream() << smtlib;
+
+        // the result is reported on stderr, so that the output stays the same with and without a prover
+        spectre::Prover prover(proverCommand, util::Configuration::instance().results().getValue());
+        spectre::Prover::Result result;
+        std::ostringstream report;
+        if (prover.run(smtlib, result, errorMessage))
+        {
+            report << inputFile << ": " << result.status << " (" << result.seconds << "s" << (result.cached ? ", cached" : "") << ")\n";
+        }
+        else
+        {
+            report << inputFile << ": " << errorMessage << "\n";
+        }
+        // written at once, so that the reports of concurrently encoded specs don't interleave
+        std::cerr << report.str() << std::flush;
+    }
+    util::Statistics::output();
+    return true;
+}
+
+bool isDirectory(const std::string& path)
+{
+    struct stat info;
+    return stat(path.c_str(), &info) == 0 && S_ISDIR(info.st_mode);
+}
+
+bool hasSuffix(const std::string& string, const std::string& suffix)
+{
+    return string.size() >= suffix.size() && string.compare(string.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+// appends the paths (relative to directory) of all .spec-files in directory and its subdirectories to specs
+void collectSpecs(const std::string& directory, const std::string& relativePath, std::vector<std::string>& specs)
+{
+    auto path = relativePath.empty() ? directory : directory + "/" + relativePath;
+    DIR* dir = opendir(path.c_str());
+    if (dir == nullptr)
+    {
+        return;
+    }
+    std::vector<std::string> entries;
+    while (auto entry = readdir(dir))
+    {
+        std::string name = entry->d_name;
+        if (name != "." && name != "..")
+        {
+            entries.push_back(relativePath.empty() ? name : relativePath + "/" + name);
+        }
+    }
+    closedir(dir);
+
+    // sort, so that the order of the problems doesn't depend on the file system
+    std::sort(entries.begin(), entries.end());
+    for (const auto& entry : entries)
+    {
+        if (isDirectory(directory + "/" + entry))
+        {
+            collectSpecs(directory, entry, specs);
+        }
+        else if (hasSuffix(entry, ".spec"))
+        {
+            specs.push_back(entry);
+        }
+    }
+}
+
+// returns the components of path, without the components "." and with each component ".." cancelling the preceding component (if there is one).
+// if dropParents is set, the components ".." which can't be cancelled are dropped as well
+std::vector<std::string> normalizedComponents(const std::string& path, bool dropParents)
+{
+    std::vector<std::string> components;
+    size_t start = 0;
+    while (start <= path.size())
+    {
+        auto end = path.find('/', start);
+        if (end == std::string::npos)
+        {
+            end = path.size();
+        }
+        auto component = path.substr(start, end - start);
+        if (component == "..")
+        {
+            if (!components.empty() && components.back() != "..")
+            {
+                components.pop_back();
+            }
+            else if (!dropParents && path[0] != '/')
+            {
+                components.push_back(component);
+            }
+        }
+        else if (!component.empty() && component != ".")
+        {
+            components.push_back(component);
+        }
+        start = end + 1;
+    }
+    return components;
+}
+
+std::string joinComponents(const std::vector<std::string>& components)
+{
+    std::string path;
+    for (const auto& component : components)
+    {
+        path += (path.empty() ? "" : "/") + component;
+    }
+    return path;
+}
+
+// returns path without the components "." and "..", so that two paths to the same file (ignoring links) are equal
+std::string normalizedPath(const std::string& path)
+{
+    return (!path.empty() && path[0] == '/' ? "/" : "") + joinComponents(normalizedComponents(path, false));
+}
+
+// returns path without its root and without the components "." and "..", so that it can be used as a path inside of the output-directory
+std::string relativeOutputPath(const std::string& path)
+{
+    return joinComponents(normalizedComponents(path, true));
+}
+
+// encodes each spec listed in batch (either a directory, which is searched recursively for .spec-files, or a file containing one path per line).
+// the encoding of a spec is written into the output-directory (or, if no output is set, next to the spec), with extension .smt2 instead of .spec.
+// the output-directory mirrors the subdirectories of batch (if batch is a directory) or the directories of the listed paths (if batch is a file).
+// specs which would be encoded into the same output file are rejected before any spec is encoded.
+// -j specs are encoded concurrently.
+bool encodeBatch(const std::string& batch)
+{
+    // pairs of input file and output file relative to the output-directory
+    std::vector<std::pair<std::string, std::string>> problems;
+    if (isDirectory(batch))
+    {
+        std::vector<std::string> specs;
+        collectSpecs(batch, "", specs);
+        for (const auto& spec : specs)
+        {
+            problems.push_back(std::make_pair(batch + "/" + spec, spec));
+        }
+    }
+    else
+    {
+        std::ifstream list(batch);
+        if (!list)
+        {
+            std::cerr << "Unable to read file " << batch << std::endl;
+            return false;
+        }
+        std::string line;
+        while (std::getline(list, line))
+        {
+            if (!line.empty() && line[0] != '#')
+            {
+                problems.push_back(std::make_pair(line, relativeOutputPath(line)));
+            }
+        }
+    }
+
+    // start with the largest specs, so that the threads are not left waiting for a huge spec taken at the end
+    std::vector<std::pair<off_t, size_t>> sizes;
+    for (size_t i = 0; i < problems.size(); ++i)
+    {
+        struct stat info;
+        sizes.push_back(std::make_pair(stat(problems[i].first.c_str(), &info) == 0 ? info.st_size : 0, i));
+    }
+    std::stable_sort(sizes.begin(), sizes.end(), [](const std::pair<off_t, size_t>& a, const std::pair<off_t, size_t>& b) { return a.first > b.first; });
+
+    auto outputDirectory = util::Configuration::instance().outputFile().getValue();
+    std::vector<std::string> outputFiles;
+    std::map<std::string, std::string> outputFileToSpec;
+    for (const auto& problem : problems)
+    {
+        auto outputFile = (outputDirectory.empty() ? problem.first : outputDirectory + "/" + problem.second);
+        if (hasSuffix(outputFile, ".spec"))
+        {
+            outputFile.resize(outputFile.size() - 5);
+        }
+        outputFile += ".smt2";
+
+        // concurrent tasks writing (or removing) the same output file would overwrite each other's encodings
+        auto inserted = outputFileToSpec.insert(std::make_pair(normalizedPath(outputFile), problem.first));
+        if (!inserted.second)
+        {
+            std::cerr << "The specs " << inserted.first->second << " and " << problem.first << " would both be encoded into " << inserted.first->first << std::endl;
+            return false;
+        }
+        outputFiles.push_back(outputFile);
+    }
+
+    // each spec is encoded in its own logic::Context, with its own output, so the specs can be encoded concurrently.
+    // the specs are distributed over -j threads, which steal specs from each other if they run out of work.
+    // the encoders are reused across specs, so that the theories are declared and the -threads workers are started once per encoder
+    // instead of once per spec. a task takes an idle encoder (or creates one if all are busy), so at most -j encoders are created.
+    std::atomic<bool> success(true);
+    std::mutex encodersMutex;
+    std::vector<std::unique_ptr<spectre::Encoder>> idleEncoders;
+    std::vector<std::function<void()>> tasks;
+    for (const auto& size : sizes)
+    {
+        const auto& problem = problems[size.second];
+        const auto& outputFile = outputFiles[size.second];
+        tasks.push_back([&problem, &outputFile, &success, &encodersMutex, &idleEncoders]{
+            // create the subdirectories of the output file
+            for (auto separator = outputFile.find('/', 1); separator != std::string::npos; separator = outputFile.find('/', separator + 1))
+            {
+                mkdir(outputFile.substr(0, separator).c_str(), 0777);
+            }
+
+            if (!util::Output::initialize(outputFile))
+            {
+                success = false;
+                return;
+            }
+            std::unique_ptr<spectre::Encoder> encoder;
+            {
+                std::lock_guard<std::mutex> lock(encodersMutex);
+                if (!idleEncoders.empty())
+                {
+                    encoder = std::move(idleEncoders.back());
+                    idleEncoders.pop_back();
+                }
+            }
+            if (encoder == nullptr)
+            {
+                encoder.reset(new spectre::Encoder(spectre::Encoder::Options::fromConfiguration()));
+            }
+            auto encoded = encode(problem.first, *encoder);
+            {
+                std::lock_guard<std::mutex> lock(encodersMutex);
+                idleEncoders.push_back(std::move(encoder));
+            }
+            util::Output::close();
+            util::Statistics::reset();
+            if (!encoded)
+            {
+                // don't leave a partial encoding behind
+                std::remove(outputFile.c_str());
+                success = false;
+            }
+        });
+    }
+    util::ThreadPool batchPool(util::Configuration::instance().jobs().getValue());
+    batchPool.run(std::move(tasks));
+    return success;
+}
+
+// runs spectre in the mode selected by the command line and returns the exit code
+int run(int argc, char *argv[])
 {
     if (argc <= 1)
     {
         outputUsage();
+        return 0;
     }
     else
     {
         if (util::Configuration::instance().setAllValues(argc, argv))
         {
+            auto batch = util::Configuration::instance().batch().getValue();
+            if (!batch.empty())
+            {
+                return encodeBatch(batch) ? 0 : 1;
+            }
+            auto serve = util::Configuration::instance().serve().getValue();
+            if (!serve.empty())
+            {
+                spectre::Encoder encoder(spectre::Encoder::Options::fromConfiguration());
+                spectre::Server server(encoder);
+                return (serve == "stdin" ? server.serve(STDIN_FILENO, STDOUT_FILENO) : server.serveSocket(serve)) ? 0 : 1;
+            }
             if (util::Output::initialize())
             {
                 std::string inputFile = argv[argc - 1];
-                
-                auto parserResult = parser::parse(inputFile);
-                
-                logic::Problem problem;
-                analysis::Semantics s(*parserResult.program, parserResult.locationToActiveVars, parserResult.twoTraces);
-                
-                problem.axioms = s.generateSemantics();
-                problem.conjecture = std::move(parserResult.conjecture);
-                
-                analysis::TraceLemmas traceLemmas(*parserResult.program, parserResult.locationToActiveVars, parserResult.twoTraces);
-                problem.lemmas = traceLemmas.generate();
-
-                analysis::StaticAnalysis staticAnalysis(*parserResult.program, parserResult.locationToActiveVars, parserResult.twoTraces);
-                // hack to work static analysis lemmas into output for now
-                // we should decide if we want to add them to the 'normal' lemmas
-                auto staticAnalysisLemmas = staticAnalysis.generateStaticAnalysisLemmas();
-                problem.lemmas.insert(problem.lemmas.end(),staticAnalysisLemmas.begin(),staticAnalysisLemmas.end());
-                
-                problem.outputSMTLIB(util::Output::stream());
+                spectre::Encoder encoder(spectre::Encoder::Options::fromConfiguration());
+                auto encoded = encode(inputFile, encoder);
+                util::Output::close();
+                return encoded ? 0 : 1;
             }
         }
         return 0;
     }
 }
+
+int main(int argc, char *argv[])
+{
+    auto exitCode = run(argc, argv);
+#ifdef SPECTRE_NODE_STATISTICS
+    // the counters are shared by all problems of the run (e.g. all specs of -batch), so they are reported once, at exit
+    logic::NodeStatistics::output(std::cerr);
+#endif
+    return exitCode;
+}
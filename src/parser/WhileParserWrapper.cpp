@@ -0,0 +1,156 @@
+#include "WhileParserWrapper.hpp"
+
+#include <climits>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include <cassert>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "WhileParser.hpp"
+#include "WhileParsingContext.hpp"
+#include "WhileScanner.hpp"
+
+namespace parser
+{
+    namespace
+    {
+        // parses the input of scanner and destroys scanner afterwards
+        std::unique_ptr<WhileParserResult> parseAndDestroy(yyscan_t scanner, const std::string& inputName, std::string& errorMessage)
+        {
+            // generate a context, whose fields are used as in/out-parameters for parsing
+            parser::WhileParsingContext context;
+            context.inputFile = inputName;
+            
+            // parse the input-program into context
+            parser::WhileParser parser(context, scanner);
+            parser.set_debug_level(false);
+            auto failed = parser.parse() != 0;
+            yylex_destroy(scanner);
+            
+            if (failed || context.errorFlag)
+            {
+                errorMessage = inputName + ": " + (context.errorFlag ? context.errorMessage : "Error while parsing");
+                return nullptr;
+            }
+            
+            assert(context.program);
+            assert(context.conjecture);
+            
+            return std::unique_ptr<WhileParserResult>(new WhileParserResult(std::move(context.program), std::move(context.locationToActiveVars), std::move(context.conjecture), context.twoTraces, std::move(context.programSignature)));
+        }
+        
+        // parses buffer in place. flex requires the last two bytes of the buffer to be 0 (they are not part of the input),
+        // and temporarily writes into the buffer while scanning.
+        std::unique_ptr<WhileParserResult> parseInPlace(char* buffer, size_t size, const std::string& inputName, std::string& errorMessage)
+        {
+            assert(size >= 2 && buffer[size - 2] == 0 && buffer[size - 1] == 0);
+            yyscan_t scanner;
+            yylex_init(&scanner);
+            yyset_debug(0, scanner);
+            yy_scan_buffer(buffer, size, scanner);
+            return parseAndDestroy(scanner, inputName, errorMessage);
+        }
+        
+        // reads everything from fd into buffer, followed by the two 0-bytes required by flex
+        bool readAll(int fd, std::vector<char>& buffer)
+        {
+            size_t size = 0;
+            buffer.resize(64 * 1024);
+            while (true)
+            {
+                auto numberOfBytes = read(fd, buffer.data() + size, buffer.size() - size);
+                if (numberOfBytes < 0)
+                {
+                    return false;
+                }
+                if (numberOfBytes == 0)
+                {
+                    break;
+                }
+                size += static_cast<size_t>(numberOfBytes);
+                if (size == buffer.size())
+                {
+                    buffer.resize(2 * buffer.size());
+                }
+            }
+            buffer.resize(size + 2);
+            buffer[size] = buffer[size + 1] = 0;
+            return true;
+        }
+    }
+    
+    std::unique_ptr<WhileParserResult> parse(const std::string& inputFile, std::string& errorMessage)
+    {
+        std::vector<char> buffer;
+        if (inputFile == "-")
+        {
+            if (!readAll(STDIN_FILENO, buffer))
+            {
+                errorMessage = "Unable to read stdin";
+                return nullptr;
+            }
+            return parseInPlace(buffer.data(), buffer.size(), "stdin", errorMessage);
+        }
+        
+        int fd = open(inputFile.c_str(), O_RDONLY);
+        struct stat info;
+        if (fd == -1 || fstat(fd, &info) != 0)
+        {
+            if (fd != -1)
+            {
+                close(fd);
+            }
+            errorMessage = "Unable to read file " + inputFile;
+            return nullptr;
+        }
+        
+        // the remainder of the last page of a mapping is filled with 0-bytes, so if the file leaves at least two bytes of its last page unused,
+        // the mapping already ends with the two 0-bytes required by flex, and the file can be scanned in place without copying it.
+        // the mapping is private, so the writes of the scanner don't reach the file.
+        auto size = static_cast<size_t>(info.st_size);
+        auto pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        if (S_ISREG(info.st_mode) && size % pageSize != 0 && size % pageSize <= pageSize - 2)
+        {
+            void* memory = mmap(nullptr, size + 2, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+            if (memory != MAP_FAILED)
+            {
+                close(fd);
+                auto result = parseInPlace(static_cast<char*>(memory), size + 2, inputFile, errorMessage);
+                munmap(memory, size + 2);
+                return result;
+            }
+        }
+        
+        // otherwise read the file into a buffer
+        auto success = readAll(fd, buffer);
+        close(fd);
+        if (!success)
+        {
+            errorMessage = "Unable to read file " + inputFile;
+            return nullptr;
+        }
+        return parseInPlace(buffer.data(), buffer.size(), inputFile, errorMessage);
+    }
+    
+    std::unique_ptr<WhileParserResult> parse(const char* input, size_t size, const std::string& inputName, std::string& errorMessage)
+    {
+        if (size > INT_MAX)
+        {
+            errorMessage = inputName + ": input too large";
+            return nullptr;
+        }
+        // the scanner needs a writable buffer, so the input is copied
+        yyscan_t scanner;
+        yylex_init(&scanner);
+        yyset_debug(0, scanner);
+        yy_scan_bytes(input, static_cast<int>(size), scanner);
+        return parseAndDestroy(scanner, inputName, errorMessage);
+    }
+}
@@ -1,20 +1,16 @@
 #ifndef __WhileParserWrapper__
 #define __WhileParserWrapper__
 
-#include <fstream>
-#include <iostream>
+#include <cstddef>
 #include <memory>
 #include <string>
 #include <unordered_map>
 #include <utility>
 #include <vector>
-#include <cassert>
-
-#include "WhileParsingContext.hpp"
-#include "WhileScanner.cpp"
-#include "WhileParser.hpp"
 
+#include "Formula.hpp"
 #include "Program.hpp"
+#include "Variable.hpp"
 
 namespace parser
 {
@@ -27,62 +23,28 @@ namespace parser
         WhileParserResult(std::unique_ptr<const program::Program> program,
                           std::unordered_map<std::string, std::vector<std::shared_ptr<const program::Variable>>> locationToActiveVars,
                           std::shared_ptr<const logic::Formula> conjecture,
-                          bool twoTraces) : program(std::move(program)), locationToActiveVars(locationToActiveVars), conjecture(conjecture), twoTraces(twoTraces) {}
+                          bool twoTraces,
+                          std::vector<std::shared_ptr<const logic::Symbol>> programSignature) : program(std::move(program)), locationToActiveVars(locationToActiveVars), conjecture(conjecture), twoTraces(twoTraces), programSignature(std::move(programSignature)) {}
         
         std::unique_ptr<const program::Program> program;
         std::unordered_map<std::string, std::vector<std::shared_ptr<const program::Variable>>> locationToActiveVars;
         std::shared_ptr<const logic::Formula> conjecture;
         bool twoTraces;
+        // the symbols declared while parsing the program, i.e. the signature before the conjecture was parsed (ordered by name)
+        std::vector<std::shared_ptr<const logic::Symbol>> programSignature;
         ;
     };
     
     /*
      * main method for parsing input. Internally calls the parser autogenerated by Flex and Bison.
+     * The scanner and the parser are reentrant, so several threads can parse concurrently
+     * (the symbols are declared in the logic::Context of the calling thread).
+     * If the input can't be read or contains an error, a description of the error is stored in errorMessage and nullptr is returned.
      */
-    WhileParserResult parse(std::string inputFile)
-    {
-        // test readbility, easier than catching exception thrown by parser
-        std::ifstream istr(inputFile);
-        if (!istr)
-        {
-            std::cerr << "Unable to read file " << inputFile << std::endl;
-            exit(1);
-        }
-        
-        yy_flex_debug = false;
-        
-        // set parser input to inputFile
-        FILE* f = fopen(inputFile.c_str(), "r");
-        yy_buffer_state*bp = yy_create_buffer(f, YY_BUF_SIZE );
-        yy_create_buffer(f,YY_BUF_SIZE);
-        yy_switch_to_buffer(bp);
-        
-        // generate a context, whose fields are used as in/out-parameters for parsing
-        parser::WhileParsingContext context;
-        context.inputFile = inputFile;
-        
-        // parse the input-program into context
-        parser::WhileParser parser(context);
-        parser.set_debug_level(false);
-        parser.parse();
-        fclose(f);
-        
-        // if there was an error during parsing, exit the program.
-        if (context.errorFlag)
-        {
-            exit(1);
-        }
-        
-        assert(context.program);
-        assert(context.conjecture);
-        
-        util::Output::stream() << util::Output::comment;
-        util::Output::stream() << *context.program;
-        util::Output::stream() << util::Output::nocomment;
-        
-        return WhileParserResult(std::move(context.program), std::move(context.locationToActiveVars), std::move(context.conjecture), context.twoTraces);
-    }
+    // parses the file inputFile, or stdin if inputFile is "-". The file is memory-mapped and scanned in place whenever possible.
+    std::unique_ptr<WhileParserResult> parse(const std::string& inputFile, std::string& errorMessage);
+    // parses the size bytes at input. inputName is only used in error messages.
+    std::unique_ptr<WhileParserResult> parse(const char* input, size_t size, const std::string& inputName, std::string& errorMessage);
 }
 
 #endif
-
@@ -86,16 +86,8 @@ namespace parser
     
     std::shared_ptr<const program::Variable> WhileParsingContext::getProgramVar(std::string name)
     {
-        if (programVarsDeclarations.count(name) > 0)
-        {
-            return programVarsDeclarations[name];
-        }
-        else
-        {
-            std::cout << "program var " << name << " has not been declared!";
-            assert(false);
-            return nullptr;
-        }
+        auto it = programVarsDeclarations.find(name);
+        return (it != programVarsDeclarations.end()) ? it->second : nullptr;
     }
     
     std::vector<std::shared_ptr<const program::Variable>> WhileParsingContext::getActiveProgramVars()
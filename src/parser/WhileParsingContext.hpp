@@ -7,6 +7,7 @@
 #include <vector>
 
 #include "Formula.hpp"
+#include "Location.hpp"
 #include "Program.hpp"
 #include "Signature.hpp"
 #include "Variable.hpp"
@@ -21,17 +22,25 @@ namespace parser
     class WhileParsingContext
     {
     public:
-        WhileParsingContext() : inputFile(""), errorFlag(false), program(nullptr), conjecture(nullptr), locationToActiveVars(), twoTraces(false){}
+        WhileParsingContext() : inputFile(""), location(), errorFlag(false), errorMessage(""), program(nullptr), conjecture(nullptr), locationToActiveVars(), twoTraces(false), programSignature(){}
         
         // input
         std::string inputFile;
+        
+        // the location of the current token, maintained by the scanner
+        Location location;
+        
+        // set by the parser on the first error (parsing stops at the first error)
         bool errorFlag;
+        std::string errorMessage;
         
         // output
         std::unique_ptr<const program::Program> program;
         std::shared_ptr<const logic::Formula> conjecture;
         std::unordered_map<std::string, std::vector<std::shared_ptr<const program::Variable>>> locationToActiveVars;
         bool twoTraces;
+        // the signature after parsing the program, i.e. without the symbols introduced by the conjecture
+        std::vector<std::shared_ptr<const logic::Symbol>> programSignature;
         
     private:
         // context-information
@@ -51,6 +60,7 @@ namespace parser
         void pushProgramVars();
         void popProgramVars();
         bool addProgramVar(std::shared_ptr<const program::Variable> programVar);
+        // returns nullptr if no program variable with the given name is declared
         std::shared_ptr<const program::Variable> getProgramVar(std::string name);
         std::vector<std::shared_ptr<const program::Variable>> getActiveProgramVars();
         
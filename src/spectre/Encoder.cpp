@@ -0,0 +1,247 @@
+#include "Encoder.hpp"
+
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <utility>
+#include <cassert>
+
+#include "Context.hpp"
+#include "Files.hpp"
+#include "Formula.hpp"
+#include "LemmaFilter.hpp"
+#include "Options.hpp"
+#include "Sha256.hpp"
+#include "Signature.hpp"
+#include "Simplifier.hpp"
+#include "Sort.hpp"
+#include "Statistics.hpp"
+#include "Term.hpp"
+#include "Theory.hpp"
+
+#include "LemmaTasks.hpp"
+#include "Semantics.hpp"
+#include "StaticAnalysis.hpp"
+#include "TraceLemmas.hpp"
+
+namespace spectre {
+
+    namespace
+    {
+        // appends everything written into it to a string, so that the output doesn't need to be copied out of a stringstream
+        class StringAppendingStreambuf : public std::streambuf
+        {
+        public:
+            StringAppendingStreambuf(std::string& buffer) : buffer(buffer) {}
+
+        protected:
+            int overflow(int c) override
+            {
+                if (c != EOF)
+                {
+                    buffer.push_back(static_cast<char>(c));
+                }
+                return c;
+            }
+            std::streamsize xsputn(const char* s, std::streamsize n) override
+            {
+                buffer.append(s, static_cast<size_t>(n));
+                return n;
+            }
+
+        private:
+            std::string& buffer;
+        };
+
+        // version of the encoding, which needs to be increased whenever the output for a program changes, so that older cache entries are not used
+        const char* cacheVersion = "spectre-cache-3";
+    }
+
+    Encoder::Options Encoder::Options::fromConfiguration()
+    {
+        const auto& configuration = util::Configuration::instance();
+        auto sharing = configuration.sharing().getValue();
+        Options options;
+        options.sharing = sharing == "let" ? logic::SMTLIBWriter::Sharing::Let :
+                          sharing == "define-fun" ? logic::SMTLIBWriter::Sharing::DefineFun :
+                          logic::SMTLIBWriter::Sharing::None;
+        options.compact = configuration.compact().getValue();
+        options.labels = configuration.labels().getValue();
+        options.simplify = configuration.simplify().getValue();
+        options.filterLemmas = configuration.filterLemmas().getValue();
+        options.threads = configuration.threads().getValue();
+        options.cacheDirectory = configuration.cache().getValue();
+        return options;
+    }
+
+    std::string Encoder::cacheKey(const parser::WhileParserResult& parserResult)
+    {
+        // the program text doesn't include the declarations of the variables, but they are captured by the symbols declared for the program.
+        // the symbols introduced by the conjecture are not part of the key, so that specs only differing in their conjecture share the entry.
+        // the sorts are part of the key, since the conjecture may use sorts which don't occur in the program, which are declared in the prefix.
+        std::ostringstream description;
+        description << cacheVersion << "\n";
+        description << static_cast<int>(options.sharing) << options.compact << options.labels << options.simplify << options.filterLemmas << options.comments;
+        description << parserResult.twoTraces << "\n";
+        for (const auto& sort : logic::Sorts::nameToSort())
+        {
+            description << logic::declareSortSMTLIB(*sort);
+        }
+        for (const auto& symbol : parserResult.programSignature)
+        {
+            description << symbol->declareSymbolSMTLIB();
+        }
+        description << *parserResult.program;
+
+        util::Sha256 hash;
+        hash.update(description.str());
+        return hash.hexDigest();
+    }
+
+    Encoder::Encoder(const Options& options) :
+    options(options),
+    theories(new logic::Context()),
+    threadPool(options.threads)
+    {
+        // the parser declares the theories again for each problem, which then only finds them in the base
+        logic::Context::Scope scope(*theories);
+        logic::Theory::declareTheories();
+    }
+
+    std::unique_ptr<logic::Problem> Encoder::encode(const char* input, size_t size, const std::string& name, std::string& errorMessage)
+    {
+        return encode([&]{ return parser::parse(input, size, name, errorMessage); });
+    }
+
+    std::unique_ptr<logic::Problem> Encoder::encodeFile(const std::string& inputFile, std::string& errorMessage)
+    {
+        return encode([&]{ return parser::parse(inputFile, errorMessage); });
+    }
+
+    std::unique_ptr<logic::Problem> Encoder::encode(const std::function<std::unique_ptr<parser::WhileParserResult>()>& parse)
+    {
+        // the symbols of the input are declared while parsing, so the context of the problem is installed from the start
+        std::unique_ptr<logic::Context> context(new logic::Context(theories));
+        logic::Context::Scope scope(*context);
+        std::unique_ptr<util::Statistics::StageTimer> stageTimer(new util::Statistics::StageTimer("parse"));
+        auto parserResult = parse();
+        if (parserResult == nullptr)
+        {
+            return nullptr;
+        }
+
+        std::unique_ptr<logic::Problem> problem(new logic::Problem());
+        std::ostringstream comments;
+        if (options.comments)
+        {
+            comments << *parserResult->program;
+        }
+
+        // everything except the conjecture only depends on the program, so it can be taken from the cache.
+        // the definitions of define-fun depend on the conjecture, so they are never cached.
+        std::string cacheFile;
+        if (!options.cacheDirectory.empty() && options.sharing != logic::SMTLIBWriter::Sharing::DefineFun)
+        {
+            stageTimer.reset(new util::Statistics::StageTimer("cache"));
+            cacheFile = options.cacheDirectory + "/" + cacheKey(*parserResult) + ".smt2";
+            if (util::readFile(cacheFile, problem->prefix) && !problem->prefix.empty())
+            {
+                problem->conjecture = std::move(parserResult->conjecture);
+                if (options.simplify)
+                {
+                    stageTimer.reset(new util::Statistics::StageTimer("simplification"));
+                    logic::Simplifier simplifier(options.labels);
+                    simplifier.simplify(*problem);
+                }
+                stageTimer.reset();
+                parserResult.reset();
+                problem->context = std::move(context);
+                return problem;
+            }
+            problem->prefix.clear();
+        }
+
+        stageTimer.reset(new util::Statistics::StageTimer("semantics"));
+        analysis::Semantics s(*parserResult->program, parserResult->locationToActiveVars, parserResult->twoTraces);
+        problem->axioms = s.generateSemantics();
+        problem->conjecture = std::move(parserResult->conjecture);
+
+        stageTimer.reset(new util::Statistics::StageTimer("traceLemmas"));
+        analysis::TraceLemmas traceLemmas(*parserResult->program, parserResult->locationToActiveVars, parserResult->twoTraces);
+        problem->lemmas = analysis::runLemmaTasks(traceLemmas.generateTasks(), threadPool, &problem->lemmaFamilies);
+
+        stageTimer.reset(new util::Statistics::StageTimer("staticAnalysis"));
+        analysis::StaticAnalysis staticAnalysis(*parserResult->program, parserResult->locationToActiveVars, parserResult->twoTraces);
+        // hack to work static analysis lemmas into output for now
+        // we should decide if we want to add them to the 'normal' lemmas
+        auto staticAnalysisLemmas = analysis::runLemmaTasks(staticAnalysis.generateTasks(), threadPool, &problem->lemmaFamilies);
+        problem->lemmas.insert(problem->lemmas.end(), staticAnalysisLemmas.begin(), staticAnalysisLemmas.end());
+
+        if (options.simplify)
+        {
+            stageTimer.reset(new util::Statistics::StageTimer("simplification"));
+            logic::Simplifier simplifier(options.labels);
+            simplifier.simplify(*problem);
+        }
+        if (options.filterLemmas)
+        {
+            stageTimer.reset(new util::Statistics::StageTimer("lemmaFilter"));
+            auto numberOfLemmas = problem->lemmas.size();
+            logic::LemmaFilter lemmaFilter;
+            lemmaFilter.filter(*problem);
+            if (options.comments)
+            {
+                comments << "Dropped " << (lemmaFilter.numberOfDuplicates + lemmaFilter.numberOfSubsumed) << " of " << numberOfLemmas << " lemmas (";
+                comments << lemmaFilter.numberOfDuplicates << " duplicates, " << lemmaFilter.numberOfSubsumed << " subsumed)\n";
+            }
+        }
+        problem->comments = comments.str();
+
+        if (!cacheFile.empty())
+        {
+            stageTimer.reset(new util::Statistics::StageTimer("cache"));
+            std::string prefix;
+            StringAppendingStreambuf streambuf(prefix);
+            std::ostream ostr(&streambuf);
+            problem->outputSMTLIB(ostr, threadPool, options.sharing, options.compact, options.labels, false);
+            // a failure to write the cache only costs time in later runs
+            util::writeFileAtomically(cacheFile, prefix);
+            problem->prefix = std::move(prefix);
+        }
+        stageTimer.reset();
+
+        // the program is destroyed before the context, since the context caches symbols of program objects (cf. SymbolDeclarations)
+        parserResult.reset();
+        problem->context = std::move(context);
+        return problem;
+    }
+
+    void Encoder::write(logic::Problem& problem, std::ostream& ostr)
+    {
+        assert(problem.context != nullptr);
+        logic::Context::Scope scope(*problem.context);
+        {
+            util::Statistics::StageTimer stageTimer("output");
+            problem.outputSMTLIB(ostr, threadPool, options.sharing, options.compact, options.labels);
+        }
+
+        if (util::Statistics::enabled())
+        {
+            util::Statistics::setCounter("terms", logic::Terms::numberOfTerms());
+            util::Statistics::setCounter("formulas", logic::Formulas::numberOfFormulas());
+            util::Statistics::setCounter("symbols", logic::Signature::signature().size());
+            util::Statistics::setCounter("axioms", problem.axioms.size());
+            util::Statistics::setCounter("lemmas", problem.lemmas.size());
+        }
+    }
+
+    void Encoder::write(logic::Problem& problem, std::string& buffer)
+    {
+        StringAppendingStreambuf streambuf(buffer);
+        std::ostream ostr(&streambuf);
+        write(problem, ostr);
+    }
+}
@@ -0,0 +1,88 @@
+#ifndef __Encoder__
+#define __Encoder__
+
+#include <cstddef>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "Context.hpp"
+#include "Problem.hpp"
+#include "SMTLIBWriter.hpp"
+#include "ThreadPool.hpp"
+#include "WhileParserWrapper.hpp"
+
+namespace spectre {
+
+    /*
+     * Entry point of libspectre: encodes programs together with their properties (in the syntax of .spec-files)
+     * into first-order problems, within the calling process.
+     * The theories are declared once, in a base context owned by the encoder. Each problem owns an overlay of the base
+     * (cf. logic::Context) containing its own symbols, terms and formulas, so problems are independent of each other,
+     * everything constructed for a problem is freed together with the problem, and the theory symbols and terms are
+     * shared by all problems of the encoder. Besides the base, the encoder holds its options and the threads used for
+     * generating and writing problems.
+     * An encoder must only be used by one thread at a time; several encoders can be used concurrently.
+     */
+    class Encoder
+    {
+    public:
+        struct Options
+        {
+            Options() :
+            sharing(logic::SMTLIBWriter::Sharing::None),
+            compact(false),
+            labels(true),
+            simplify(true),
+            filterLemmas(true),
+            threads(1),
+            comments(true),
+            cacheDirectory()
+            {}
+
+            // cf. the corresponding command line options in util::Configuration
+            logic::SMTLIBWriter::Sharing sharing;
+            bool compact;
+            bool labels;
+            bool simplify;
+            bool filterLemmas;
+            unsigned threads;
+            // start the output with the program and the number of filtered lemmas as smtlib-comments (cf. logic::Problem::comments)
+            bool comments;
+            // if not empty, the output except the conjecture is cached in this directory, keyed by a hash of the program and the options.
+            // specs which only differ in their conjecture are then only parsed, and take the rest of their output from the cache.
+            std::string cacheDirectory;
+
+            // the options given on the command line
+            static Options fromConfiguration();
+        };
+
+        explicit Encoder(const Options& options = Options());
+        Encoder(const Encoder&) = delete;
+        Encoder& operator=(const Encoder&) = delete;
+
+        // encode the program and property given as text (name is only used in error messages), or in a file (or stdin if inputFile is "-").
+        // if the input can't be parsed, a description of the error is stored in errorMessage and nullptr is returned.
+        std::unique_ptr<logic::Problem> encode(const char* input, size_t size, const std::string& name, std::string& errorMessage);
+        std::unique_ptr<logic::Problem> encode(const std::string& input, std::string& errorMessage) { return encode(input.data(), input.size(), "input", errorMessage); }
+        std::unique_ptr<logic::Problem> encodeFile(const std::string& inputFile, std::string& errorMessage);
+
+        // write the smtlib-encoding of problem into ostr, or append it to buffer
+        void write(logic::Problem& problem, std::ostream& ostr);
+        void write(logic::Problem& problem, std::string& buffer);
+
+    private:
+        const Options options;
+        // the base of the contexts of all problems, containing the theories (kept alive by the problems as well)
+        const std::shared_ptr<logic::Context> theories;
+        util::ThreadPool threadPool;
+
+        // the name of the cache entry of the parsed program (cf. Options::cacheDirectory)
+        std::string cacheKey(const parser::WhileParserResult& parserResult);
+        // parses the input using parse and generates the problem
+        std::unique_ptr<logic::Problem> encode(const std::function<std::unique_ptr<parser::WhileParserResult>()>& parse);
+    };
+}
+
+#endif
@@ -0,0 +1,170 @@
+#include "Prover.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "Files.hpp"
+#include "Sha256.hpp"
+
+namespace spectre {
+
+    namespace
+    {
+        // quotes argument for the shell, so that it is passed as a single word whatever characters it contains
+        std::string shellQuoted(const std::string& argument)
+        {
+            std::string quoted = "'";
+            for (auto c : argument)
+            {
+                if (c == '\'')
+                {
+                    quoted += "'\\''";
+                }
+                else
+                {
+                    quoted += c;
+                }
+            }
+            return quoted + "'";
+        }
+    }
+
+    bool Prover::run(const std::string& problem, Result& result, std::string& errorMessage)
+    {
+        std::string cacheFile;
+        if (!cacheDirectory.empty())
+        {
+            util::Sha256 hash;
+            hash.update(command);
+            hash.update("\n", 1);
+            hash.update(problem);
+            cacheFile = cacheDirectory + "/" + hash.hexDigest();
+
+            std::string entry;
+            if (util::readFile(cacheFile, entry))
+            {
+                std::istringstream istr(entry);
+                if (istr >> result.status >> result.seconds)
+                {
+                    result.cached = true;
+                    return true;
+                }
+            }
+        }
+
+        // the prover gets the problem as a file, since most provers don't read problems from stdin
+        const char* temporaryDirectory = std::getenv("TMPDIR");
+        std::string pattern = std::string(temporaryDirectory != nullptr ? temporaryDirectory : "/tmp") + "/spectre_XXXXXX.smt2";
+        std::vector<char> path(pattern.begin(), pattern.end());
+        path.push_back(0);
+        int fd = mkstemps(path.data(), 5);
+        if (fd == -1)
+        {
+            errorMessage = "Unable to create temporary file " + pattern;
+            return false;
+        }
+        close(fd);
+        {
+            std::ofstream file(path.data(), std::ios::binary);
+            file << problem;
+            if (!file.flush())
+            {
+                std::remove(path.data());
+                errorMessage = "Unable to write temporary file " + std::string(path.data());
+                return false;
+            }
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        FILE* pipe = popen((command + " " + shellQuoted(path.data())).c_str(), "r");
+        if (pipe == nullptr)
+        {
+            std::remove(path.data());
+            errorMessage = "Unable to run " + command;
+            return false;
+        }
+        std::string output;
+        char buffer[4096];
+        size_t numberOfBytes;
+        while ((numberOfBytes = fread(buffer, 1, sizeof(buffer), pipe)) > 0)
+        {
+            output.append(buffer, numberOfBytes);
+        }
+        int exitStatus = pclose(pipe);
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::remove(path.data());
+
+        // a prover which crashed or didn't report a status yields no result, and nothing is cached, so that it is retried by the next run
+        if (exitStatus == -1 || !WIFEXITED(exitStatus))
+        {
+            errorMessage = command + (exitStatus != -1 && WIFSIGNALED(exitStatus) ? " was killed by signal " + std::to_string(WTERMSIG(exitStatus)) : " didn't terminate normally");
+            return false;
+        }
+        // the command runs in a shell, which reports a prover killed by signal N by exiting with status 128+N
+        if (WEXITSTATUS(exitStatus) > 128)
+        {
+            errorMessage = command + " was killed by signal " + std::to_string(WEXITSTATUS(exitStatus) - 128);
+            return false;
+        }
+        result.status = statusOf(output);
+        result.cached = false;
+        if (result.status.empty())
+        {
+            errorMessage = command + " exited with status " + std::to_string(WEXITSTATUS(exitStatus)) + " without reporting a result";
+            return false;
+        }
+        if (!cacheFile.empty())
+        {
+            std::ostringstream entry;
+            entry << result.status << " " << result.seconds << "\n";
+            util::writeFileAtomically(cacheFile, entry.str());
+        }
+        return true;
+    }
+
+    std::string Prover::statusOf(const std::string& output)
+    {
+        std::istringstream istr(output);
+        std::string line;
+        while (std::getline(istr, line))
+        {
+            if (line == "sat" || line == "unsat" || line == "timeout" || line == "unknown")
+            {
+                return line;
+            }
+            auto position = line.find("SZS status ");
+            if (position != std::string::npos)
+            {
+                std::istringstream words(line.substr(position + 11));
+                std::string status;
+                words >> status;
+                // the conjecture is negated in the problem, so a refutation (unsat) proves the property
+                if (status == "Unsatisfiable" || status == "Theorem" || status == "ContradictoryAxioms")
+                {
+                    return "unsat";
+                }
+                if (status == "Satisfiable" || status == "CounterSatisfiable")
+                {
+                    return "sat";
+                }
+                if (status == "Timeout")
+                {
+                    return "timeout";
+                }
+                if (status == "GaveUp" || status == "Unknown")
+                {
+                    return "unknown";
+                }
+            }
+        }
+        return "";
+    }
+}
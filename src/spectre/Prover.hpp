@@ -0,0 +1,45 @@
+#ifndef __Prover__
+#define __Prover__
+
+#include <string>
+#include <utility>
+
+namespace spectre {
+
+    /*
+     * Runs an external prover (e.g. Vampire) on encoded problems, optionally caching the results on disk.
+     * The cache is keyed by the hash of the problem and of the prover command, so an unchanged problem is not solved again
+     * as long as the prover and its options (e.g. the time limit) stay the same. This relies on the output of spectre
+     * being byte-identical for unchanged specs (cf. logic::Problem::outputSMTLIB).
+     */
+    class Prover
+    {
+    public:
+        // the path of the problem is appended to command, which is run by the shell.
+        // if cacheDirectory is empty, no results are cached.
+        Prover(std::string command, std::string cacheDirectory) : command(std::move(command)), cacheDirectory(std::move(cacheDirectory)) {}
+
+        struct Result
+        {
+            // one of sat, unsat, timeout or unknown, as reported by the prover
+            std::string status;
+            // the wall-clock time the prover needed, also for results taken from the cache
+            double seconds;
+            bool cached;
+        };
+
+        // returns false (with a description of the error in errorMessage) if the prover can't be run, doesn't exit normally or doesn't report a result.
+        // only results of provers which exited normally are cached
+        bool run(const std::string& problem, Result& result, std::string& errorMessage);
+
+    private:
+        const std::string command;
+        const std::string cacheDirectory;
+
+        // the status reported in the output of the prover, either as a line consisting of the status (as in the smtlib-standard),
+        // or as an SZS status (as reported by Vampire and other TPTP-provers). returns the empty string if no status is reported
+        static std::string statusOf(const std::string& output);
+    };
+}
+
+#endif
@@ -0,0 +1,197 @@
+#include "Server.hpp"
+
+#include <cerrno>
+#include <csignal>
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "Statistics.hpp"
+
+namespace spectre {
+
+    namespace
+    {
+        // reads exactly size bytes, returns false on end of input or error
+        bool readBytes(int fd, char* buffer, size_t size)
+        {
+            while (size > 0)
+            {
+                auto numberOfBytes = read(fd, buffer, size);
+                if (numberOfBytes < 0 && errno == EINTR)
+                {
+                    continue;
+                }
+                if (numberOfBytes <= 0)
+                {
+                    return false;
+                }
+                buffer += numberOfBytes;
+                size -= static_cast<size_t>(numberOfBytes);
+            }
+            return true;
+        }
+
+        bool writeBytes(int fd, const char* buffer, size_t size)
+        {
+            while (size > 0)
+            {
+                auto numberOfBytes = write(fd, buffer, size);
+                if (numberOfBytes < 0 && errno == EINTR)
+                {
+                    continue;
+                }
+                if (numberOfBytes <= 0)
+                {
+                    return false;
+                }
+                buffer += numberOfBytes;
+                size -= static_cast<size_t>(numberOfBytes);
+            }
+            return true;
+        }
+
+        // the largest spec accepted, which protects the server against garbage lengths
+        const size_t maximalRequestSize = size_t(1) << 30;
+
+        enum class Header { Valid, EndOfInput, Malformed };
+
+        // reads the length of the next request
+        Header readHeader(int fd, size_t& size)
+        {
+            size = 0;
+            size_t numberOfDigits = 0;
+            while (true)
+            {
+                char c;
+                if (!readBytes(fd, &c, 1))
+                {
+                    return numberOfDigits == 0 ? Header::EndOfInput : Header::Malformed;
+                }
+                if (c == '\n' && numberOfDigits > 0)
+                {
+                    return Header::Valid;
+                }
+                if (c < '0' || c > '9' || size > maximalRequestSize)
+                {
+                    return Header::Malformed;
+                }
+                size = 10 * size + static_cast<size_t>(c - '0');
+                ++numberOfDigits;
+            }
+        }
+    }
+
+    bool Server::serve(int input, int output)
+    {
+        while (true)
+        {
+            size_t size;
+            auto header = readHeader(input, size);
+            if (header == Header::EndOfInput)
+            {
+                return true;
+            }
+            if (header == Header::Malformed || size > maximalRequestSize)
+            {
+                std::string message = "malformed request";
+                response = "error " + std::to_string(message.size()) + "\n" + message;
+                writeBytes(output, response.data(), response.size());
+                return false;
+            }
+            request.resize(size);
+            if (!readBytes(input, request.data(), size))
+            {
+                return false;
+            }
+
+            // the length is only known after the encoding has been written, so the status line is sent separately
+            std::string errorMessage;
+            response.clear();
+            auto problem = encoder.encode(request.data(), request.size(), "request", errorMessage);
+            std::string status;
+            if (problem != nullptr)
+            {
+                encoder.write(*problem, response);
+                problem.reset();
+                status = "ok " + std::to_string(response.size()) + "\n";
+            }
+            else
+            {
+                response = errorMessage;
+                status = "error " + std::to_string(response.size()) + "\n";
+            }
+            // each request gets its own statistics, which are not reported (the output is reserved for the responses)
+            util::Statistics::reset();
+
+            if (!writeBytes(output, status.data(), status.size()) || !writeBytes(output, response.data(), response.size()))
+            {
+                return false;
+            }
+        }
+    }
+
+    bool Server::serveSocket(const std::string& path)
+    {
+        sockaddr_un address;
+        std::memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        if (path.size() >= sizeof(address.sun_path))
+        {
+            std::cerr << "Socket path too long: " << path << std::endl;
+            return false;
+        }
+        std::strcpy(address.sun_path, path.c_str());
+
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd == -1)
+        {
+            std::cerr << "Unable to create socket: " << std::strerror(errno) << std::endl;
+            return false;
+        }
+        // replace the socket left behind by a previous server, but nothing else
+        struct stat existing;
+        if (lstat(path.c_str(), &existing) == 0)
+        {
+            if (!S_ISSOCK(existing.st_mode))
+            {
+                std::cerr << "Unable to listen on " << path << ": the file exists and is not a socket" << std::endl;
+                close(fd);
+                return false;
+            }
+            unlink(path.c_str());
+        }
+        if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(fd, 16) != 0)
+        {
+            std::cerr << "Unable to listen on " << path << ": " << std::strerror(errno) << std::endl;
+            close(fd);
+            return false;
+        }
+        // a client closing its connection early must not terminate the server
+        std::signal(SIGPIPE, SIG_IGN);
+
+        while (true)
+        {
+            int connection = accept(fd, nullptr, nullptr);
+            if (connection == -1)
+            {
+                if (errno == EINTR || errno == ECONNABORTED)
+                {
+                    continue;
+                }
+                std::cerr << "Unable to accept connections on " << path << ": " << std::strerror(errno) << std::endl;
+                close(fd);
+                return false;
+            }
+            serve(connection, connection);
+            close(connection);
+        }
+    }
+}
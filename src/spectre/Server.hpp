@@ -0,0 +1,43 @@
+#ifndef __Server__
+#define __Server__
+
+#include <string>
+#include <vector>
+
+#include "Encoder.hpp"
+
+namespace spectre {
+
+    /*
+     * Serves encoding requests in a long-running process (cf. the option -serve), so that clients which encode
+     * many specs (e.g. editors re-encoding on every change) don't pay for starting a process and for writing files.
+     * A request consists of the length of the spec in bytes (in decimal) followed by a newline and the spec itself.
+     * Each request is answered by either
+     *   ok <length>\n<smtlib-encoding of the spec>
+     * or
+     *   error <length>\n<error message>
+     * where <length> is the number of bytes following the newline.
+     * Each spec is encoded in its own logic::Context, so the symbols of a request are not visible to later requests.
+     */
+    class Server
+    {
+    public:
+        Server(Encoder& encoder) : encoder(encoder), request(), response() {}
+
+        // answers the requests read from the file descriptor input on the file descriptor output, until input is closed.
+        // returns false if a request is malformed or the connection fails.
+        bool serve(int input, int output);
+
+        // listens on a unix domain socket at path, and serves the connections one after the other.
+        // only returns (with false) if the socket fails.
+        bool serveSocket(const std::string& path);
+
+    private:
+        Encoder& encoder;
+        // the buffers are reused across requests
+        std::vector<char> request;
+        std::string response;
+    };
+}
+
+#endif
@@ -0,0 +1,52 @@
+#include "Arena.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+
+namespace util {
+
+    void* Arena::allocate(size_t size, size_t alignment)
+    {
+        // blocks are allocated with new[], so they are suitably aligned for any type without extended alignment
+        assert(alignment <= alignof(std::max_align_t));
+        offset = (offset + alignment - 1) / alignment * alignment;
+        if (blocks.empty() || offset + size > blockSize)
+        {
+            blocks.emplace_back(new char[std::max(blockSize, size)]);
+            offset = 0;
+        }
+        void* memory = blocks.back().get() + offset;
+        offset += size;
+        numberOfBytes += size;
+        return memory;
+    }
+
+    void Arena::destroyLast()
+    {
+        assert(!objects.empty());
+        auto object = objects.back();
+        objects.pop_back();
+        object.destroy(object.memory);
+
+        // the last object always lives in the last block
+        auto begin = blocks.back().get();
+        assert(begin <= static_cast<char*>(object.memory) && static_cast<char*>(object.memory) < begin + offset);
+        auto objectOffset = static_cast<size_t>(static_cast<char*>(object.memory) - begin);
+        numberOfBytes -= offset - objectOffset;
+        offset = objectOffset;
+    }
+
+    void Arena::clear()
+    {
+        for (auto it = objects.rbegin(); it != objects.rend(); ++it)
+        {
+            it->destroy(it->memory);
+        }
+        objects.clear();
+        blocks.clear();
+        offset = 0;
+        numberOfBytes = 0;
+    }
+}
@@ -0,0 +1,75 @@
+#ifndef __Arena__
+#define __Arena__
+
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace util {
+
+    /*
+     * An arena owns objects of arbitrary types, which are allocated by bumping a pointer in large blocks,
+     * and destroyed (in reverse order of their construction) when the arena is cleared or destroyed.
+     * The arena itself is not synchronized, callers need to guard it with a lock if it is used by several threads.
+     */
+    class Arena
+    {
+    public:
+        Arena(size_t blockSize = 64 * 1024) : blockSize(blockSize), blocks(), offset(0), objects(), numberOfBytes(0) {}
+        ~Arena() { clear(); }
+        Arena(const Arena&) = delete;
+        Arena& operator=(const Arena&) = delete;
+
+        // constructs an object of type T in the arena, by calling construct(memory), which needs to construct the object at memory (using placement new) and return it.
+        // (this allows the caller to use constructors which are only accessible to the caller)
+        template<class T, class Construct>
+        T* create(Construct construct)
+        {
+            void* memory = allocate(sizeof(T), alignof(T));
+            T* object = construct(memory);
+            assert(static_cast<void*>(object) == memory);
+            objects.push_back(Object{memory, &destroy<T>});
+            return object;
+        }
+
+        // destroys the object created last and releases its memory, so that it can be reused by the next object
+        void destroyLast();
+
+        // destroys all objects and releases all memory
+        void clear();
+
+        // the number of bytes used by the objects (excluding padding)
+        size_t size() const { return numberOfBytes; }
+
+    private:
+        struct Object
+        {
+            void* memory;
+            void (*destroy)(void*);
+        };
+
+        const size_t blockSize;
+        std::vector<std::unique_ptr<char[]>> blocks;
+        size_t offset; // offset of the first unused byte in the last block
+        std::vector<Object> objects;
+        size_t numberOfBytes;
+
+        void* allocate(size_t size, size_t alignment);
+
+        template<class T>
+        static void destroy(void* object) { static_cast<T*>(object)->~T(); }
+    };
+
+    // returns a shared_ptr to object which doesn't own it (and has no control block),
+    // so that copying and destroying it doesn't touch any reference count. Used for objects owned by an arena.
+    template<class T>
+    std::shared_ptr<T> nonOwning(T* object)
+    {
+        return std::shared_ptr<T>(std::shared_ptr<T>(), object);
+    }
+}
+
+#endif
@@ -0,0 +1,81 @@
+#include "Files.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace util {
+
+    namespace
+    {
+        // the umask can only be read by setting it, so it is read once during static initialization, before any threads are started
+        mode_t readUmask()
+        {
+            auto mask = umask(0);
+            umask(mask);
+            return mask;
+        }
+
+        const mode_t processUmask = readUmask();
+    }
+
+    bool readFile(const std::string& path, std::string& content)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+        {
+            return false;
+        }
+        std::ostringstream buffer;
+        buffer << file.rdbuf();
+        content = buffer.str();
+        return !file.bad();
+    }
+
+    bool writeFileAtomically(const std::string& path, const std::string& content)
+    {
+        auto separator = path.find_last_of('/');
+        if (separator != std::string::npos && separator > 0)
+        {
+            mkdir(path.substr(0, separator).c_str(), 0777);
+        }
+        std::vector<char> temporaryPath(path.begin(), path.end());
+        std::string suffix = ".XXXXXX";
+        temporaryPath.insert(temporaryPath.end(), suffix.begin(), suffix.end());
+        temporaryPath.push_back(0);
+        int fd = mkstemp(temporaryPath.data());
+        if (fd == -1)
+        {
+            return false;
+        }
+        // mkstemp creates the file readable only by its owner, but the file should get the same permissions as any other file created by the process
+        if (fchmod(fd, 0666 & ~processUmask) != 0)
+        {
+            close(fd);
+            std::remove(temporaryPath.data());
+            return false;
+        }
+        close(fd);
+        {
+            std::ofstream file(temporaryPath.data(), std::ios::binary);
+            file << content;
+            if (!file.flush())
+            {
+                std::remove(temporaryPath.data());
+                return false;
+            }
+        }
+        if (std::rename(temporaryPath.data(), path.c_str()) != 0)
+        {
+            std::remove(temporaryPath.data());
+            return false;
+        }
+        return true;
+    }
+}
@@ -0,0 +1,17 @@
+#ifndef __Files__
+#define __Files__
+
+#include <string>
+
+namespace util {
+
+    // reads the whole file at path into content, returns false if the file can't be read
+    bool readFile(const std::string& path, std::string& content);
+
+    // writes content into the file at path (creating its directory if needed) by renaming a temporary file,
+    // so that concurrent readers (e.g. other runs sharing a cache) never see a partially written file.
+    // returns false if the file can't be written.
+    bool writeFileAtomically(const std::string& path, const std::string& content);
+}
+
+#endif
@@ -0,0 +1,15 @@
+#ifndef __Hash__
+#define __Hash__
+
+#include <cstddef>
+
+namespace util {
+
+    // mix the hash-value h into seed (same scheme as boost::hash_combine)
+    inline void hashCombine(std::size_t& seed, std::size_t h)
+    {
+        seed ^= h + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    }
+}
+
+#endif
@@ -1,5 +1,7 @@
 #include "Options.hpp"
 
+#include <algorithm>
+#include <cctype>
 #include <iostream>
 #include <string>
 #include <utility>
@@ -18,6 +20,14 @@ namespace util {
     }
   }
 
+  bool UnsignedOption::setValue(std::string v) {
+    if (v.empty() || v.size() > 9 || !std::all_of(v.begin(), v.end(), ::isdigit)) {
+      return false;
+    }
+    _value = static_cast<unsigned>(std::stoul(v));
+    return true;
+  }
+
   bool MultiChoiceOption::setValue(std::string v) {
     for (auto it = _choices.begin(); it != _choices.end(); ++it) {
       if (*it == v) {
@@ -9,7 +9,7 @@ namespace util {
     
     class Option {
     public:
-        std::string name() { return _name; }
+        std::string name() const { return _name; }
         
         // return true if the value was succesfully set
         virtual bool setValue(std::string v) = 0;
@@ -31,12 +31,27 @@ namespace util {
         
         bool setValue(std::string v);
         
-        bool getValue() { return _value; }
+        bool getValue() const { return _value; }
         
     protected:
         bool _value;
     };
     
+    class UnsignedOption : public Option {
+    public:
+        UnsignedOption(std::string name, unsigned defaultValue) :
+        Option(name),
+        _value(defaultValue)
+        {}
+        
+        bool setValue(std::string v);
+        
+        unsigned getValue() const { return _value; }
+        
+    protected:
+        unsigned _value;
+    };
+    
     class StringOption : public Option {
     public:
         StringOption(std::string name, std::string defaultValue) :
@@ -46,7 +61,7 @@ namespace util {
         
         bool setValue(std::string v) { _value = v; return true; }
         
-        std::string getValue() { return _value; }
+        std::string getValue() const { return _value; }
         
     protected:
         std::string _value;
@@ -62,7 +77,7 @@ namespace util {
         
         bool setValue(std::string v);
         
-        std::string getValue() { return _value; }
+        std::string getValue() const { return _value; }
         
     protected:
         std::string _value;
@@ -74,21 +89,91 @@ namespace util {
     public:
         Configuration() :
         _outputFile("output", ""),
+        _sharing("-sharing", {"off", "let", "define-fun"}, "off"),
+        _compact("-compact", false),
+        _labels("-labels", true),
+        _simplify("-simplify", true),
+        _filterLemmas("-filterlemmas", true),
+        _threads("-threads", 1),
+        _stats("-stats", {"off", "on", "json"}, "off"),
+        _batch("-batch", ""),
+        _jobs("-j", 1),
+        _serve("-serve", ""),
+        _cache("-cache", ""),
+        _prover("-prover", ""),
+        _results("-results", ""),
         _allOptions()
         {
             registerOption(&_outputFile);
+            registerOption(&_sharing);
+            registerOption(&_compact);
+            registerOption(&_labels);
+            registerOption(&_simplify);
+            registerOption(&_filterLemmas);
+            registerOption(&_threads);
+            registerOption(&_stats);
+            registerOption(&_batch);
+            registerOption(&_jobs);
+            registerOption(&_serve);
+            registerOption(&_cache);
+            registerOption(&_prover);
+            registerOption(&_results);
         }
         
+        // the options are registered by address, so a copy would still refer to the options of the original
+        Configuration(const Configuration&) = delete;
+        Configuration& operator=(const Configuration&) = delete;
+        
         bool setAllValues(int argc, char *argv[]);
         
         Option* getOption(std::string name);
         
-        StringOption outputFile() { return _outputFile; }
-        
-        static Configuration instance() { return _instance; }
+        // the output file (in batch mode the output directory)
+        const StringOption& outputFile() const { return _outputFile; }
+        // how subterms occurring more than once are shared in the smtlib-output (cf. logic::SMTLIBWriter::Sharing)
+        const MultiChoiceOption& sharing() const { return _sharing; }
+        // write each assertion on a single line, without indentation
+        const BooleanOption& compact() const { return _compact; }
+        // write the labels of formulas as comments
+        const BooleanOption& labels() const { return _labels; }
+        // simplify the problem before writing it (cf. logic::Simplifier)
+        const BooleanOption& simplify() const { return _simplify; }
+        // remove duplicate and subsumed lemmas (cf. logic::LemmaFilter)
+        const BooleanOption& filterLemmas() const { return _filterLemmas; }
+        // number of threads used for generating the problem (0 means one thread per hardware thread)
+        const UnsignedOption& threads() const { return _threads; }
+        // report timings and sizes of the run, as smtlib-comments (on) or as JSON to stderr (json) (cf. util::Statistics)
+        const MultiChoiceOption& stats() const { return _stats; }
+        // encode all specs in the given directory or listed in the given file, each into its own output file (cf. encodeBatch in main.cpp)
+        const StringOption& batch() const { return _batch; }
+        // number of specs encoded concurrently in batch mode, each using -threads threads (0 means one spec per hardware thread)
+        const UnsignedOption& jobs() const { return _jobs; }
+        // keep running and answer encoding requests read from stdin (if the value is "stdin") or from the unix domain socket at the given path (cf. spectre::Server)
+        const StringOption& serve() const { return _serve; }
+        // directory caching the output of programs except their conjecture, so that specs which only differ in their conjecture are encoded faster (cf. spectre::Encoder)
+        const StringOption& cache() const { return _cache; }
+        // command of a prover, which is run on each encoded problem (with the path of the problem appended), reporting the result on stderr (cf. spectre::Prover)
+        const StringOption& prover() const { return _prover; }
+        // directory caching the results of -prover, keyed by the hash of the problem and the prover command
+        const StringOption& results() const { return _results; }
+        
+        static Configuration& instance() { return _instance; }
         
     protected:
         StringOption _outputFile;
+        MultiChoiceOption _sharing;
+        BooleanOption _compact;
+        BooleanOption _labels;
+        BooleanOption _simplify;
+        BooleanOption _filterLemmas;
+        UnsignedOption _threads;
+        MultiChoiceOption _stats;
+        StringOption _batch;
+        UnsignedOption _jobs;
+        StringOption _serve;
+        StringOption _cache;
+        StringOption _prover;
+        StringOption _results;
         
         std::map<std::string, Option*> _allOptions;
         
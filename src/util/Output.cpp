@@ -8,20 +8,26 @@
 
 namespace util {
 
-  std::ostream* Output::_stream = nullptr;
+  thread_local std::ostream* Output::_stream = nullptr;
 
-  bool Output::_isFile = false;
+  thread_local bool Output::_isFile = false;
 
   int Output::_commentIndex = std::ios_base::xalloc();
 
   bool Output::initialize() {
-    std::string path = util::Configuration::instance().outputFile().getValue();
+    return initialize(util::Configuration::instance().outputFile().getValue());
+  }
+
+  bool Output::initialize(const std::string& path) {
+    close();
     if (path == "") {
       _stream = &std::cout;
     } else {
       _stream = new std::ofstream(path, std::ofstream::out);
+      _isFile = true;
       if (!*_stream) {
         std::cerr << "Unable to open file " << path << std::endl;
+        close();
         return false;
       }
     }
@@ -31,6 +37,7 @@ namespace util {
   void Output::close() {
     if (_isFile) {
       static_cast<std::ofstream*>(_stream)->close();
+      delete _stream;
       _isFile = false;
     }
     _stream = nullptr;
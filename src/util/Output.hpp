@@ -2,6 +2,7 @@
 #define __Output__
 
 #include <iostream>
+#include <string>
 
 namespace util {
 
@@ -9,10 +10,13 @@ namespace util {
   {
   public:
 
-    // must be called after options have been set
+    // must be called after options have been set, initializes the output of the calling thread
     static bool initialize();
+    // writes the output into the file at path instead (or to stdout if path is empty)
+    static bool initialize(const std::string& path);
 
-    // call only after initialize()
+    // call only after initialize().
+    // each thread has its own output stream, so that several problems can be encoded concurrently into different files.
     static std::ostream& stream() { return *_stream; }
 
     // must be called before exiting
@@ -23,9 +27,9 @@ namespace util {
     static std::ostream& nocomment(std::ostream& str);
 
   private:
-    static std::ostream* _stream;
+    static thread_local std::ostream* _stream;
 
-    static bool _isFile;
+    static thread_local bool _isFile;
 
     // in any ostream, the value of the iword stored at this index is
     // 0 or 1. If 1, the streambuf of the stream is a
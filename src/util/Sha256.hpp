@@ -0,0 +1,36 @@
+#ifndef __Sha256__
+#define __Sha256__
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace util {
+
+    /*
+     * Computes the SHA-256 digest of a sequence of bytes, which is used to address files by their content (e.g. in caches).
+     */
+    class Sha256
+    {
+    public:
+        Sha256();
+
+        void update(const void* data, size_t size);
+        void update(const std::string& data) { update(data.data(), data.size()); }
+
+        // finishes the computation and returns the digest as 64 lowercase hexadecimal digits.
+        // update must not be called afterwards.
+        std::string hexDigest();
+
+    private:
+        std::array<uint32_t, 8> state;
+        std::array<unsigned char, 64> block;
+        size_t blockSize;
+        uint64_t numberOfBytes;
+
+        void processBlock();
+    };
+}
+
+#endif
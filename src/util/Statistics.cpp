@@ -0,0 +1,160 @@
+#include "Statistics.hpp"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <sys/resource.h>
+#include <time.h>
+
+#include "Options.hpp"
+#include "Output.hpp"
+
+namespace util {
+
+    thread_local std::vector<Statistics::Stage> Statistics::_stages;
+    thread_local std::vector<std::pair<std::string, size_t>> Statistics::_counters;
+    thread_local std::vector<Statistics::LemmaFamily> Statistics::_lemmaFamilies;
+    thread_local double Statistics::_workerCpuSeconds = 0;
+    std::mutex Statistics::_outputMutex;
+
+    bool Statistics::enabled()
+    {
+        return Configuration::instance().stats().getValue() != "off";
+    }
+
+    Statistics::StageTimer::~StageTimer()
+    {
+        std::chrono::duration<double> wallTime = std::chrono::steady_clock::now() - wallStart;
+        double cpuTime = cpuSeconds() - cpuStart;
+        struct rusage usage;
+        long maxResidentKB = getrusage(RUSAGE_SELF, &usage) == 0 ? usage.ru_maxrss : 0;
+
+        for (auto& existingStage : _stages)
+        {
+            if (existingStage.name == stage)
+            {
+                existingStage.wallSeconds += wallTime.count();
+                existingStage.cpuSeconds += cpuTime;
+                existingStage.maxResidentKB = maxResidentKB;
+                return;
+            }
+        }
+        _stages.push_back(Stage{stage, wallTime.count(), cpuTime, maxResidentKB});
+    }
+
+    double Statistics::threadCpuSeconds()
+    {
+        timespec time;
+        if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time) != 0)
+        {
+            return 0;
+        }
+        return static_cast<double>(time.tv_sec) + static_cast<double>(time.tv_nsec) / 1e9;
+    }
+
+    void Statistics::addWorkerCpuSeconds(double seconds)
+    {
+        _workerCpuSeconds += seconds;
+    }
+
+    void Statistics::setCounter(const std::string& name, size_t value)
+    {
+        for (auto& counter : _counters)
+        {
+            if (counter.first == name)
+            {
+                counter.second = value;
+                return;
+            }
+        }
+        _counters.push_back(std::make_pair(name, value));
+    }
+
+    void Statistics::addLemmaFamily(const std::string& family, size_t numberOfLemmas, size_t numberOfBytes)
+    {
+        for (auto& lemmaFamily : _lemmaFamilies)
+        {
+            if (lemmaFamily.name == family)
+            {
+                lemmaFamily.numberOfLemmas += numberOfLemmas;
+                lemmaFamily.numberOfBytes += numberOfBytes;
+                return;
+            }
+        }
+        _lemmaFamilies.push_back(LemmaFamily{family, numberOfLemmas, numberOfBytes});
+    }
+
+    void Statistics::output()
+    {
+        auto mode = Configuration::instance().stats().getValue();
+        if (mode == "on")
+        {
+            Output::stream() << Output::comment;
+            outputComments(Output::stream());
+            Output::stream() << Output::nocomment;
+        }
+        else if (mode == "json")
+        {
+            std::lock_guard<std::mutex> lock(_outputMutex);
+            outputJSON(std::cerr);
+        }
+    }
+
+    void Statistics::reset()
+    {
+        _stages.clear();
+        _counters.clear();
+        _lemmaFamilies.clear();
+    }
+
+    void Statistics::outputComments(std::ostream& ostr)
+    {
+        ostr << "Statistics:\n";
+        ostr << std::fixed << std::setprecision(3);
+        for (const auto& stage : _stages)
+        {
+            ostr << "  " << std::left << std::setw(32) << stage.name << std::right
+                 << " wall " << std::setw(9) << stage.wallSeconds << "s  cpu " << std::setw(9) << stage.cpuSeconds << "s\n";
+        }
+        for (const auto& counter : _counters)
+        {
+            ostr << "  " << std::left << std::setw(32) << counter.first << std::right << " " << counter.second << "\n";
+        }
+        for (const auto& lemmaFamily : _lemmaFamilies)
+        {
+            ostr << "  " << std::left << std::setw(32) << lemmaFamily.name << std::right
+                 << " lemmas " << std::setw(6) << lemmaFamily.numberOfLemmas << "  bytes " << lemmaFamily.numberOfBytes << "\n";
+        }
+        ostr.unsetf(std::ios_base::floatfield);
+        ostr << std::setprecision(6);
+    }
+
+    // the names of stages, counters and families are plain identifiers, so they don't need to be escaped
+    void Statistics::outputJSON(std::ostream& ostr)
+    {
+        ostr << std::fixed << std::setprecision(6);
+        ostr << "{\"stages\": {";
+        for (size_t i = 0; i < _stages.size(); ++i)
+        {
+            ostr << (i == 0 ? "" : ", ") << "\"" << _stages[i].name << "\": {\"wall\": " << _stages[i].wallSeconds << ", \"cpu\": " << _stages[i].cpuSeconds << "}";
+        }
+        ostr << "}, \"counters\": {";
+        for (size_t i = 0; i < _counters.size(); ++i)
+        {
+            ostr << (i == 0 ? "" : ", ") << "\"" << _counters[i].first << "\": " << _counters[i].second;
+        }
+        ostr << "}, \"lemmaFamilies\": {";
+        for (size_t i = 0; i < _lemmaFamilies.size(); ++i)
+        {
+            ostr << (i == 0 ? "" : ", ") << "\"" << _lemmaFamilies[i].name << "\": {\"lemmas\": " << _lemmaFamilies[i].numberOfLemmas << ", \"bytes\": " << _lemmaFamilies[i].numberOfBytes << "}";
+        }
+        ostr << "}}" << std::endl;
+        ostr.unsetf(std::ios_base::floatfield);
+        ostr << std::setprecision(6);
+    }
+}
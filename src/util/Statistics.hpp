@@ -0,0 +1,93 @@
+#ifndef __Statistics__
+#define __Statistics__
+
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace util {
+
+    /*
+     * Collects statistics about a run, which are reported if the option -stats is set:
+     * - the wall-clock and cpu time of each stage (the cpu time of the thread running the stage, plus the cpu time worker threads spent on its tasks, cf. util::ThreadPool)
+     * - counters, e.g. the number of nodes and symbols
+     * - the number of lemmas and output bytes of each lemma family
+     * With "-stats on" the report is written as smtlib-comments into the output, with "-stats json" as JSON to stderr.
+     * The statistics are collected per thread, so that each thread encoding a problem (cf. -batch with -j) reports on its own problem.
+     * The stages and counters therefore need to be reported by the thread encoding the problem (and not by helper threads),
+     * and the cpu times don't include the time spent on other problems encoded concurrently.
+     */
+    class Statistics
+    {
+    public:
+        static bool enabled();
+
+        // measures the time between its construction and destruction as a stage
+        class StageTimer
+        {
+        public:
+            StageTimer(std::string stage) :
+            stage(std::move(stage)),
+            wallStart(std::chrono::steady_clock::now()),
+            cpuStart(cpuSeconds())
+            {}
+            ~StageTimer();
+
+        private:
+            const std::string stage;
+            const std::chrono::steady_clock::time_point wallStart;
+            const double cpuStart;
+        };
+
+        // the cpu time used by the calling thread so far
+        static double threadCpuSeconds();
+        // adds cpu time which worker threads spent on behalf of the calling thread, so that it is included in the stages of the calling thread
+        static void addWorkerCpuSeconds(double seconds);
+
+        static void setCounter(const std::string& name, size_t value);
+        static void addLemmaFamily(const std::string& family, size_t numberOfLemmas, size_t numberOfBytes);
+
+        // writes the report according to -stats (does nothing if -stats is off)
+        static void output();
+        // forgets all stages, counters and lemma families of the calling thread, so that the next problem gets its own report
+        static void reset();
+
+        struct Stage
+        {
+            std::string name;
+            double wallSeconds;
+            double cpuSeconds;
+            long maxResidentKB; // peak resident set size of the process at the end of the stage
+        };
+        // the stages measured by the calling thread so far (independently of -stats), e.g. for spectre_bench
+        static const std::vector<Stage>& stages() { return _stages; }
+
+    private:
+        struct LemmaFamily
+        {
+            std::string name;
+            size_t numberOfLemmas;
+            size_t numberOfBytes;
+        };
+
+        // all entries are kept in order of their first occurrence
+        static thread_local std::vector<Stage> _stages;
+        static thread_local std::vector<std::pair<std::string, size_t>> _counters;
+        static thread_local std::vector<LemmaFamily> _lemmaFamilies;
+        static thread_local double _workerCpuSeconds;
+        // guards stderr, so that the reports of concurrent problems don't interleave
+        static std::mutex _outputMutex;
+
+        // the cpu time of the calling thread and of the worker threads executing its tasks so far
+        static double cpuSeconds() { return threadCpuSeconds() + _workerCpuSeconds; }
+
+        static void outputComments(std::ostream& ostr);
+        static void outputJSON(std::ostream& ostr);
+    };
+}
+
+#endif
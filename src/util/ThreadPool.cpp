@@ -0,0 +1,169 @@
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "Statistics.hpp"
+
+namespace util {
+
+    ThreadPool::ThreadPool(unsigned numberOfThreads) :
+    queues(),
+    workers(),
+    round(0),
+    stopping(false),
+    exception(nullptr),
+    numberOfPendingTasks(0),
+    workerCpuNanoseconds(0)
+    {
+        if (numberOfThreads == 0)
+        {
+            numberOfThreads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        for (unsigned i = 0; i < numberOfThreads; ++i)
+        {
+            queues.emplace_back(new Queue());
+        }
+        for (unsigned i = 1; i < numberOfThreads; ++i)
+        {
+            workers.emplace_back(&ThreadPool::work, this, i);
+        }
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        tasksAdded.notify_all();
+        for (auto& worker : workers)
+        {
+            worker.join();
+        }
+    }
+
+    void ThreadPool::run(std::vector<std::function<void()>> tasks)
+    {
+        if (tasks.empty())
+        {
+            return;
+        }
+
+        // distribute the tasks round-robin, so that neighbouring tasks (which tend to have similar costs) end up on different threads
+        numberOfPendingTasks = tasks.size();
+        workerCpuNanoseconds = 0;
+        for (size_t i = 0; i < tasks.size(); ++i)
+        {
+            auto& queue = *queues[i % queues.size()];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.tasks.push_back(std::move(tasks[i]));
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            round++;
+        }
+        tasksAdded.notify_all();
+
+        std::function<void()> task;
+        while (take(0, task))
+        {
+            execute(task, false);
+        }
+
+        std::unique_lock<std::mutex> lock(mutex);
+        tasksFinished.wait(lock, [this]{ return numberOfPendingTasks == 0; });
+        Statistics::addWorkerCpuSeconds(static_cast<double>(workerCpuNanoseconds) / 1e9);
+        if (exception != nullptr)
+        {
+            auto rethrown = exception;
+            exception = nullptr;
+            std::rethrow_exception(rethrown);
+        }
+    }
+
+    void ThreadPool::work(unsigned index)
+    {
+        unsigned seenRound = 0;
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                tasksAdded.wait(lock, [this, seenRound]{ return stopping || round != seenRound; });
+                if (stopping)
+                {
+                    return;
+                }
+                seenRound = round;
+            }
+
+            std::function<void()> task;
+            while (take(index, task))
+            {
+                execute(task, true);
+            }
+        }
+    }
+
+    bool ThreadPool::take(unsigned index, std::function<void()>& task)
+    {
+        {
+            auto& queue = *queues[index];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (!queue.tasks.empty())
+            {
+                task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+                return true;
+            }
+        }
+        // steal from the other queues
+        for (unsigned i = 1; i < queues.size(); ++i)
+        {
+            auto& queue = *queues[(index + i) % queues.size()];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (!queue.tasks.empty())
+            {
+                task = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void ThreadPool::execute(std::function<void()>& task, bool onWorker)
+    {
+        auto cpuStart = onWorker ? Statistics::threadCpuSeconds() : 0;
+        try
+        {
+            task();
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (exception == nullptr)
+            {
+                exception = std::current_exception();
+            }
+        }
+        task = nullptr;
+        if (onWorker)
+        {
+            // added before the task counts as finished, so that run() sees the cpu time of all tasks
+            workerCpuNanoseconds += static_cast<uint64_t>((Statistics::threadCpuSeconds() - cpuStart) * 1e9);
+        }
+
+        if (--numberOfPendingTasks == 0)
+        {
+            // lock the mutex, so that the notification can't get lost between the check and the wait in run()
+            std::lock_guard<std::mutex> lock(mutex);
+            tasksFinished.notify_all();
+        }
+    }
+}
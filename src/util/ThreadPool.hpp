@@ -0,0 +1,70 @@
+#ifndef __ThreadPool__
+#define __ThreadPool__
+
+#include <atomic>
+#include <cstdint>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace util {
+
+    /*
+     * A fixed set of worker threads executing batches of independent tasks.
+     * Each thread owns a queue of tasks: it takes tasks from the front of its own queue,
+     * and if its own queue is empty, it steals tasks from the back of the queues of the other threads,
+     * so that threads which got cheap tasks help out threads which got expensive ones.
+     * The thread calling run() participates in executing the tasks.
+     * The cpu time the worker threads spend on the tasks is added to the statistics of the thread calling run() (cf. util::Statistics).
+     */
+    class ThreadPool
+    {
+    public:
+        // numberOfThreads includes the calling thread, so a pool with a single thread doesn't start any worker threads.
+        // 0 means one thread per hardware thread.
+        ThreadPool(unsigned numberOfThreads);
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        unsigned numberOfThreads() const { return static_cast<unsigned>(queues.size()); }
+
+        // executes all tasks and returns when all of them are finished.
+        // tasks may be executed in any order, except that with a single thread they are executed in order on the calling thread.
+        // if a task throws, the first exception is rethrown after all tasks finished.
+        // must not be called concurrently or from inside a task.
+        void run(std::vector<std::function<void()>> tasks);
+
+    private:
+        struct Queue
+        {
+            std::mutex mutex;
+            std::deque<std::function<void()>> tasks;
+        };
+        std::vector<std::unique_ptr<Queue>> queues; // queue 0 belongs to the thread calling run()
+        std::vector<std::thread> workers;
+
+        // guards round, stopping and exception, and is used to wait for new and finished tasks
+        std::mutex mutex;
+        std::condition_variable tasksAdded;
+        std::condition_variable tasksFinished;
+        unsigned round; // incremented whenever run() adds tasks
+        bool stopping;
+        std::exception_ptr exception;
+        std::atomic<size_t> numberOfPendingTasks;
+        std::atomic<uint64_t> workerCpuNanoseconds; // the cpu time the worker threads spent on the tasks of the current run()
+
+        void work(unsigned index);
+        bool take(unsigned index, std::function<void()>& task);
+        // executes the task, measuring its cpu time if it is executed by a worker thread
+        void execute(std::function<void()>& task, bool onWorker);
+    };
+}
+
+#endif
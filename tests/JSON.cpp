@@ -0,0 +1,225 @@
+#include "JSON.hpp"
+
+#include <cstddef>
+#include <cstdlib>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Test.hpp"
+
+namespace test {
+
+    bool JSONValue::has(const std::string& key) const
+    {
+        for (const auto& member : members)
+        {
+            if (member.first == key)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    const JSONValue& JSONValue::operator[](const std::string& key) const
+    {
+        for (const auto& member : members)
+        {
+            if (member.first == key)
+            {
+                return member.second;
+            }
+        }
+        fail(__FILE__, __LINE__, "the JSON object has no member " + key);
+    }
+
+    namespace
+    {
+        class JSONParser
+        {
+        public:
+            JSONParser(const std::string& json) : json(json), position(0) {}
+
+            JSONValue parseDocument()
+            {
+                auto value = parseValue();
+                skipWhitespace();
+                if (position != json.size())
+                {
+                    error("unexpected content after the value");
+                }
+                return value;
+            }
+
+        private:
+            const std::string& json;
+            size_t position;
+
+            [[noreturn]] void error(const std::string& message)
+            {
+                fail(__FILE__, __LINE__, "malformed JSON at offset " + std::to_string(position) + ": " + message + "\n" + json);
+            }
+
+            void skipWhitespace()
+            {
+                while (position < json.size() && std::string(" \t\r\n").find(json[position]) != std::string::npos)
+                {
+                    position++;
+                }
+            }
+
+            void expect(char c)
+            {
+                skipWhitespace();
+                if (position >= json.size() || json[position] != c)
+                {
+                    error(std::string("expected '") + c + "'");
+                }
+                position++;
+            }
+
+            bool consume(const std::string& literal)
+            {
+                if (json.compare(position, literal.size(), literal) == 0)
+                {
+                    position += literal.size();
+                    return true;
+                }
+                return false;
+            }
+
+            JSONValue parseValue()
+            {
+                skipWhitespace();
+                if (position >= json.size())
+                {
+                    error("expected a value");
+                }
+                JSONValue value{JSONValue::Kind::Null, false, 0, "", {}, {}};
+                char c = json[position];
+                if (c == '{')
+                {
+                    value.kind = JSONValue::Kind::Object;
+                    position++;
+                    skipWhitespace();
+                    if (!consume("}"))
+                    {
+                        do
+                        {
+                            skipWhitespace();
+                            auto key = parseString();
+                            if (value.has(key))
+                            {
+                                error("duplicate member " + key);
+                            }
+                            expect(':');
+                            value.members.push_back(std::make_pair(key, parseValue()));
+                            skipWhitespace();
+                        } while (consume(","));
+                        expect('}');
+                    }
+                }
+                else if (c == '[')
+                {
+                    value.kind = JSONValue::Kind::Array;
+                    position++;
+                    skipWhitespace();
+                    if (!consume("]"))
+                    {
+                        do
+                        {
+                            value.elements.push_back(parseValue());
+                            skipWhitespace();
+                        } while (consume(","));
+                        expect(']');
+                    }
+                }
+                else if (c == '"')
+                {
+                    value.kind = JSONValue::Kind::String;
+                    value.string = parseString();
+                }
+                else if (consume("true") || consume("false"))
+                {
+                    value.kind = JSONValue::Kind::Boolean;
+                    value.boolean = c == 't';
+                }
+                else if (consume("null"))
+                {
+                    value.kind = JSONValue::Kind::Null;
+                }
+                else
+                {
+                    value.kind = JSONValue::Kind::Number;
+                    value.number = parseNumber();
+                }
+                return value;
+            }
+
+            // strings are only checked for their delimiters and escapes, the escapes are kept as they are
+            std::string parseString()
+            {
+                if (position >= json.size() || json[position] != '"')
+                {
+                    error("expected a string");
+                }
+                auto start = ++position;
+                while (position < json.size() && json[position] != '"')
+                {
+                    if (static_cast<unsigned char>(json[position]) < 0x20)
+                    {
+                        error("control character in a string");
+                    }
+                    position += json[position] == '\\' ? 2 : 1;
+                }
+                if (position >= json.size())
+                {
+                    error("unterminated string");
+                }
+                return json.substr(start, position++ - start);
+            }
+
+            double parseNumber()
+            {
+                // the grammar of JSON numbers: -?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?
+                auto start = position;
+                auto digits = [&]() {
+                    auto first = position;
+                    while (position < json.size() && json[position] >= '0' && json[position] <= '9')
+                    {
+                        position++;
+                    }
+                    return position - first;
+                };
+                consume("-");
+                auto integerStart = position;
+                if (digits() == 0 || (json[integerStart] == '0' && position - integerStart > 1))
+                {
+                    error("expected a value");
+                }
+                if (consume(".") && digits() == 0)
+                {
+                    error("expected digits after the decimal point");
+                }
+                if (consume("e") || consume("E"))
+                {
+                    if (!consume("+"))
+                    {
+                        consume("-");
+                    }
+                    if (digits() == 0)
+                    {
+                        error("expected digits in the exponent");
+                    }
+                }
+                return std::strtod(json.substr(start, position - start).c_str(), nullptr);
+            }
+        };
+    }
+
+    JSONValue parseJSON(const std::string& json)
+    {
+        return JSONParser(json).parseDocument();
+    }
+}
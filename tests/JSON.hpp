@@ -0,0 +1,35 @@
+#ifndef __JSON__
+#define __JSON__
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace test {
+
+    /*
+     * A minimal reader for the JSON written by spectre (cf. -stats json) and spectre_bench (cf. -format json),
+     * used to check that the reports are well-formed and contain the expected entries.
+     */
+    struct JSONValue
+    {
+        enum class Kind { Null, Boolean, Number, String, Array, Object };
+
+        Kind kind;
+        bool boolean;
+        double number;
+        std::string string;
+        std::vector<JSONValue> elements;
+        // the members of an object, in the order in which they are written
+        std::vector<std::pair<std::string, JSONValue>> members;
+
+        bool has(const std::string& key) const;
+        // the member key of an object. fails the test case if there is no such member
+        const JSONValue& operator[](const std::string& key) const;
+    };
+
+    // parses json, which needs to contain exactly one value (surrounded by whitespace). fails the test case if json is malformed.
+    JSONValue parseJSON(const std::string& json);
+}
+
+#endif
@@ -0,0 +1,198 @@
+#include "SExpression.hpp"
+
+#include <cstddef>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "Test.hpp"
+
+namespace test {
+
+    std::string SExpression::toString() const
+    {
+        if (!isList)
+        {
+            return atom;
+        }
+        std::string result = "(";
+        for (size_t i = 0; i < children.size(); i++)
+        {
+            result += (i > 0 ? " " : "") + children[i].toString();
+        }
+        return result + ")";
+    }
+
+    std::vector<SExpression> parseSExpressions(const std::string& smtlib)
+    {
+        std::vector<SExpression> stack(1, SExpression{"", {}, true});
+        size_t i = 0;
+        while (i < smtlib.size())
+        {
+            char c = smtlib[i];
+            if (c == ';')
+            {
+                while (i < smtlib.size() && smtlib[i] != '\n')
+                {
+                    i++;
+                }
+            }
+            else if (c == ' ' || c == '\t' || c == '\n' || c == '\r')
+            {
+                i++;
+            }
+            else if (c == '(')
+            {
+                stack.push_back(SExpression{"", {}, true});
+                i++;
+            }
+            else if (c == ')')
+            {
+                if (stack.size() < 2)
+                {
+                    fail(__FILE__, __LINE__, "unbalanced parentheses in the output");
+                }
+                auto list = std::move(stack.back());
+                stack.pop_back();
+                stack.back().children.push_back(std::move(list));
+                i++;
+            }
+            else
+            {
+                auto start = i;
+                if (c == '|')
+                {
+                    i = smtlib.find('|', i + 1);
+                    if (i == std::string::npos)
+                    {
+                        fail(__FILE__, __LINE__, "unterminated quoted symbol in the output");
+                    }
+                    i++;
+                }
+                else
+                {
+                    while (i < smtlib.size() && std::string(" \t\r\n();").find(smtlib[i]) == std::string::npos)
+                    {
+                        i++;
+                    }
+                }
+                stack.back().children.push_back(SExpression{smtlib.substr(start, i - start), {}, false});
+            }
+        }
+        if (stack.size() != 1)
+        {
+            fail(__FILE__, __LINE__, "unbalanced parentheses in the output");
+        }
+        return std::move(stack.back().children);
+    }
+
+    namespace
+    {
+        struct Definition
+        {
+            SExpression value;
+            std::set<std::string> atoms; // the atoms of value, i.e. the symbols which could be captured
+        };
+        typedef std::map<std::string, Definition> Definitions;
+
+        void collectAtoms(const SExpression& e, std::set<std::string>& atoms)
+        {
+            if (!e.isList)
+            {
+                atoms.insert(e.atom);
+            }
+            for (const auto& child : e.children)
+            {
+                collectAtoms(child, atoms);
+            }
+        }
+
+        bool isBindingName(const std::string& atom)
+        {
+            return atom.size() > 2 && atom.front() == '|' && atom.find('#') != std::string::npos;
+        }
+
+        // captured contains the names whose definitions mention a variable rebound by an enclosing quantifier
+        SExpression expand(const SExpression& e, const Definitions& definitions, const std::set<std::string>& captured)
+        {
+            if (!e.isList)
+            {
+                if (captured.count(e.atom) > 0)
+                {
+                    fail(__FILE__, __LINE__, "expanding " + e.atom + " would capture a variable");
+                }
+                auto it = definitions.find(e.atom);
+                if (it != definitions.end())
+                {
+                    return it->second.value;
+                }
+                if (isBindingName(e.atom))
+                {
+                    fail(__FILE__, __LINE__, e.atom + " is used outside of its binding");
+                }
+                return e;
+            }
+            if (e.children.size() == 3 && !e.children[0].isList && e.children[0].atom == "let")
+            {
+                auto inner = definitions;
+                for (const auto& binding : e.children[1].children)
+                {
+                    Definition definition{expand(binding.children.at(1), definitions, captured), {}};
+                    collectAtoms(definition.value, definition.atoms);
+                    inner[binding.children.at(0).atom] = definition;
+                }
+                return expand(e.children[2], inner, captured);
+            }
+            if (e.children.size() == 3 && !e.children[0].isList && (e.children[0].atom == "forall" || e.children[0].atom == "exists"))
+            {
+                auto inner = definitions;
+                auto innerCaptured = captured;
+                for (const auto& var : e.children[1].children)
+                {
+                    const auto& name = var.children.at(0).atom;
+                    for (auto it = inner.begin(); it != inner.end();)
+                    {
+                        if (it->second.atoms.count(name) > 0)
+                        {
+                            innerCaptured.insert(it->first);
+                            it = inner.erase(it);
+                        }
+                        else
+                        {
+                            ++it;
+                        }
+                    }
+                }
+                return SExpression{"", {e.children[0], e.children[1], expand(e.children[2], inner, innerCaptured)}, true};
+            }
+            SExpression result{"", {}, true};
+            for (const auto& child : e.children)
+            {
+                result.children.push_back(expand(child, definitions, captured));
+            }
+            return result;
+        }
+    }
+
+    std::string expandSharing(const std::string& smtlib)
+    {
+        Definitions definitions;
+        std::string result;
+        for (const auto& command : parseSExpressions(smtlib))
+        {
+            auto isDefinition = command.children.size() == 5 && command.children[0].atom == "define-fun" && command.children[2].isList && command.children[2].children.empty();
+            if (isDefinition)
+            {
+                Definition definition{expand(command.children[4], definitions, {}), {}};
+                collectAtoms(definition.value, definition.atoms);
+                definitions[command.children[1].atom] = definition;
+            }
+            else
+            {
+                result += expand(command, definitions, {}).toString() + "\n";
+            }
+        }
+        return result;
+    }
+}
@@ -0,0 +1,33 @@
+#ifndef __SExpression__
+#define __SExpression__
+
+#include <string>
+#include <vector>
+
+namespace test {
+
+    /*
+     * A minimal reader for the smtlib-output of spectre, used to compare outputs which are written differently
+     * but denote the same problem (e.g. with and without sharing of subterms).
+     */
+    struct SExpression
+    {
+        // the atom, if children is empty and the expression is not a list
+        std::string atom;
+        std::vector<SExpression> children;
+        bool isList;
+
+        std::string toString() const;
+    };
+
+    // parses the top-level expressions of smtlib, ignoring comments. fails the test case if the parentheses are unbalanced.
+    std::vector<SExpression> parseSExpressions(const std::string& smtlib);
+
+    // the top-level commands of smtlib (one per line, without comments and whitespace), after replacing each name bound by a let
+    // or by a nullary define-fun by its definition, and removing the define-funs.
+    // fails the test case if a name is used outside of the scope of its binding, or if replacing a name by its definition
+    // would capture a variable (i.e. if the name is used below a quantifier rebinding one of the symbols of its definition).
+    std::string expandSharing(const std::string& smtlib);
+}
+
+#endif
@@ -0,0 +1,101 @@
+#include "Test.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <ftw.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace test {
+
+    std::vector<TestCase>& testCases()
+    {
+        // constructed on first use, since the test cases are registered during static initialization
+        static std::vector<TestCase> cases;
+        return cases;
+    }
+
+    void fail(const char* file, int line, const std::string& message)
+    {
+        std::stringstream description;
+        description << file << ":" << line << ": check failed: " << message;
+        throw Failure{description.str()};
+    }
+
+    std::string specPath(const std::string& name)
+    {
+        return std::string(SPECTRE_TEST_SPECS) + "/" + name;
+    }
+
+    std::string readSpec(const std::string& name)
+    {
+        std::ifstream file(specPath(name), std::ios::binary);
+        if (!file)
+        {
+            fail(__FILE__, __LINE__, "can't read the spec " + specPath(name));
+        }
+        std::stringstream content;
+        content << file.rdbuf();
+        return content.str();
+    }
+
+    namespace
+    {
+        std::string makeTemporaryDirectory()
+        {
+            auto tmp = std::getenv("TMPDIR");
+            std::string pattern = std::string(tmp != nullptr && *tmp != 0 ? tmp : "/tmp") + "/spectre_tests.XXXXXX";
+            std::vector<char> path(pattern.begin(), pattern.end());
+            path.push_back(0);
+            if (mkdtemp(path.data()) == nullptr)
+            {
+                fail(__FILE__, __LINE__, "can't create a temporary directory " + pattern);
+            }
+            return std::string(path.data());
+        }
+
+        int removeEntry(const char* path, const struct stat*, int, struct FTW*)
+        {
+            return std::remove(path);
+        }
+    }
+
+    TemporaryDirectory::TemporaryDirectory() : path(makeTemporaryDirectory()) {}
+
+    TemporaryDirectory::~TemporaryDirectory()
+    {
+        nftw(path.c_str(), removeEntry, 16, FTW_DEPTH | FTW_PHYS);
+    }
+
+    int runCommand(const std::string& command, std::string& standardOutput, std::string& standardError)
+    {
+        // stderr is collected in a file, so that a full pipe can't block the command
+        TemporaryDirectory directory;
+        auto errorFile = directory.path + "/stderr";
+        FILE* pipe = popen((command + " 2> '" + errorFile + "'").c_str(), "r");
+        if (pipe == nullptr)
+        {
+            fail(__FILE__, __LINE__, "can't run " + command);
+        }
+        standardOutput.clear();
+        char buffer[4096];
+        size_t numberOfBytes;
+        while ((numberOfBytes = fread(buffer, 1, sizeof(buffer), pipe)) > 0)
+        {
+            standardOutput.append(buffer, numberOfBytes);
+        }
+        int status = pclose(pipe);
+
+        std::ifstream file(errorFile, std::ios::binary);
+        std::stringstream content;
+        content << file.rdbuf();
+        standardError = content.str();
+        return status != -1 && WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+    }
+}
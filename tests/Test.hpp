@@ -0,0 +1,152 @@
+#ifndef __Test__
+#define __Test__
+
+#include <cstddef>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Context.hpp"
+
+namespace test {
+
+    /*
+     * A minimal test harness without external dependencies.
+     * Test cases are registered using TEST(group, name), and run by spectre_tests (cf. main.cpp), either all of them
+     * or the ones of the groups given on the command line. Each test case runs in its own logic::Context, so the symbols,
+     * terms and formulas of a test case are not visible to other test cases.
+     * A failing check reports its location and ends the test case (by throwing a Failure), the other test cases still run.
+     */
+    struct TestCase
+    {
+        const char* group;
+        const char* name;
+        void (*run)();
+    };
+
+    // the registered test cases, in the order of registration
+    std::vector<TestCase>& testCases();
+
+    class Registration
+    {
+    public:
+        Registration(const char* group, const char* name, void (*run)()) { testCases().push_back(TestCase{group, name, run}); }
+    };
+
+    struct Failure
+    {
+        std::string message;
+    };
+
+    [[noreturn]] void fail(const char* file, int line, const std::string& message);
+
+    template<class T, class U>
+    void checkEqual(const T& actual, const U& expected, const char* expressions, const char* file, int line)
+    {
+        if (!(actual == expected))
+        {
+            std::stringstream message;
+            message << expressions << "\n    actual: " << actual << "\n  expected: " << expected;
+            fail(file, line, message.str());
+        }
+    }
+
+    // runs run(t) for t = 0, ..., numberOfThreads - 1 on concurrent threads, each of them in the context of the calling thread,
+    // and returns the results, indexed by thread
+    template<class Run>
+    auto runConcurrently(size_t numberOfThreads, Run run) -> std::vector<decltype(run(size_t()))>
+    {
+        std::vector<decltype(run(size_t()))> results(numberOfThreads);
+        auto& context = logic::Context::current();
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < numberOfThreads; t++)
+        {
+            threads.emplace_back([&, t]() {
+                logic::Context::Scope scope(context);
+                results[t] = run(t);
+            });
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+        return results;
+    }
+
+    // constructs construct(i) for i = 0, ..., n - 1 on each of numberOfThreads concurrent threads, the odd threads in reverse order,
+    // so that the threads race for the same objects from both ends. checks that all threads constructed the same objects and returns them
+    template<class Construct>
+    auto constructConcurrently(size_t numberOfThreads, size_t n, Construct construct) -> std::vector<decltype(construct(size_t()))>
+    {
+        auto results = runConcurrently(numberOfThreads, [&](size_t t) {
+            std::vector<decltype(construct(size_t()))> objects(n);
+            for (size_t j = 0; j < n; j++)
+            {
+                auto i = (t % 2 == 0) ? j : n - 1 - j;
+                objects[i] = construct(i);
+            }
+            return objects;
+        });
+        for (size_t t = 1; t < numberOfThreads; t++)
+        {
+            for (size_t i = 0; i < n; i++)
+            {
+                if (!(results[t][i] == results[0][i]))
+                {
+                    fail(__FILE__, __LINE__, "thread " + std::to_string(t) + " constructed another object " + std::to_string(i) + " than thread 0");
+                }
+            }
+        }
+        return results[0];
+    }
+
+    // checks that constructing an object again returns the existing object, without allocating anything (as counted by numberOfObjects)
+    template<class Construct, class NumberOfObjects>
+    void checkConstructedOnce(Construct construct, NumberOfObjects numberOfObjects)
+    {
+        auto object = construct();
+        auto numberOfObjectsBefore = numberOfObjects();
+        for (int k = 0; k < 10; k++)
+        {
+            if (!(construct() == object))
+            {
+                fail(__FILE__, __LINE__, "constructing an object again returned another object");
+            }
+        }
+        checkEqual(numberOfObjects(), numberOfObjectsBefore, "numberOfObjects() == numberOfObjectsBefore", __FILE__, __LINE__);
+    }
+
+    // the path of the spec name in tests/specs
+    std::string specPath(const std::string& name);
+    // the content of the spec name in tests/specs
+    std::string readSpec(const std::string& name);
+
+    // runs command in a shell, stores what it writes to stdout and stderr, and returns its exit status (or -1 if it didn't exit normally)
+    int runCommand(const std::string& command, std::string& standardOutput, std::string& standardError);
+
+    // a fresh directory, which is removed (with its content) when the object is destroyed
+    class TemporaryDirectory
+    {
+    public:
+        TemporaryDirectory();
+        ~TemporaryDirectory();
+        TemporaryDirectory(const TemporaryDirectory&) = delete;
+        TemporaryDirectory& operator=(const TemporaryDirectory&) = delete;
+
+        const std::string path;
+    };
+}
+
+#define TEST(group, name) \
+    static void group##_##name(); \
+    static test::Registration group##_##name##_registration(#group, #name, &group##_##name); \
+    static void group##_##name()
+
+#define CHECK(condition) \
+    do { if (!(condition)) { test::fail(__FILE__, __LINE__, #condition); } } while (false)
+
+#define CHECK_EQUAL(actual, expected) \
+    test::checkEqual((actual), (expected), #actual " == " #expected, __FILE__, __LINE__)
+
+#endif
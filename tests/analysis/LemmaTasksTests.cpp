@@ -0,0 +1,57 @@
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Formula.hpp"
+#include "LemmaTasks.hpp"
+#include "Sort.hpp"
+#include "Term.hpp"
+#include "Test.hpp"
+#include "Theory.hpp"
+#include "ThreadPool.hpp"
+
+using namespace analysis;
+
+namespace {
+
+    // task i generates i lemmas, and the tasks finish in reverse order (if run concurrently)
+    std::vector<LemmaTask> tasks(int numberOfTasks)
+    {
+        std::vector<LemmaTask> tasks;
+        for (int i = 0; i < numberOfTasks; i++)
+        {
+            tasks.push_back(LemmaTask{"family " + std::to_string(i % 3), [=](std::vector<std::shared_ptr<const logic::Formula>>& lemmas) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(2 * (numberOfTasks - i)));
+                for (int j = 0; j < i; j++)
+                {
+                    auto term = logic::Terms::func("task" + std::to_string(i), {}, logic::Sorts::intSort());
+                    lemmas.push_back(logic::Theory::intLess(term, logic::Theory::intConstant(j)));
+                }
+            }});
+        }
+        return tasks;
+    }
+}
+
+TEST(lemmatasks, LemmasAreReturnedInTheOrderOfTheTasks)
+{
+    const int numberOfTasks = 12;
+    util::ThreadPool sequential(1);
+    std::vector<std::string> expectedFamilies;
+    auto expected = runLemmaTasks(tasks(numberOfTasks), sequential, &expectedFamilies);
+    CHECK_EQUAL(expected.size(), static_cast<size_t>(numberOfTasks * (numberOfTasks - 1) / 2));
+    CHECK_EQUAL(expectedFamilies.size(), expected.size());
+    CHECK(expected[0] == logic::Theory::intLess(logic::Terms::func("task1", {}, logic::Sorts::intSort()), logic::Theory::intConstant(0)));
+    CHECK_EQUAL(expectedFamilies[0], "family 1");
+
+    for (unsigned numberOfThreads : {2u, 4u})
+    {
+        util::ThreadPool threadPool(numberOfThreads);
+        std::vector<std::string> families;
+        auto lemmas = runLemmaTasks(tasks(numberOfTasks), threadPool, &families);
+        CHECK(lemmas == expected);
+        CHECK(families == expectedFamilies);
+    }
+}
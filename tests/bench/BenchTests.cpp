@@ -0,0 +1,59 @@
+#include <string>
+
+#include "JSON.hpp"
+#include "Test.hpp"
+
+namespace {
+
+    std::string spectreBench(const std::string& arguments)
+    {
+        return "'" + std::string(SPECTRE_BENCH_EXECUTABLE) + "' " + arguments;
+    }
+}
+
+TEST(bench, TinyCorpusIsReportedAsJSON)
+{
+    std::string output, errors;
+    CHECK_EQUAL(test::runCommand(spectreBench("-statements 5,10 -depth 1 -twotraces both -format json"), output, errors), 0);
+    auto results = test::parseJSON(output);
+    CHECK(results.kind == test::JSONValue::Kind::Array);
+    // one result per combination of the parameters
+    CHECK_EQUAL(results.elements.size(), 4u);
+    for (const auto& result : results.elements)
+    {
+        CHECK(!result.has("failed"));
+        for (const auto& stage : {"parse", "semantics", "traceLemmas", "staticAnalysis", "output"})
+        {
+            CHECK(result["stages"].has(stage));
+            CHECK(result["stages"][stage]["wall"].number >= 0);
+            CHECK(result["stages"][stage]["maxResidentKB"].number > 0);
+        }
+        CHECK(result["lemmas"].number > 0);
+        CHECK(result["outputBytes"].number > 0);
+    }
+    CHECK_EQUAL(results.elements[0]["statements"].number, 5);
+    CHECK(!results.elements[0]["twoTraces"].boolean);
+    CHECK(results.elements[1]["twoTraces"].boolean);
+}
+
+TEST(bench, OptionsArePassedOnToSpectre)
+{
+    std::string output, errors;
+    CHECK_EQUAL(test::runCommand(spectreBench("-statements 5 -depth 1 -format json -simplify off -filterlemmas off"), output, errors), 0);
+    auto results = test::parseJSON(output);
+    const auto& stages = results.elements.at(0)["stages"];
+    CHECK(!stages.has("simplification"));
+    CHECK(!stages.has("lemmaFilter"));
+
+    // the table has a header, a row per stage and a summary
+    CHECK_EQUAL(test::runCommand(spectreBench("-statements 5 -depth 1"), output, errors), 0);
+    CHECK(output.find("statements") == 0);
+    CHECK(output.find("lemmas ") != std::string::npos);
+}
+
+TEST(bench, WrongOptionsAreRejected)
+{
+    std::string output, errors;
+    CHECK(test::runCommand(spectreBench("-statements five"), output, errors) != 0);
+    CHECK(errors.find("five is not a correct value for option -statements") != std::string::npos);
+}
@@ -0,0 +1,80 @@
+#!/bin/bash
+# checks the batch mode of spectre (cf. encodeBatch in src/main.cpp)
+# usage: batch.sh <spectre executable> <directory of tests/specs> <directory of tests/parser>
+
+# the paths may be relative, but the checks run in a temporary directory
+spectre=$(cd "$(dirname "$1")" && pwd)/$(basename "$1")
+specs=$(cd "$2" && pwd)
+errors=$(cd "$3" && pwd)
+
+work=$(mktemp -d "${TMPDIR:-/tmp}/spectre_batch.XXXXXX") || exit 1
+trap 'rm -rf "$work"' EXIT
+cd "$work" || exit 1
+
+failures=0
+fail()
+{
+    echo "FAIL: $*"
+    failures=$((failures + 1))
+}
+
+# checks that the encoding of each spec (relative to the spec directory) in the output directory equals the encoding of the spec alone
+checkEncodings() # <spec directory> <output directory> <spec>...
+{
+    local directory=$1
+    local output=$2
+    shift 2
+    for spec in "$@"; do
+        "$spectre" "$directory/$spec" > expected.smt2 2> /dev/null || fail "$directory/$spec can't be encoded alone"
+        cmp -s expected.smt2 "$output/${spec%.spec}.smt2" || fail "$output/${spec%.spec}.smt2 differs from the encoding of $directory/$spec alone"
+    done
+}
+
+mkdir -p specs/loops specs/hyper/arrays
+cp "$specs/nested-loops.spec" specs/loops/sum.spec
+cp "$specs/array-init.spec" specs/loops/init.spec
+cp "$specs/two-traces.spec" specs/hyper/arrays/max.spec
+cp "$specs/array-init.spec" specs/init.spec
+encoded="loops/sum.spec loops/init.spec hyper/arrays/max.spec init.spec"
+
+# a directory is searched recursively, and the encodings are written next to the specs
+"$spectre" -batch specs || fail "-batch specs failed"
+checkEncodings specs specs $encoded
+
+# with output, the encodings are written into the output directory, keeping the subdirectories of the specs
+"$spectre" -batch specs output out || fail "-batch specs output out failed"
+checkEncodings specs out $encoded
+
+# the paths in a list are relative to the current directory, and the output directory mirrors their directories
+printf "specs/loops/sum.spec\nspecs/hyper/arrays/max.spec\n\n./specs/init.spec\n" > list
+"$spectre" -batch list output listed || fail "-batch list output listed failed"
+checkEncodings . listed specs/loops/sum.spec specs/hyper/arrays/max.spec specs/init.spec
+[ "$(find listed -name '*.smt2' | wc -l)" -eq 3 ] || fail "-batch list output listed didn't write exactly the listed specs"
+
+# specs which would be written into the same file are rejected before anything is encoded
+printf "specs/init.spec\nspecs/loops/../init.spec\n" > duplicates
+"$spectre" -batch duplicates output rejected 2> /dev/null && fail "-batch accepted two specs with the same output file"
+[ ! -e rejected ] || fail "-batch encoded specs although two specs have the same output file"
+
+# the encodings don't depend on the number of specs encoded concurrently (nor on the number of threads per spec)
+for i in 1 2 3 4 5 6; do
+    cp "$specs/nested-loops.spec" "specs/loops/sum$i.spec"
+done
+"$spectre" -batch specs output sequential || fail "-batch specs output sequential failed"
+"$spectre" -batch specs output concurrent -j 3 || fail "-batch specs output concurrent -j 3 failed"
+"$spectre" -batch specs output threads -j 4 -threads 2 || fail "-batch specs output threads -j 4 -threads 2 failed"
+diff -r sequential concurrent > /dev/null || fail "the encodings with -j 3 differ from the encodings with -j 1"
+diff -r sequential threads > /dev/null || fail "the encodings with -j 4 -threads 2 differ from the encodings with -j 1"
+checkEncodings specs concurrent $encoded loops/sum6.spec
+
+# a spec which can't be parsed fails the batch and leaves no encoding behind, but the other specs are still encoded
+cp "$errors"/error-smtlib-lt.spec specs/loops/error.spec
+"$spectre" -batch specs output partial -j 2 2> /dev/null && fail "-batch succeeded although a spec can't be parsed"
+[ ! -e partial/loops/error.smt2 ] || fail "-batch left an encoding of a spec which can't be parsed"
+checkEncodings specs partial $encoded
+
+if [ $failures -ne 0 ]; then
+    echo "$failures checks failed"
+    exit 1
+fi
+echo "all checks passed"
@@ -0,0 +1,35 @@
+#!/bin/bash
+# checks that the encodings of spectre are byte-identical across processes, for all options affecting the output
+# usage: determinism.sh <spectre executable> <directory of tests/specs>
+
+# the paths may be relative, but the checks run in a temporary directory
+spectre=$(cd "$(dirname "$1")" && pwd)/$(basename "$1")
+specs=$(cd "$2" && pwd)
+
+work=$(mktemp -d "${TMPDIR:-/tmp}/spectre_determinism.XXXXXX") || exit 1
+trap 'rm -rf "$work"' EXIT
+cd "$work" || exit 1
+
+failures=0
+fail()
+{
+    echo "FAIL: $*"
+    failures=$((failures + 1))
+}
+
+for spec in "$specs"/*.spec; do
+    for options in "" "-sharing let" "-sharing define-fun" "-compact on -labels off" "-simplify off -filterlemmas off"; do
+        "$spectre" $options "$spec" > first.smt2 || fail "$spec can't be encoded with options '$options'"
+        # the objects are allocated at other addresses in other processes (and with other numbers of threads)
+        for threads in 1 2 3; do
+            MALLOC_PERTURB_=$((threads * 37)) "$spectre" $options -threads $threads "$spec" > again.smt2 || fail "$spec can't be encoded with options '$options -threads $threads'"
+            cmp -s first.smt2 again.smt2 || fail "the encoding of $spec with options '$options -threads $threads' differs between processes"
+        done
+    done
+done
+
+if [ $failures -ne 0 ]; then
+    echo "$failures checks failed"
+    exit 1
+fi
+echo "all checks passed"
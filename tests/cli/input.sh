@@ -0,0 +1,45 @@
+#!/bin/bash
+# checks that spectre reads specs from files and from stdin alike, and rejects specs which can't be parsed
+# usage: input.sh <spectre executable> <directory of tests/specs> <directory of tests/parser>
+
+# the paths may be relative, but the checks run in a temporary directory
+spectre=$(cd "$(dirname "$1")" && pwd)/$(basename "$1")
+specs=$(cd "$2" && pwd)
+errors=$(cd "$3" && pwd)
+
+work=$(mktemp -d "${TMPDIR:-/tmp}/spectre_input.XXXXXX") || exit 1
+trap 'rm -rf "$work"' EXIT
+cd "$work" || exit 1
+
+failures=0
+fail()
+{
+    echo "FAIL: $*"
+    failures=$((failures + 1))
+}
+
+# the encoding of a spec doesn't depend on whether it is read from a file or from stdin
+for spec in "$specs"/*.spec; do
+    "$spectre" "$spec" > file.smt2 || fail "$spec can't be encoded"
+    "$spectre" - < "$spec" > stdin.smt2 || fail "$spec can't be encoded from stdin"
+    [ -s file.smt2 ] || fail "the encoding of $spec is empty"
+    cmp -s file.smt2 stdin.smt2 || fail "the encoding of $spec differs when read from stdin"
+done
+
+# specs which can't be parsed are rejected with an error message containing the location of the error
+: > empty.spec
+for spec in "$errors"/*.spec "$(pwd)/empty.spec"; do
+    "$spectre" "$spec" > output.smt2 2> error.txt && fail "$spec was encoded although it can't be parsed"
+    grep -q "^$spec: Error while parsing location" error.txt || fail "the error message for $spec doesn't contain the location"
+    "$spectre" - < "$spec" > output.smt2 2> error.txt && fail "$spec was encoded from stdin although it can't be parsed"
+    grep -q "^stdin: Error while parsing location" error.txt || fail "the error message for $spec read from stdin doesn't contain the location"
+done
+
+# files which can't be read are rejected
+"$spectre" missing.spec > output.smt2 2> /dev/null && fail "a missing spec was encoded"
+
+if [ $failures -ne 0 ]; then
+    echo "$failures checks failed"
+    exit 1
+fi
+echo "all checks passed"
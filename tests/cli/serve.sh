@@ -0,0 +1,62 @@
+#!/bin/bash
+# checks that spectre -serve stdin answers each request with the encoding of spectre on the same spec and options
+# usage: serve.sh <spectre executable> <directory of tests/specs>
+
+# the paths may be relative, but the checks run in a temporary directory
+spectre=$(cd "$(dirname "$1")" && pwd)/$(basename "$1")
+specs=$(cd "$2" && pwd)
+
+work=$(mktemp -d "${TMPDIR:-/tmp}/spectre_serve.XXXXXX") || exit 1
+trap 'rm -rf "$work"' EXIT
+cd "$work" || exit 1
+
+failures=0
+fail()
+{
+    echo "FAIL: $*"
+    failures=$((failures + 1))
+}
+
+for options in "" "-sharing let" "-sharing define-fun -compact on" "-threads 2 -labels off"; do
+    : > requests
+    : > expected
+    # each spec is requested twice
+    for spec in "$specs"/*.spec "$specs"/*.spec; do
+        printf "%d\n" "$(wc -c < "$spec")" >> requests
+        cat "$spec" >> requests
+        "$spectre" $options "$spec" > encoding.smt2 || fail "$spec can't be encoded with options '$options'"
+        printf "ok %d\n" "$(wc -c < encoding.smt2)" >> expected
+        cat encoding.smt2 >> expected
+    done
+    "$spectre" -serve stdin $options < requests > responses || fail "-serve stdin $options failed"
+    cmp -s expected responses || fail "the responses of -serve stdin $options differ from the encodings of spectre $options"
+done
+
+# a malformed request is answered by an error, and ends the server
+printf "12a\n" | "$spectre" -serve stdin > responses && fail "-serve stdin succeeded on a malformed request"
+printf "error 17\nmalformed request" | cmp -s - responses || fail "the response to a malformed request is wrong"
+
+# -serve on a path which isn't a socket fails and keeps the file
+echo notes > notes.txt
+"$spectre" -serve notes.txt 2> /dev/null && fail "-serve succeeded on a regular file"
+[ "$(cat notes.txt)" = notes ] || fail "-serve replaced a regular file"
+
+# the socket left behind by a killed server is replaced by the next server
+"$spectre" -serve server.sock 2> /dev/null &
+server=$!
+sleep 1
+kill -9 $server 2> /dev/null
+wait $server 2> /dev/null
+[ -S server.sock ] || fail "-serve didn't create the socket server.sock"
+"$spectre" -serve server.sock 2> /dev/null &
+server=$!
+sleep 1
+kill -0 $server 2> /dev/null || fail "-serve didn't replace the stale socket server.sock"
+kill -9 $server 2> /dev/null
+wait $server 2> /dev/null
+
+if [ $failures -ne 0 ]; then
+    echo "$failures checks failed"
+    exit 1
+fi
+echo "all checks passed"
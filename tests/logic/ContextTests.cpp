@@ -0,0 +1,134 @@
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Context.hpp"
+#include "Formula.hpp"
+#include "Signature.hpp"
+#include "Sort.hpp"
+#include "Term.hpp"
+#include "Test.hpp"
+#include "Theory.hpp"
+
+using namespace logic;
+
+namespace {
+
+    std::shared_ptr<Context> baseWithTheories()
+    {
+        auto base = std::make_shared<Context>();
+        Context::Scope scope(*base);
+        Theory::declareTheories();
+        Terms::func("shared", {}, Sorts::intSort());
+        return base;
+    }
+
+    bool contains(const std::vector<std::shared_ptr<const Symbol>>& symbols, const std::string& name)
+    {
+        return std::any_of(symbols.begin(), symbols.end(), [&](const std::shared_ptr<const Symbol>& symbol) { return symbol->name == name; });
+    }
+}
+
+TEST(context, ContextsAreIndependent)
+{
+    Context first;
+    Context second;
+    {
+        Context::Scope scope(first);
+        Terms::func("only_first", {}, Sorts::intSort());
+        CHECK(Signature::isDeclared("only_first"));
+    }
+    {
+        Context::Scope scope(second);
+        CHECK(!Signature::isDeclared("only_first"));
+        CHECK_EQUAL(Terms::numberOfTerms(), 0u);
+    }
+}
+
+TEST(context, OverlaysShareTheObjectsOfTheirBase)
+{
+    auto base = baseWithTheories();
+    size_t numberOfBaseTerms;
+    const Term* sharedInBase;
+    const Formula* trueInBase;
+    {
+        Context::Scope scope(*base);
+        numberOfBaseTerms = Terms::numberOfTerms();
+        sharedInBase = Terms::func("shared", {}, Sorts::intSort()).get();
+        trueInBase = Theory::boolTrue().get();
+    }
+
+    Context overlay(base);
+    CHECK(base->isFrozen());
+    CHECK(!overlay.isFrozen());
+    Context::Scope scope(overlay);
+    CHECK(Terms::func("shared", {}, Sorts::intSort()).get() == sharedInBase);
+    CHECK(Theory::boolTrue().get() == trueInBase);
+    CHECK_EQUAL(Terms::numberOfTerms(), numberOfBaseTerms);
+
+    auto own = Theory::intAddition(Terms::func("shared", {}, Sorts::intSort()), Terms::func("own", {}, Sorts::intSort()));
+    CHECK_EQUAL(Terms::numberOfTerms(), numberOfBaseTerms + 2);
+    CHECK(Signature::fetch(own->symbol->id) == own->symbol);
+    CHECK(Signature::fetch(sharedInBase->symbol->id).get() == sharedInBase->symbol.get());
+    auto signature = Signature::signature();
+    CHECK(contains(signature, "shared"));
+    CHECK(contains(signature, "own"));
+}
+
+TEST(context, OverlaysDontSeeEachOther)
+{
+    auto base = baseWithTheories();
+    Context first(base);
+    Context second(base);
+    unsigned firstId;
+    {
+        Context::Scope scope(first);
+        firstId = Terms::func("own", {}, Sorts::intSort())->symbol->id;
+    }
+    {
+        Context::Scope scope(second);
+        CHECK(!Signature::isDeclared("own"));
+        CHECK(!contains(Signature::signature(), "own"));
+        // symbols of different overlays get the same ids, which index into the symbols of their own overlay
+        auto own = Terms::func("own", {}, Sorts::intSort());
+        CHECK_EQUAL(own->symbol->id, firstId);
+        CHECK(Signature::fetch(own->symbol->id) == own->symbol);
+    }
+    {
+        Context::Scope scope(*base);
+        CHECK(!Signature::isDeclared("own"));
+    }
+}
+
+TEST(context, OverlaysCanBeUsedConcurrently)
+{
+    auto base = baseWithTheories();
+    // each object is constructed in its own overlay, so the threads only share the base
+    test::constructConcurrently(4, 50, [&](size_t i) {
+        Context overlay(base);
+        Context::Scope scope(overlay);
+        auto x = Signature::varSymbol("x", Sorts::intSort());
+        std::shared_ptr<const Formula> formula;
+        for (size_t k = 0; k <= i; k++)
+        {
+            auto term = Theory::intAddition(Terms::var(x), Terms::func("shared", {}, Sorts::intSort()));
+            formula = Formulas::universal({x}, Theory::intLess(term, Terms::func("bound" + std::to_string(k), {}, Sorts::intSort())));
+        }
+        return formula->toSMTLIB() + std::to_string(Signature::signature().size());
+    });
+}
+
+TEST(context, OverlaysKeepTheirBaseAlive)
+{
+    auto base = baseWithTheories();
+    std::weak_ptr<Context> weakBase = base;
+    {
+        Context overlay(base);
+        base.reset();
+        CHECK(!weakBase.expired());
+        Context::Scope scope(overlay);
+        CHECK(Signature::isDeclared("shared"));
+    }
+    CHECK(weakBase.expired());
+}
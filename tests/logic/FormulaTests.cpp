@@ -0,0 +1,86 @@
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Formula.hpp"
+#include "Signature.hpp"
+#include "Sort.hpp"
+#include "Term.hpp"
+#include "Test.hpp"
+#include "Theory.hpp"
+
+using namespace logic;
+
+namespace {
+
+    std::shared_ptr<const Formula> lessThanLength(const std::shared_ptr<const Symbol>& x, const std::string& label = "")
+    {
+        return Theory::intLess(Terms::var(x), Terms::func("len", {}, Sorts::intSort()), label);
+    }
+}
+
+TEST(formulas, EqualFormulasAreIdentical)
+{
+    auto x = Signature::varSymbol("x", Sorts::intSort());
+    auto f1 = Formulas::universal({x}, Formulas::conjunction({lessThanLength(x), Formulas::predicate("even", {Terms::var(x)})}));
+    auto f2 = Formulas::universal({x}, Formulas::conjunction({lessThanLength(x), Formulas::predicate("even", {Terms::var(x)})}));
+    CHECK(f1 == f2);
+    CHECK(Formulas::negation(f1) == Formulas::negation(f2));
+}
+
+TEST(formulas, DistinctFormulasAreDistinct)
+{
+    auto x = Signature::varSymbol("x", Sorts::intSort());
+    auto y = Signature::varSymbol("y", Sorts::intSort());
+    auto p = Formulas::predicate("even", {Terms::var(x)});
+    auto q = Formulas::predicate("odd", {Terms::var(x)});
+    CHECK(Formulas::conjunction({p, q}) != Formulas::conjunction({q, p}));
+    std::shared_ptr<const Formula> conjunction = Formulas::conjunction({p, q});
+    std::shared_ptr<const Formula> disjunction = Formulas::disjunction({p, q});
+    CHECK(conjunction != disjunction);
+    CHECK(Formulas::implication(p, q) != Formulas::implication(q, p));
+    CHECK(Formulas::universal({x}, p) != Formulas::existential({x}, p));
+    CHECK(Formulas::universal({x}, p) != Formulas::universal({y}, p));
+    CHECK(Formulas::equality(Terms::var(x), Terms::var(y)) != Formulas::equality(Terms::var(y), Terms::var(x)));
+}
+
+TEST(formulas, LabelsDistinguishFormulas)
+{
+    auto x = Signature::varSymbol("x", Sorts::intSort());
+    auto unlabeled = lessThanLength(x);
+    auto labeled = lessThanLength(x, "bound");
+    CHECK(labeled != unlabeled);
+    CHECK(labeled != lessThanLength(x, "other bound"));
+    CHECK(labeled == lessThanLength(x, "bound"));
+    CHECK_EQUAL(labeled->hash, unlabeled->hash);
+
+    // formulas which only differ in labels share their unlabeled version
+    CHECK(unlabeled->unlabeled() == unlabeled.get());
+    CHECK(labeled->unlabeled() == unlabeled.get());
+    auto conjunction = Formulas::conjunction({labeled, Formulas::predicate("even", {Terms::var(x)})}, "conjunction");
+    CHECK(conjunction->unlabeled() == Formulas::conjunction({unlabeled, Formulas::predicate("even", {Terms::var(x)})}).get());
+}
+
+TEST(formulas, RepeatedFormulasAreNotAllocatedAgain)
+{
+    auto x = Signature::varSymbol("x", Sorts::intSort());
+    test::checkConstructedOnce([&]() { return Formulas::universal({x}, lessThanLength(x, "bound")); }, &Formulas::numberOfFormulas);
+}
+
+TEST(formulas, ConcurrentThreadsConstructEachFormulaOnce)
+{
+    auto formulas = test::constructConcurrently(4, 500, [](size_t i) {
+        auto x = Signature::varSymbol("x", Sorts::intSort());
+        auto bound = Terms::func("bound" + std::to_string(i % 10), {}, Sorts::intSort());
+        auto term = Theory::intAddition(Terms::var(x), Theory::intConstant(static_cast<int>(i)));
+        return Formulas::universal({x}, Formulas::implication(Theory::intLess(term, bound), Formulas::predicate("even", {term}), "lemma " + std::to_string(i % 3)));
+    });
+
+    // constructing the formulas again doesn't add any formula
+    auto numberOfConstructedFormulas = Formulas::numberOfFormulas();
+    auto x = Signature::varSymbol("x", Sorts::intSort());
+    auto term = Theory::intAddition(Terms::var(x), Theory::intConstant(7));
+    auto formula = Formulas::universal({x}, Formulas::implication(Theory::intLess(term, Terms::func("bound7", {}, Sorts::intSort())), Formulas::predicate("even", {term}), "lemma 1"));
+    CHECK(formula == formulas[7]);
+    CHECK_EQUAL(Formulas::numberOfFormulas(), numberOfConstructedFormulas);
+}
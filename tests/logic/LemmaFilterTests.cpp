@@ -0,0 +1,127 @@
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Formula.hpp"
+#include "LemmaFilter.hpp"
+#include "Problem.hpp"
+#include "Signature.hpp"
+#include "Sort.hpp"
+#include "Term.hpp"
+#include "Test.hpp"
+#include "Theory.hpp"
+
+using namespace logic;
+
+namespace {
+
+    std::shared_ptr<const Term> value(const std::shared_ptr<const Term>& index)
+    {
+        return Terms::func("value", {index}, Sorts::intSort());
+    }
+
+    std::shared_ptr<const Formula> positive(const std::shared_ptr<const Term>& t, const std::string& label = "")
+    {
+        return Formulas::predicate("positive", {t}, label);
+    }
+
+    std::shared_ptr<const Formula> bounded(const std::shared_ptr<const Term>& t)
+    {
+        return Formulas::predicate("bounded", {t});
+    }
+
+    // filters the lemmas of a problem with the given axioms, and checks which lemmas remain
+    void checkFilter(const std::vector<std::shared_ptr<const Formula>>& axioms,
+                     const std::vector<std::shared_ptr<const Formula>>& lemmas,
+                     const std::vector<size_t>& remaining,
+                     unsigned numberOfDuplicates,
+                     unsigned numberOfSubsumed)
+    {
+        Problem problem;
+        problem.axioms = axioms;
+        problem.lemmas = lemmas;
+        for (size_t i = 0; i < lemmas.size(); ++i)
+        {
+            problem.lemmaFamilies.push_back("family " + std::to_string(i));
+        }
+        problem.conjecture = Theory::boolFalse();
+
+        LemmaFilter filter;
+        filter.filter(problem);
+        CHECK_EQUAL(filter.numberOfDuplicates, numberOfDuplicates);
+        CHECK_EQUAL(filter.numberOfSubsumed, numberOfSubsumed);
+        CHECK_EQUAL(problem.lemmas.size(), remaining.size());
+        CHECK_EQUAL(problem.lemmaFamilies.size(), remaining.size());
+        for (size_t i = 0; i < remaining.size(); ++i)
+        {
+            CHECK(problem.lemmas[i] == lemmas[remaining[i]]);
+            CHECK_EQUAL(problem.lemmaFamilies[i], "family " + std::to_string(remaining[i]));
+        }
+        CHECK(problem.axioms == axioms);
+    }
+}
+
+TEST(lemmafilter, DuplicatesUpToRenamingAndLabelsAreRemoved)
+{
+    auto x = Signature::varSymbol("x", Sorts::intSort());
+    auto y = Signature::varSymbol("y", Sorts::intSort());
+    auto lemma = Formulas::universal({x}, Formulas::implication(bounded(Terms::var(x)), positive(value(Terms::var(x)))), "first lemma");
+    auto renamed = Formulas::universal({y}, Formulas::implication(bounded(Terms::var(y)), positive(value(Terms::var(y)), "conclusion")), "second lemma");
+    auto other = Formulas::universal({x}, Formulas::implication(positive(value(Terms::var(x))), bounded(Terms::var(x))));
+    checkFilter({}, {lemma, other, renamed, lemma}, {0, 1}, 2, 0);
+}
+
+TEST(lemmafilter, DifferentBindingsAreNoDuplicates)
+{
+    auto x = Signature::varSymbol("x", Sorts::intSort());
+    auto y = Signature::varSymbol("y", Sorts::intSort());
+    auto c = Terms::func("c", {}, Sorts::intSort());
+    auto sum = [](const std::shared_ptr<const Term>& t1, const std::shared_ptr<const Term>& t2) { return Theory::intAddition(t1, t2); };
+    auto lemmas = std::vector<std::shared_ptr<const Formula>>{
+        Formulas::universal({x}, Formulas::implication(bounded(Terms::var(x)), positive(sum(Terms::var(x), c)))),
+        Formulas::universal({x}, Formulas::implication(bounded(Terms::var(x)), positive(sum(c, Terms::var(x))))),
+        Formulas::universal({x, y}, Formulas::implication(bounded(Terms::var(x)), positive(sum(Terms::var(x), Terms::var(y))))),
+        Formulas::universal({x, y}, Formulas::implication(bounded(Terms::var(x)), positive(sum(Terms::var(y), Terms::var(x))))),
+        Formulas::existential({x}, Formulas::implication(bounded(Terms::var(x)), positive(sum(Terms::var(x), c))))
+    };
+    checkFilter({}, lemmas, {0, 1, 2, 3, 4}, 0, 0);
+}
+
+TEST(lemmafilter, InstancesOfAxiomsAreRemoved)
+{
+    // the axiom asserts that value is constant, e.g. as asserted by the static analysis for a variable which isn't changed by a loop
+    auto n = Signature::varSymbol("n", Sorts::intSort());
+    auto k = Signature::varSymbol("k", Sorts::intSort());
+    auto zero = Theory::intConstant(0);
+    auto axiom = Formulas::universal({n}, Formulas::conjunction({Formulas::equality(value(Terms::var(n)), value(zero)), bounded(Terms::var(n))}));
+    auto lemmas = std::vector<std::shared_ptr<const Formula>>{
+        Formulas::universal({k}, Formulas::implication(Theory::intLessEqual(zero, Terms::var(k)), Formulas::equality(value(Terms::var(k)), value(zero)))),
+        // equalities are matched modulo symmetry
+        Formulas::universal({k}, Formulas::equality(value(zero), value(Terms::var(k)))),
+        Formulas::universal({k}, Formulas::implication(positive(Terms::var(k)), Formulas::conjunction({bounded(Theory::intAddition(Terms::var(k), zero)), Formulas::equality(value(zero), value(Terms::var(k)))}))),
+        // not an instance: the conclusion contains an atom which isn't asserted
+        Formulas::universal({k}, Formulas::implication(positive(Terms::var(k)), Formulas::conjunction({bounded(Terms::var(k)), positive(value(Terms::var(k)))}))),
+        // not an instance: the polarity differs
+        Formulas::universal({k}, Formulas::disequality(value(Terms::var(k)), value(zero)))
+    };
+    checkFilter({axiom}, lemmas, {3, 4}, 0, 3);
+}
+
+TEST(lemmafilter, OnlyRemainingLemmasSubsumeOtherLemmas)
+{
+    auto x = Signature::varSymbol("x", Sorts::intSort());
+    auto c = Terms::func("c", {}, Sorts::intSort());
+    auto general = Formulas::universal({x}, positive(value(Terms::var(x))));
+    auto instance = positive(value(c));
+    // the instance is removed, no matter in which order the lemmas occur
+    checkFilter({}, {general, instance}, {0}, 0, 1);
+    checkFilter({}, {instance, general}, {1}, 0, 1);
+
+    // a lemma doesn't subsume itself
+    checkFilter({}, {general}, {0}, 0, 0);
+
+    // from two lemmas subsuming each other only the first one is removed
+    auto first = Formulas::universal({x}, Formulas::conjunction({positive(Terms::var(x)), bounded(Terms::var(x))}));
+    auto second = Formulas::universal({x}, Formulas::conjunction({bounded(Terms::var(x)), positive(Terms::var(x))}));
+    checkFilter({}, {first, second}, {1}, 0, 1);
+}
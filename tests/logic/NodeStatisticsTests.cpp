@@ -0,0 +1,91 @@
+#include <cstddef>
+#include <sstream>
+#include <string>
+
+#include "Context.hpp"
+#include "Formula.hpp"
+#include "NodeStatistics.hpp"
+#include "Signature.hpp"
+#include "Sort.hpp"
+#include "Term.hpp"
+#include "Test.hpp"
+#include "Theory.hpp"
+
+using namespace logic;
+
+// the counters only exist in builds configured with -DSPECTRE_NODE_STATISTICS=ON, which are the only builds running this group
+#ifdef SPECTRE_NODE_STATISTICS
+
+namespace {
+
+    const NodeKind countedKinds[] = {NodeKind::Symbol, NodeKind::FuncTerm, NodeKind::PredicateFormula};
+}
+
+TEST(nodestatistics, NodesAreCountedUntilTheirContextIsDestroyed)
+{
+    const size_t numberOfNodes = 100;
+    size_t liveBefore[3], totalBefore[3];
+    for (size_t k = 0; k < 3; k++)
+    {
+        liveBefore[k] = NodeStatistics::live(countedKinds[k]);
+        totalBefore[k] = NodeStatistics::total(countedKinds[k]);
+    }
+    {
+        Context context;
+        Context::Scope scope(context);
+        // each iteration constructs a new symbol, a new term and a new formula
+        for (size_t i = 0; i < numberOfNodes; i++)
+        {
+            auto constant = Terms::func("counted" + std::to_string(i), {}, Sorts::intSort());
+            Formulas::predicate("positive", {constant});
+        }
+        for (size_t k = 0; k < 3; k++)
+        {
+            auto kind = countedKinds[k];
+            CHECK(NodeStatistics::live(kind) >= liveBefore[k] + numberOfNodes);
+            CHECK(NodeStatistics::peak(kind) >= NodeStatistics::live(kind));
+            CHECK(NodeStatistics::total(kind) >= totalBefore[k] + numberOfNodes);
+        }
+    }
+    // destroying the context frees all of its nodes, while the nodes of the test case's context are still alive
+    for (size_t k = 0; k < 3; k++)
+    {
+        CHECK_EQUAL(NodeStatistics::live(countedKinds[k]), liveBefore[k]);
+        CHECK(NodeStatistics::peak(countedKinds[k]) >= liveBefore[k] + numberOfNodes);
+    }
+}
+
+TEST(nodestatistics, RepeatedNodesAreNotCounted)
+{
+    auto x = Signature::varSymbol("x", Sorts::intSort());
+    auto formula = Formulas::universal({x}, Formulas::predicate("positive", {Terms::var(x)}));
+    auto liveFormulas = NodeStatistics::live(NodeKind::UniversalFormula);
+    auto liveTerms = NodeStatistics::live(NodeKind::LVariable);
+    for (int k = 0; k < 10; k++)
+    {
+        CHECK(Formulas::universal({x}, Formulas::predicate("positive", {Terms::var(x)})) == formula);
+    }
+    // a node constructed again is either found before it is allocated, or freed right away
+    CHECK_EQUAL(NodeStatistics::live(NodeKind::UniversalFormula), liveFormulas);
+    CHECK_EQUAL(NodeStatistics::live(NodeKind::LVariable), liveTerms);
+}
+
+TEST(nodestatistics, AllNodesAreFreedAtExit)
+{
+    std::string output, errors;
+    CHECK_EQUAL(test::runCommand("'" + std::string(SPECTRE_EXECUTABLE) + "' '" + test::specPath("nested-loops.spec") + "'", output, errors), 0);
+    // the last row of the table sums up all kinds: all, total, live, peak, live bytes, peak bytes
+    auto row = errors.find("  all ");
+    CHECK(row != std::string::npos);
+    std::istringstream sums(errors.substr(row));
+    std::string name;
+    size_t total, live, peak, liveBytes, peakBytes;
+    CHECK(static_cast<bool>(sums >> name >> total >> live >> peak >> liveBytes >> peakBytes));
+    CHECK_EQUAL(live, 0u);
+    CHECK_EQUAL(liveBytes, 0u);
+    CHECK(peak > 0);
+    CHECK(total >= peak);
+    CHECK(peakBytes > 0);
+}
+
+#endif
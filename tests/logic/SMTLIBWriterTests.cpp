@@ -0,0 +1,104 @@
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Formula.hpp"
+#include "SExpression.hpp"
+#include "SMTLIBWriter.hpp"
+#include "Signature.hpp"
+#include "Sort.hpp"
+#include "Term.hpp"
+#include "Test.hpp"
+#include "Theory.hpp"
+
+using namespace logic;
+
+namespace {
+
+    std::string write(const std::vector<std::shared_ptr<const Formula>>& formulas, SMTLIBWriter::Sharing sharing, bool compact = false)
+    {
+        std::stringstream output;
+        SMTLIBWriter writer(output, sharing, compact);
+        writer.writeDefinitions(formulas);
+        for (const auto& formula : formulas)
+        {
+            writer.writeAssertion("assert", *formula);
+        }
+        return output.str();
+    }
+
+    // formulas with repeated ground and non-ground subterms, which are large enough to be worth sharing
+    std::vector<std::shared_ptr<const Formula>> formulasWithRepeatedSubterms()
+    {
+        auto x = Signature::varSymbol("x", Sorts::intSort());
+        auto y = Signature::varSymbol("y", Sorts::intSort());
+        auto ground = Terms::func("length_of", {Theory::intAddition(Terms::func("constant", {}, Sorts::intSort()), Theory::intConstant(1))}, Sorts::intSort());
+        auto gx = Terms::func("index_of", {Terms::var(x)}, Sorts::intSort());
+        auto fgx = Terms::func("value_at", {gx, ground}, Sorts::intSort());
+        auto fgy = Terms::func("value_at", {Terms::func("index_of", {Terms::var(y)}, Sorts::intSort()), ground}, Sorts::intSort());
+        return {
+            Formulas::universal({x}, Formulas::conjunction({
+                Formulas::equality(Terms::func("successor_of", {fgx}, Sorts::intSort()), fgx),
+                Theory::intLess(ground, gx),
+                Formulas::universal({y}, Theory::intLess(fgy, Theory::intAddition(fgy, fgx)), "inner")
+            }), "outer"),
+            Theory::intLess(ground, Terms::func("successor_of", {ground}, Sorts::intSort()))
+        };
+    }
+}
+
+TEST(smtlibwriter, LetBindingsExpandToTheUnsharedOutput)
+{
+    auto formulas = formulasWithRepeatedSubterms();
+    auto unshared = write(formulas, SMTLIBWriter::Sharing::None);
+    auto shared = write(formulas, SMTLIBWriter::Sharing::Let);
+    CHECK(shared.find("(let ((|Let#0|") != std::string::npos);
+    CHECK(shared.size() < unshared.size());
+    CHECK_EQUAL(test::expandSharing(shared), test::expandSharing(unshared));
+    CHECK_EQUAL(test::expandSharing(write(formulas, SMTLIBWriter::Sharing::Let, true)), test::expandSharing(unshared));
+}
+
+TEST(smtlibwriter, DefinitionsExpandToTheUnsharedOutput)
+{
+    auto formulas = formulasWithRepeatedSubterms();
+    auto unshared = write(formulas, SMTLIBWriter::Sharing::None);
+    auto shared = write(formulas, SMTLIBWriter::Sharing::DefineFun);
+    CHECK(shared.find("(define-fun |Def#0| () Int") != std::string::npos);
+    CHECK_EQUAL(test::expandSharing(shared), test::expandSharing(unshared));
+}
+
+TEST(smtlibwriter, ShadowedVariablesAreNotCaptured)
+{
+    // the inner quantifier rebinds x, so g(x) denotes different values inside and outside of it
+    auto x = Signature::varSymbol("x", Sorts::intSort());
+    auto gx = Terms::func("index_of", {Terms::var(x)}, Sorts::intSort());
+    auto repeated = Formulas::conjunction({Theory::intLess(gx, gx), Theory::intGreater(gx, gx), Theory::intLessEqual(gx, gx)});
+    std::vector<std::shared_ptr<const Formula>> formulas = {
+        Formulas::universal({x}, Formulas::conjunction({repeated, Formulas::universal({x}, repeated)}))
+    };
+    auto unshared = write(formulas, SMTLIBWriter::Sharing::None);
+    auto shared = write(formulas, SMTLIBWriter::Sharing::Let);
+    CHECK(shared.find("|Let#1|") != std::string::npos);
+    CHECK_EQUAL(test::expandSharing(shared), test::expandSharing(unshared));
+    CHECK_EQUAL(test::expandSharing(write(formulas, SMTLIBWriter::Sharing::DefineFun)), test::expandSharing(unshared));
+}
+
+TEST(smtlibwriter, BindingNamesDontClashWithSymbols)
+{
+    // the names of bindings contain a #, which can't occur in the names of symbols
+    auto let0 = Terms::func("Let0", {}, Sorts::intSort());
+    auto def0 = Terms::func("Def0", {}, Sorts::intSort());
+    auto sum = Theory::intAddition(let0, def0);
+    auto repeated = Theory::intAddition(sum, Theory::intConstant(1));
+    std::vector<std::shared_ptr<const Formula>> formulas = {
+        Formulas::conjunction({Theory::intLess(repeated, repeated), Theory::intGreater(repeated, repeated)})
+    };
+    auto unshared = write(formulas, SMTLIBWriter::Sharing::None);
+    auto let = write(formulas, SMTLIBWriter::Sharing::Let);
+    auto defineFun = write(formulas, SMTLIBWriter::Sharing::DefineFun);
+    CHECK(let.find("|Let#0|") != std::string::npos);
+    CHECK(defineFun.find("|Def#0|") != std::string::npos);
+    CHECK_EQUAL(test::expandSharing(let), test::expandSharing(unshared));
+    CHECK_EQUAL(test::expandSharing(defineFun), test::expandSharing(unshared));
+}
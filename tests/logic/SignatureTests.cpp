@@ -0,0 +1,77 @@
+#include <algorithm>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "Signature.hpp"
+#include "Sort.hpp"
+#include "Test.hpp"
+
+using namespace logic;
+
+TEST(signature, SymbolsAreFetchedByNameAndId)
+{
+    auto alpha = Signature::add("alpha", {Sorts::intSort()}, Sorts::intSort());
+    auto beta = Signature::add("beta", {}, Sorts::boolSort());
+    auto x = Signature::varSymbol("x", Sorts::intSort());
+    CHECK(Signature::fetch("alpha") == alpha);
+    CHECK(Signature::tryFetch("beta") == beta);
+    CHECK(Signature::tryFetch("gamma") == nullptr);
+    CHECK(Signature::fetchOrAdd("alpha", {Sorts::intSort()}, Sorts::intSort()) == alpha);
+    CHECK(Signature::varSymbol("x", Sorts::intSort()) == x);
+
+    CHECK(alpha->id != beta->id);
+    CHECK(alpha->id != x->id);
+    CHECK(Signature::fetch(alpha->id) == alpha);
+    CHECK(Signature::fetch(beta->id) == beta);
+    CHECK(Signature::fetch(x->id) == x);
+}
+
+TEST(signature, IdsStayValidAcrossChunks)
+{
+    std::vector<std::shared_ptr<const Symbol>> symbols;
+    for (int i = 0; i < 5000; i++)
+    {
+        symbols.push_back(Signature::add("symbol" + std::to_string(i), {}, Sorts::intSort()));
+    }
+    std::set<unsigned> ids;
+    for (const auto& symbol : symbols)
+    {
+        CHECK(Signature::fetch(symbol->id) == symbol);
+        ids.insert(symbol->id);
+    }
+    CHECK_EQUAL(ids.size(), symbols.size());
+}
+
+TEST(signature, SignatureIsOrderedByName)
+{
+    auto zeta = Signature::add("zeta", {}, Sorts::intSort());
+    auto eta = Signature::add("eta", {}, Sorts::intSort());
+    auto iota = Signature::add("iota", {}, Sorts::intSort());
+    auto signature = Signature::signature();
+    CHECK(std::is_sorted(signature.begin(), signature.end(), [](const std::shared_ptr<const Symbol>& s1, const std::shared_ptr<const Symbol>& s2) { return s1->name < s2->name; }));
+    for (const auto& symbol : {zeta, eta, iota})
+    {
+        CHECK(std::find(signature.begin(), signature.end(), symbol) != signature.end());
+    }
+    // variable symbols are not part of the signature
+    auto x = Signature::varSymbol("x", Sorts::intSort());
+    signature = Signature::signature();
+    CHECK(std::find(signature.begin(), signature.end(), x) == signature.end());
+}
+
+TEST(signature, ConcurrentThreadsAddEachSymbolOnce)
+{
+    auto symbols = test::constructConcurrently(4, 2000, [](size_t i) {
+        return Signature::fetchOrAdd("symbol" + std::to_string(i), {}, Sorts::intSort());
+    });
+
+    std::set<unsigned> ids;
+    for (const auto& symbol : symbols)
+    {
+        CHECK(Signature::fetch(symbol->id) == symbol);
+        ids.insert(symbol->id);
+    }
+    CHECK_EQUAL(ids.size(), symbols.size());
+}
@@ -0,0 +1,146 @@
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Formula.hpp"
+#include "Problem.hpp"
+#include "Signature.hpp"
+#include "Simplifier.hpp"
+#include "Sort.hpp"
+#include "Term.hpp"
+#include "Test.hpp"
+#include "Theory.hpp"
+
+using namespace logic;
+
+namespace {
+
+    std::shared_ptr<const Formula> atom(const std::string& name, const std::string& label = "")
+    {
+        return Formulas::predicate(name, {Terms::func("c", {}, Sorts::intSort())}, label);
+    }
+
+    std::shared_ptr<const Formula> simplify(const std::shared_ptr<const Formula>& f, bool keepLabels = true)
+    {
+        return Simplifier(keepLabels).simplify(f);
+    }
+}
+
+TEST(simplifier, JunctionsAreFlattenedWithoutDuplicates)
+{
+    auto a = atom("even");
+    auto b = atom("odd");
+    auto d = atom("positive");
+    std::shared_ptr<const Formula> flat = Formulas::conjunction({a, b, d});
+    CHECK(simplify(Formulas::conjunction({a, Formulas::conjunction({b, a}), Formulas::conjunction({d})})) == flat);
+    std::shared_ptr<const Formula> flatDisjunction = Formulas::disjunction({a, b});
+    CHECK(simplify(Formulas::disjunction({Formulas::disjunction({a, b}), b})) == flatDisjunction);
+    // a conjunction nested in a disjunction is not merged
+    std::shared_ptr<const Formula> mixed = Formulas::disjunction({a, Formulas::conjunction({b, d})});
+    CHECK(simplify(mixed) == mixed);
+}
+
+TEST(simplifier, ConstantsArePropagated)
+{
+    auto a = atom("even");
+    auto b = atom("odd");
+    auto t = Theory::boolTrue();
+    auto f = Theory::boolFalse();
+    CHECK(simplify(Formulas::conjunction({a, t, b})) == Formulas::conjunction({a, b}));
+    CHECK(simplify(Formulas::conjunction({a, f, b})) == f);
+    CHECK(simplify(Formulas::conjunction({t, t})) == t);
+    CHECK(simplify(Formulas::disjunction({a, f})) == a);
+    CHECK(simplify(Formulas::disjunction({a, t})) == t);
+    CHECK(simplify(Formulas::disjunction({f})) == f);
+    CHECK(simplify(Formulas::implication(t, a)) == a);
+    CHECK(simplify(Formulas::implication(f, a)) == t);
+    CHECK(simplify(Formulas::implication(a, t)) == t);
+    CHECK(simplify(Formulas::implication(a, f)) == Formulas::negation(a));
+    CHECK(simplify(Formulas::negation(t)) == f);
+    CHECK(simplify(Formulas::negation(Formulas::conjunction({a, f}))) == t);
+}
+
+TEST(simplifier, DoubleNegationsAreRemoved)
+{
+    auto a = atom("even");
+    CHECK(simplify(Formulas::negation(Formulas::negation(a))) == a);
+    CHECK(simplify(Formulas::negation(Formulas::negation(Formulas::negation(a)))) == Formulas::negation(a));
+    CHECK(simplify(Formulas::implication(Formulas::negation(a), Theory::boolFalse())) == a);
+}
+
+TEST(simplifier, UnusedQuantifiedVariablesAreRemoved)
+{
+    auto x = Signature::varSymbol("x", Sorts::intSort());
+    auto y = Signature::varSymbol("y", Sorts::intSort());
+    auto px = Formulas::predicate("even", {Terms::var(x)});
+    auto a = atom("odd");
+    CHECK(simplify(Formulas::universal({x, y}, px)) == Formulas::universal({x}, px));
+    CHECK(simplify(Formulas::existential({y, x}, px)) == Formulas::existential({x}, px));
+    CHECK(simplify(Formulas::universal({y}, a)) == a);
+    CHECK(simplify(Formulas::existential({x}, Formulas::disjunction({px, Theory::boolTrue()}))) == Theory::boolTrue());
+    // variables which only occur in nested quantifiers of the body still occur in the body
+    auto nested = Formulas::universal({x}, Formulas::existential({y}, Formulas::equality(Terms::var(x), Terms::var(y))));
+    CHECK(simplify(nested) == nested);
+}
+
+TEST(simplifier, ComparisonsAreEvaluated)
+{
+    auto c = Terms::func("c", {}, Sorts::intSort());
+    auto one = Theory::intConstant(1);
+    auto two = Theory::intConstant(2);
+    CHECK(simplify(Theory::intLess(one, two)) == Theory::boolTrue());
+    CHECK(simplify(Theory::intGreaterEqual(one, two)) == Theory::boolFalse());
+    CHECK(simplify(Formulas::equality(c, c)) == Theory::boolTrue());
+    CHECK(simplify(Formulas::disequality(c, c)) == Theory::boolFalse());
+    CHECK(simplify(Formulas::equality(one, two)) == Theory::boolFalse());
+    CHECK(simplify(Formulas::disequality(one, two)) == Theory::boolTrue());
+    // comparisons involving uninterpreted terms are kept
+    CHECK(simplify(Theory::intLess(c, two)) == Theory::intLess(c, two));
+    std::shared_ptr<const Formula> equality = Formulas::equality(c, two);
+    CHECK(simplify(equality) == equality);
+}
+
+TEST(simplifier, LabeledFormulasAreKept)
+{
+    auto a = atom("even");
+    auto b = atom("odd");
+    auto d = atom("positive");
+    auto labeled = Formulas::conjunction({b, d}, "loop invariant");
+    CHECK(simplify(Formulas::conjunction({a, labeled})) == Formulas::conjunction({a, labeled}));
+    CHECK(simplify(Formulas::negation(Formulas::negation(a, "negated"))) == Formulas::negation(Formulas::negation(a, "negated")));
+    // a labeled formula which simplifies to true keeps its label
+    CHECK(simplify(Formulas::conjunction({Theory::boolTrue()}, "trivial")) == Theory::boolTrue("trivial"));
+    // a labeled formula which simplifies to a subformula with a different label is wrapped into a conjunction carrying the label
+    CHECK(simplify(Formulas::implication(Theory::boolTrue(), atom("even", "inner"), "outer")) == Formulas::conjunction({atom("even", "inner")}, "outer"));
+}
+
+TEST(simplifier, LabelsAreRemovedUnlessKept)
+{
+    auto a = atom("even");
+    auto b = atom("odd");
+    auto d = atom("positive");
+    auto labeled = Formulas::conjunction({b, atom("positive", "positive c")}, "loop invariant");
+    CHECK(simplify(Formulas::conjunction({a, labeled}, "top"), false) == Formulas::conjunction({a, b, d}));
+    CHECK(simplify(Formulas::negation(Formulas::negation(a, "negated")), false) == a);
+    CHECK(simplify(Theory::boolTrue("trivial"), false) == Theory::boolTrue());
+}
+
+TEST(simplifier, TrivialAxiomsAndLemmasAreRemoved)
+{
+    auto a = atom("even");
+    auto b = atom("odd");
+    Problem problem;
+    problem.axioms = {Formulas::conjunction({a, Theory::boolTrue()}), Theory::boolTrue(), Formulas::implication(Theory::boolFalse(), b)};
+    problem.lemmas = {Formulas::disjunction({b, Theory::boolTrue()}), Formulas::negation(Formulas::negation(b)), Theory::intLess(Theory::intConstant(1), Theory::intConstant(2))};
+    problem.lemmaFamilies = {"first", "second", "third"};
+    problem.conjecture = Formulas::conjunction({b, b});
+    Simplifier().simplify(problem);
+
+    CHECK_EQUAL(problem.axioms.size(), 1u);
+    CHECK(problem.axioms[0] == a);
+    CHECK_EQUAL(problem.lemmas.size(), 1u);
+    CHECK(problem.lemmas[0] == b);
+    CHECK_EQUAL(problem.lemmaFamilies.size(), 1u);
+    CHECK_EQUAL(problem.lemmaFamilies[0], "second");
+    CHECK(problem.conjecture == b);
+}
@@ -0,0 +1,42 @@
+#include <memory>
+#include <vector>
+
+#include "Signature.hpp"
+#include "Sort.hpp"
+#include "Term.hpp"
+#include "Test.hpp"
+#include "Theory.hpp"
+
+using namespace logic;
+
+TEST(terms, EqualTermsAreIdentical)
+{
+    auto i = Terms::func("i", {}, Sorts::intSort());
+    auto f1 = Terms::func("f", {i, Theory::intConstant(1)}, Sorts::intSort());
+    auto f2 = Terms::func("f", {Terms::func("i", {}, Sorts::intSort()), Theory::intConstant(1)}, Sorts::intSort());
+    CHECK(f1 == f2);
+    CHECK(Theory::intAddition(f1, i) == Theory::intAddition(f2, i));
+}
+
+TEST(terms, DistinctTermsAreDistinct)
+{
+    auto i = Terms::func("i", {}, Sorts::intSort());
+    auto j = Terms::func("j", {}, Sorts::intSort());
+    CHECK(i != j);
+    CHECK(Terms::func("f", {i, j}, Sorts::intSort()) != Terms::func("f", {j, i}, Sorts::intSort()));
+    CHECK(Theory::intConstant(1) != Theory::intConstant(2));
+}
+
+TEST(terms, VariablesAreIdenticalPerSymbol)
+{
+    auto x = Signature::varSymbol("x", Sorts::intSort());
+    auto y = Signature::varSymbol("y", Sorts::intSort());
+    CHECK(Terms::var(x) == Terms::var(x));
+    CHECK(Terms::var(x) != Terms::var(y));
+    CHECK(Terms::var(x)->id != Terms::var(y)->id);
+}
+
+TEST(terms, RepeatedTermsAreNotAllocatedAgain)
+{
+    test::checkConstructedOnce([]() { return Terms::func("f", {Terms::func("i", {}, Sorts::intSort())}, Sorts::intSort()); }, &Terms::numberOfTerms);
+}
@@ -0,0 +1,53 @@
+#include <exception>
+#include <iostream>
+#include <set>
+#include <string>
+
+#include "Context.hpp"
+#include "Test.hpp"
+#include "Theory.hpp"
+
+// runs the test cases of the groups given as arguments, or all test cases if no group is given,
+// each in a fresh context with the theories declared, and returns 0 iff all of them pass
+int main(int argc, char* argv[])
+{
+    std::set<std::string> groups(argv + 1, argv + argc);
+
+    unsigned numberOfTests = 0;
+    unsigned numberOfFailures = 0;
+    for (const auto& testCase : test::testCases())
+    {
+        if (!groups.empty() && groups.find(testCase.group) == groups.end())
+        {
+            continue;
+        }
+        numberOfTests++;
+        std::string name = std::string(testCase.group) + "." + testCase.name;
+        try
+        {
+            logic::Context context;
+            logic::Context::Scope scope(context);
+            logic::Theory::declareTheories();
+            testCase.run();
+            std::cout << "[ ok ] " << name << std::endl;
+        }
+        catch (const test::Failure& failure)
+        {
+            numberOfFailures++;
+            std::cout << "[FAIL] " << name << "\n" << failure.message << std::endl;
+        }
+        catch (const std::exception& e)
+        {
+            numberOfFailures++;
+            std::cout << "[FAIL] " << name << "\nuncaught exception: " << e.what() << std::endl;
+        }
+    }
+
+    if (numberOfTests == 0)
+    {
+        std::cout << "no test cases found" << std::endl;
+        return 1;
+    }
+    std::cout << numberOfTests - numberOfFailures << " of " << numberOfTests << " test cases passed" << std::endl;
+    return numberOfFailures == 0 ? 0 : 1;
+}
@@ -0,0 +1,37 @@
+func main()
+{
+	Int[] a;
+	Int i;
+	Int j;
+	Int sum;
+	const Int len;
+	i = 0;
+	sum = 0;
+	while(i < len)
+	{
+		j = 0;
+		while(j < i)
+		{
+			if(a[j] > 0)
+			{
+				sum = sum + a[j];
+			}
+			else
+			{
+				a[j] = 0 - a[j];
+			}
+			j = j + 1;
+		}
+		i = i + 1;
+	}
+	skip;
+}
+
+(assert-not
+	(forall ((k Int))
+		(=>
+			(and (<= 0 k) (< k len))
+			(>= (sum main_end) (- 0 3))
+		)
+	)
+)
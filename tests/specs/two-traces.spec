@@ -0,0 +1,29 @@
+(two-traces)
+func main()
+{
+	const Int[] a;
+	Int[] b;
+	Int i;
+	Int x;
+	const Int alength;
+	i = 0;
+	x = 0;
+	while(i < alength)
+	{
+		if(a[i] > x)
+		{
+			x = a[i];
+		}
+		else
+		{
+			b[i] = x;
+		}
+		i = i + 1;
+	}
+}
+
+(assert-not
+	(=> (and (= (alength t1) (alength t2)) (forall ((k Int)) (= (a k t1) (a k t2))))
+		(= (x main_end t1) (x main_end t2))
+	)
+)
@@ -0,0 +1,183 @@
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include "Encoder.hpp"
+#include "SMTLIBWriter.hpp"
+#include "Test.hpp"
+
+using namespace spectre;
+
+namespace {
+
+    // the spec with the first occurrence of original replaced by replacement
+    std::string variant(const std::string& spec, const std::string& original, const std::string& replacement)
+    {
+        auto content = test::readSpec(spec);
+        auto position = content.find(original);
+        CHECK(position != std::string::npos);
+        return content.replace(position, original.size(), replacement);
+    }
+
+    std::string encode(const std::string& spec, Encoder::Options options, const std::string& cacheDirectory = "")
+    {
+        options.cacheDirectory = cacheDirectory;
+        Encoder encoder(options);
+        std::string errorMessage;
+        auto problem = encoder.encode(spec, errorMessage);
+        if (problem == nullptr)
+        {
+            test::fail(__FILE__, __LINE__, errorMessage);
+        }
+        std::string output;
+        encoder.write(*problem, output);
+        return output;
+    }
+
+    // the paths of the entries of the cache
+    std::vector<std::string> entries(const std::string& cacheDirectory)
+    {
+        std::vector<std::string> paths;
+        auto directory = opendir(cacheDirectory.c_str());
+        if (directory == nullptr)
+        {
+            return paths;
+        }
+        while (auto entry = readdir(directory))
+        {
+            std::string name = entry->d_name;
+            if (name != "." && name != "..")
+            {
+                paths.push_back(cacheDirectory + "/" + name);
+            }
+        }
+        closedir(directory);
+        return paths;
+    }
+
+    void writeEntry(const std::string& path, const std::string& content)
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << content;
+    }
+
+    std::string readEntry(const std::string& path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+}
+
+TEST(cache, CachedEncodingsEqualUncachedEncodings)
+{
+    test::TemporaryDirectory cache;
+    for (auto sharing : {logic::SMTLIBWriter::Sharing::None, logic::SMTLIBWriter::Sharing::Let})
+    {
+        Encoder::Options options;
+        options.sharing = sharing;
+        for (const auto& spec : {"array-init.spec", "nested-loops.spec", "two-traces.spec"})
+        {
+            auto expected = encode(test::readSpec(spec), options);
+            // the first encoding fills the cache, the second one takes the prefix from the cache
+            CHECK_EQUAL(encode(test::readSpec(spec), options, cache.path), expected);
+            CHECK_EQUAL(encode(test::readSpec(spec), options, cache.path), expected);
+        }
+    }
+    CHECK_EQUAL(entries(cache.path).size(), 6u);
+}
+
+TEST(cache, ChangedConjecturesUseTheSameEntry)
+{
+    test::TemporaryDirectory cache;
+    Encoder::Options options;
+    auto spec = test::readSpec("array-init.spec");
+    auto changed = variant("array-init.spec", "(= (a main_end pos) (v main_end))", "(and (= (a main_end pos) (v main_end)) (> (i main_end) 2))");
+    encode(spec, options, cache.path);
+    auto paths = entries(cache.path);
+    CHECK_EQUAL(paths.size(), 1u);
+
+    CHECK_EQUAL(encode(changed, options, cache.path), encode(changed, options));
+    CHECK(entries(cache.path) == paths);
+
+    // the prefix is really taken from the entry
+    writeEntry(paths[0], "; marker\n" + readEntry(paths[0]));
+    CHECK(encode(changed, options, cache.path).find("; marker\n") == 0);
+}
+
+TEST(cache, ChangedProgramsAndOptionsUseNewEntries)
+{
+    test::TemporaryDirectory cache;
+    Encoder::Options options;
+    encode(test::readSpec("array-init.spec"), options, cache.path);
+    CHECK_EQUAL(entries(cache.path).size(), 1u);
+
+    auto changed = variant("array-init.spec", "a[i] = v;", "a[i] = v + 1;");
+    CHECK_EQUAL(encode(changed, options, cache.path), encode(changed, options));
+    CHECK_EQUAL(entries(cache.path).size(), 2u);
+
+    // the declarations are part of the program, even if the statements are the same
+    auto redeclared = variant("array-init.spec", "Int v;", "Int v; Int w;");
+    CHECK_EQUAL(encode(redeclared, options, cache.path), encode(redeclared, options));
+    CHECK_EQUAL(entries(cache.path).size(), 3u);
+
+    options.labels = false;
+    CHECK_EQUAL(encode(test::readSpec("array-init.spec"), options, cache.path), encode(test::readSpec("array-init.spec"), options));
+    CHECK_EQUAL(entries(cache.path).size(), 4u);
+    options.labels = true;
+    options.compact = true;
+    CHECK_EQUAL(encode(test::readSpec("array-init.spec"), options, cache.path), encode(test::readSpec("array-init.spec"), options));
+    CHECK_EQUAL(entries(cache.path).size(), 5u);
+}
+
+TEST(cache, DefinitionsAreNotCached)
+{
+    test::TemporaryDirectory cache;
+    Encoder::Options options;
+    options.sharing = logic::SMTLIBWriter::Sharing::DefineFun;
+    CHECK_EQUAL(encode(test::readSpec("array-init.spec"), options, cache.path), encode(test::readSpec("array-init.spec"), options));
+    CHECK_EQUAL(entries(cache.path).size(), 0u);
+}
+
+TEST(cache, EmptyEntriesAreRecomputed)
+{
+    test::TemporaryDirectory cache;
+    Encoder::Options options;
+    auto spec = test::readSpec("nested-loops.spec");
+    auto expected = encode(spec, options);
+    encode(spec, options, cache.path);
+    auto paths = entries(cache.path);
+    CHECK_EQUAL(paths.size(), 1u);
+    auto content = readEntry(paths[0]);
+
+    // e.g. left behind by a full disk
+    writeEntry(paths[0], "");
+    CHECK_EQUAL(encode(spec, options, cache.path), expected);
+    CHECK_EQUAL(readEntry(paths[0]), content);
+}
+
+TEST(cache, EntriesGetThePermissionsOfTheUmask)
+{
+    test::TemporaryDirectory cache;
+    encode(test::readSpec("array-init.spec"), Encoder::Options(), cache.path);
+    auto paths = entries(cache.path);
+    CHECK_EQUAL(paths.size(), 1u);
+    struct stat info;
+    CHECK(stat(paths[0].c_str(), &info) == 0);
+    // not only readable by the owner (as the temporary file written first), but as any other file created by the process
+    auto mask = umask(0);
+    umask(mask);
+    CHECK_EQUAL(info.st_mode & 0777, 0666 & ~mask);
+}
+
+TEST(cache, UnwritableCachesOnlyCostTime)
+{
+    test::TemporaryDirectory directory;
+    writeEntry(directory.path + "/file", "");
+    Encoder::Options options;
+    auto spec = test::readSpec("two-traces.spec");
+    CHECK_EQUAL(encode(spec, options, directory.path + "/file"), encode(spec, options));
+}
@@ -0,0 +1,347 @@
+#include <algorithm>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Encoder.hpp"
+#include "SExpression.hpp"
+#include "SMTLIBWriter.hpp"
+#include "Test.hpp"
+
+using namespace spectre;
+
+namespace {
+
+    const std::vector<std::string> specs = {"array-init.spec", "nested-loops.spec", "two-traces.spec"};
+
+    std::string encode(const std::string& spec, const Encoder::Options& options)
+    {
+        Encoder encoder(options);
+        std::string errorMessage;
+        auto problem = encoder.encode(test::readSpec(spec), errorMessage);
+        if (problem == nullptr)
+        {
+            test::fail(__FILE__, __LINE__, spec + ": " + errorMessage);
+        }
+        std::string output;
+        encoder.write(*problem, output);
+        return output;
+    }
+
+    // the top-level commands of smtlib, one per line, without comments and whitespace
+    std::string sExpressions(const std::string& smtlib)
+    {
+        std::string commands;
+        for (const auto& command : test::parseSExpressions(smtlib))
+        {
+            commands += command.toString() + "\n";
+        }
+        return commands;
+    }
+
+    // expression with nested conjunctions and disjunctions flattened, and their duplicate operands removed (as done by logic::Simplifier)
+    test::SExpression flattened(const test::SExpression& expression)
+    {
+        auto result = expression;
+        result.children.clear();
+        auto isJunction = !expression.children.empty() && (expression.children[0].atom == "and" || expression.children[0].atom == "or");
+        std::vector<std::string> operands;
+        for (const auto& child : expression.children)
+        {
+            auto flattenedChild = flattened(child);
+            std::vector<test::SExpression> parts;
+            if (isJunction && !flattenedChild.children.empty() && flattenedChild.children[0].atom == expression.children[0].atom)
+            {
+                parts.assign(flattenedChild.children.begin() + 1, flattenedChild.children.end());
+            }
+            else
+            {
+                parts.push_back(flattenedChild);
+            }
+            for (const auto& part : parts)
+            {
+                auto string = part.toString();
+                if (!isJunction || std::find(operands.begin(), operands.end(), string) == operands.end())
+                {
+                    operands.push_back(string);
+                    result.children.push_back(part);
+                }
+            }
+        }
+        // a junction with a single operand is the operand
+        if (isJunction && result.children.size() == 2)
+        {
+            return result.children[1];
+        }
+        return result;
+    }
+
+    std::string flattenedSExpressions(const std::string& smtlib)
+    {
+        std::string commands;
+        for (const auto& command : test::parseSExpressions(smtlib))
+        {
+            commands += flattened(command).toString() + "\n";
+        }
+        return commands;
+    }
+
+    Encoder::Options withSharing(logic::SMTLIBWriter::Sharing sharing)
+    {
+        Encoder::Options options;
+        options.sharing = sharing;
+        return options;
+    }
+}
+
+TEST(sharing, LetBindingsExpandToTheUnsharedEncoding)
+{
+    for (const auto& spec : specs)
+    {
+        auto unshared = encode(spec, withSharing(logic::SMTLIBWriter::Sharing::None));
+        auto shared = encode(spec, withSharing(logic::SMTLIBWriter::Sharing::Let));
+        CHECK(shared.find("|Let#0|") != std::string::npos);
+        CHECK_EQUAL(test::expandSharing(shared), test::expandSharing(unshared));
+    }
+}
+
+TEST(sharing, DefinitionsExpandToTheUnsharedEncoding)
+{
+    for (const auto& spec : specs)
+    {
+        auto unshared = encode(spec, withSharing(logic::SMTLIBWriter::Sharing::None));
+        auto shared = encode(spec, withSharing(logic::SMTLIBWriter::Sharing::DefineFun));
+        CHECK(shared.find("|Def#0|") != std::string::npos);
+        CHECK_EQUAL(test::expandSharing(shared), test::expandSharing(unshared));
+    }
+}
+
+TEST(compact, CompactEncodingsHaveTheSameSExpressions)
+{
+    for (const auto& spec : specs)
+    {
+        for (auto sharing : {logic::SMTLIBWriter::Sharing::None, logic::SMTLIBWriter::Sharing::Let, logic::SMTLIBWriter::Sharing::DefineFun})
+        {
+            auto options = withSharing(sharing);
+            auto normal = encode(spec, options);
+            options.compact = true;
+            auto compact = encode(spec, options);
+            CHECK(compact.size() < normal.size());
+            CHECK_EQUAL(sExpressions(compact), sExpressions(normal));
+        }
+    }
+}
+
+TEST(compact, LabelsOffOnlyDropsTheLabels)
+{
+    for (const auto& spec : specs)
+    {
+        for (auto compact : {false, true})
+        {
+            for (auto simplify : {false, true})
+            {
+                Encoder::Options options;
+                options.compact = compact;
+                options.simplify = simplify;
+                options.comments = false;
+                auto labeled = encode(spec, options);
+                options.labels = false;
+                auto unlabeled = encode(spec, options);
+
+                // the labels are the only comments, so without them the output has no comments
+                CHECK(labeled.find(';') != std::string::npos);
+                CHECK_EQUAL(unlabeled.find(';'), std::string::npos);
+                CHECK_EQUAL(unlabeled.find(":named"), std::string::npos);
+                // labeled subformulas are kept apart by the simplifier, so it only merges them with their parents without labels
+                if (simplify)
+                {
+                    CHECK_EQUAL(flattenedSExpressions(unlabeled), flattenedSExpressions(labeled));
+                }
+                else
+                {
+                    CHECK_EQUAL(sExpressions(unlabeled), sExpressions(labeled));
+                }
+
+                // compact assertions without labels take a single line each
+                if (compact)
+                {
+                    std::istringstream lines(unlabeled);
+                    std::string line;
+                    while (std::getline(lines, line))
+                    {
+                        CHECK(line.empty() || test::parseSExpressions(line).size() == 1);
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST(threads, EncodingDoesntDependOnTheNumberOfThreads)
+{
+    for (const auto& spec : specs)
+    {
+        for (auto sharing : {logic::SMTLIBWriter::Sharing::None, logic::SMTLIBWriter::Sharing::DefineFun})
+        {
+            auto options = withSharing(sharing);
+            auto expected = encode(spec, options);
+            for (unsigned threads : {2u, 4u})
+            {
+                options.threads = threads;
+                CHECK_EQUAL(encode(spec, options), expected);
+            }
+        }
+    }
+}
+
+TEST(parser, ConcurrentEncodersAgreeWithASingleEncoder)
+{
+    std::vector<std::string> expected;
+    for (const auto& spec : specs)
+    {
+        expected.push_back(encode(spec, Encoder::Options()));
+    }
+
+    // each thread parses all specs several times, in a different order than the other threads
+    const size_t numberOfThreads = 4;
+    const size_t numberOfRounds = 3;
+    auto outputs = test::runConcurrently(numberOfThreads, [&](size_t t) {
+        Encoder encoder;
+        std::vector<std::string> threadOutputs(specs.size() * numberOfRounds);
+        for (size_t j = 0; j < threadOutputs.size(); j++)
+        {
+            std::string errorMessage;
+            auto problem = encoder.encode(test::readSpec(specs[(j + t) % specs.size()]), errorMessage);
+            if (problem != nullptr)
+            {
+                encoder.write(*problem, threadOutputs[j]);
+            }
+            else
+            {
+                threadOutputs[j] = errorMessage;
+            }
+        }
+        return threadOutputs;
+    });
+
+    for (size_t t = 0; t < numberOfThreads; t++)
+    {
+        for (size_t j = 0; j < outputs[t].size(); j++)
+        {
+            CHECK_EQUAL(outputs[t][j], expected[(j + t) % specs.size()]);
+        }
+    }
+}
+
+TEST(parser, ErrorsAreReportedWithTheirLocation)
+{
+    Encoder encoder;
+    std::string errorMessage;
+    auto problem = encoder.encode(std::string("func main()\n{\n\tInt i;\n\ti = j;\n}\n(assert-not (= (i main_end) 0))\n"), errorMessage);
+    CHECK(problem == nullptr);
+    CHECK(errorMessage.find("input: Error while parsing location 4.6") == 0);
+    CHECK(errorMessage.find("Program variable j has not been declared") != std::string::npos);
+
+    // a failed encoding doesn't affect later encodings of the same encoder
+    problem = encoder.encode(test::readSpec(specs[0]), errorMessage);
+    CHECK(problem != nullptr);
+    std::string output;
+    encoder.write(*problem, output);
+    CHECK_EQUAL(output, encode(specs[0], Encoder::Options()));
+}
+
+TEST(encoder, ProblemsAreIndependent)
+{
+    std::vector<std::string> expected;
+    for (const auto& spec : specs)
+    {
+        expected.push_back(encode(spec, Encoder::Options()));
+    }
+
+    // all problems are alive at the same time, and are written in reverse order
+    Encoder encoder;
+    std::vector<std::unique_ptr<logic::Problem>> problems;
+    for (const auto& spec : specs)
+    {
+        std::string errorMessage;
+        problems.push_back(encoder.encode(test::readSpec(spec), errorMessage));
+        CHECK(problems.back() != nullptr);
+    }
+    for (size_t i = problems.size(); i-- > 0;)
+    {
+        std::string output;
+        encoder.write(*problems[i], output);
+        CHECK_EQUAL(output, expected[i]);
+    }
+}
+
+TEST(encoder, StreamsAndStringsGetTheSameOutput)
+{
+    Encoder encoder;
+    std::string errorMessage;
+    auto problem = encoder.encodeFile(test::specPath(specs[1]), errorMessage);
+    CHECK(problem != nullptr);
+    std::stringstream stream;
+    encoder.write(*problem, stream);
+    // write appends to the string
+    std::string output = "prefix";
+    encoder.write(*problem, output);
+    CHECK_EQUAL(output, "prefix" + stream.str());
+    CHECK_EQUAL(stream.str(), encode(specs[1], Encoder::Options()));
+}
+
+TEST(encoder, MissingFilesAreReported)
+{
+    Encoder encoder;
+    std::string errorMessage;
+    CHECK(encoder.encodeFile(test::specPath("missing.spec"), errorMessage) == nullptr);
+    CHECK(errorMessage.find("missing.spec") != std::string::npos);
+}
+
+TEST(determinism, EncodingsDontDependOnPreviousEncodings)
+{
+    std::vector<std::string> expected;
+    for (const auto& spec : specs)
+    {
+        expected.push_back(encode(spec, Encoder::Options()));
+    }
+    // the objects of later encodings end up at other addresses, and other symbols are declared before
+    Encoder encoder;
+    std::vector<std::unique_ptr<logic::Problem>> problems;
+    for (size_t round = 0; round < 3; round++)
+    {
+        for (size_t i = specs.size(); i-- > 0;)
+        {
+            std::string errorMessage;
+            problems.push_back(encoder.encode(test::readSpec(specs[i]), errorMessage));
+            std::string output;
+            encoder.write(*problems.back(), output);
+            CHECK_EQUAL(output, expected[i]);
+        }
+    }
+}
+
+TEST(determinism, DeclarationsAreOrderedByName)
+{
+    for (const auto& spec : specs)
+    {
+        std::vector<std::string> sorts;
+        std::vector<std::string> symbols;
+        for (const auto& command : test::parseSExpressions(encode(spec, Encoder::Options())))
+        {
+            const auto& name = command.children.at(0).atom;
+            if (name == "declare-sort")
+            {
+                sorts.push_back(command.children.at(1).atom);
+            }
+            else if (name == "declare-fun" || name == "declare-const")
+            {
+                symbols.push_back(command.children.at(1).atom);
+            }
+        }
+        CHECK(!symbols.empty());
+        CHECK(std::is_sorted(sorts.begin(), sorts.end()));
+        CHECK(std::is_sorted(symbols.begin(), symbols.end()));
+    }
+}
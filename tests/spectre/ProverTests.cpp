@@ -0,0 +1,150 @@
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include <sys/stat.h>
+
+#include "Prover.hpp"
+#include "Test.hpp"
+
+using namespace spectre;
+
+namespace {
+
+    const std::string problem = "(declare-const x Int)\n(assert-not (= x x))\n";
+
+    std::string readFile(const std::string& path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    // writes a fake prover into directory, which appends a line to directory/calls on each call,
+    // copies the problem, its last argument, to directory/problem and then runs body. returns the command running the prover.
+    std::string fakeProver(const std::string& directory, const std::string& name, const std::string& body)
+    {
+        auto path = directory + "/" + name;
+        {
+            std::ofstream file(path);
+            file << "#!/bin/sh\n";
+            file << "echo call >> " << directory << "/calls\n";
+            file << "for problem; do :; done\n";
+            file << "cat \"$problem\" > " << directory << "/problem\n";
+            file << body << "\n";
+        }
+        chmod(path.c_str(), 0755);
+        return path;
+    }
+
+    size_t numberOfCalls(const std::string& directory)
+    {
+        auto calls = readFile(directory + "/calls");
+        return calls.size() / std::string("call\n").size();
+    }
+}
+
+TEST(prover, StatusesAreReported)
+{
+    test::TemporaryDirectory directory;
+    struct { const char* output; const char* status; } cases[] = {
+        {"unsat", "unsat"},
+        {"some output\nsat\nmore output", "sat"},
+        {"timeout", "timeout"},
+        {"% SZS status Unsatisfiable for problem", "unsat"},
+        {"% SZS status Theorem for problem", "unsat"},
+        {"% SZS status CounterSatisfiable for problem", "sat"},
+        {"% SZS status Timeout for problem", "timeout"},
+        {"% SZS status GaveUp for problem", "unknown"}
+    };
+    for (const auto& c : cases)
+    {
+        auto command = fakeProver(directory.path, "prover", "printf '%s\\n' '" + std::string(c.output) + "'");
+        Prover prover(command, "");
+        Prover::Result result;
+        std::string errorMessage;
+        CHECK(prover.run(problem, result, errorMessage));
+        CHECK_EQUAL(result.status, c.status);
+        CHECK(!result.cached);
+        CHECK_EQUAL(readFile(directory.path + "/problem"), problem);
+    }
+}
+
+TEST(prover, ResultsAreCachedByProblemAndCommand)
+{
+    test::TemporaryDirectory directory;
+    test::TemporaryDirectory cache;
+    auto command = fakeProver(directory.path, "prover", "echo unsat");
+    Prover::Result result;
+    std::string errorMessage;
+
+    CHECK(Prover(command, cache.path).run(problem, result, errorMessage));
+    CHECK(!result.cached);
+    CHECK(Prover(command, cache.path).run(problem, result, errorMessage));
+    CHECK(result.cached);
+    CHECK_EQUAL(result.status, "unsat");
+    CHECK_EQUAL(numberOfCalls(directory.path), 1u);
+
+    // another problem or another command (e.g. another time limit) is run again
+    CHECK(Prover(command, cache.path).run(problem + "(check-sat)\n", result, errorMessage));
+    CHECK(!result.cached);
+    CHECK(Prover(command + " -t 10", cache.path).run(problem, result, errorMessage));
+    CHECK(!result.cached);
+    CHECK_EQUAL(numberOfCalls(directory.path), 3u);
+
+    // without a cache directory, nothing is cached
+    CHECK(Prover(command, "").run(problem, result, errorMessage));
+    CHECK(!result.cached);
+    CHECK_EQUAL(numberOfCalls(directory.path), 4u);
+}
+
+TEST(prover, FailuresAreReportedAndNotCached)
+{
+    test::TemporaryDirectory directory;
+    test::TemporaryDirectory cache;
+    struct { const char* name; const char* body; const char* error; } cases[] = {
+        {"crash", "echo unsat; kill -SEGV $$", "was killed by signal"},
+        {"silent", "exit 0", "exited with status 0 without reporting a result"},
+        {"failure", "echo 'error: unknown option'; exit 3", "exited with status 3 without reporting a result"}
+    };
+    for (const auto& c : cases)
+    {
+        auto command = fakeProver(directory.path, c.name, c.body);
+        for (int run = 0; run < 2; run++)
+        {
+            Prover::Result result;
+            std::string errorMessage;
+            CHECK(!Prover(command, cache.path).run(problem, result, errorMessage));
+            CHECK_EQUAL(errorMessage.find(command), 0u);
+            CHECK(errorMessage.find(c.error) != std::string::npos);
+        }
+    }
+    CHECK_EQUAL(numberOfCalls(directory.path), 6u);
+}
+
+TEST(prover, TemporaryDirectoriesMayContainQuotes)
+{
+    test::TemporaryDirectory directory;
+    auto temporaryDirectory = directory.path + "/it's a 'directory'";
+    CHECK(mkdir(temporaryDirectory.c_str(), 0700) == 0);
+    auto command = fakeProver(directory.path, "prover", "echo sat");
+
+    auto previous = std::getenv("TMPDIR");
+    std::string previousValue = previous != nullptr ? previous : "";
+    setenv("TMPDIR", temporaryDirectory.c_str(), 1);
+    Prover::Result result;
+    std::string errorMessage;
+    auto success = Prover(command, "").run(problem, result, errorMessage);
+    if (previous != nullptr)
+    {
+        setenv("TMPDIR", previousValue.c_str(), 1);
+    }
+    else
+    {
+        unsetenv("TMPDIR");
+    }
+
+    CHECK(success);
+    CHECK_EQUAL(result.status, "sat");
+    CHECK_EQUAL(readFile(directory.path + "/problem"), problem);
+}
@@ -0,0 +1,162 @@
+#include <cstddef>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "Encoder.hpp"
+#include "Server.hpp"
+#include "Test.hpp"
+
+using namespace spectre;
+
+namespace {
+
+    struct Response
+    {
+        std::string status;
+        std::string content;
+    };
+
+    std::string request(const std::string& spec)
+    {
+        return std::to_string(spec.size()) + "\n" + spec;
+    }
+
+    // serves input (the concatenated requests) and returns the responses.
+    // the requests and responses are passed through files, so that the server can run on the calling thread.
+    std::vector<Response> serve(Encoder& encoder, const std::string& input, bool expectedResult = true)
+    {
+        test::TemporaryDirectory directory;
+        {
+            std::ofstream file(directory.path + "/requests", std::ios::binary);
+            file << input;
+        }
+        int inputFd = open((directory.path + "/requests").c_str(), O_RDONLY);
+        int outputFd = open((directory.path + "/responses").c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+        CHECK(inputFd != -1 && outputFd != -1);
+        Server server(encoder);
+        auto result = server.serve(inputFd, outputFd);
+        close(inputFd);
+        close(outputFd);
+        CHECK_EQUAL(result, expectedResult);
+
+        std::ifstream file(directory.path + "/responses", std::ios::binary);
+        std::stringstream buffer;
+        buffer << file.rdbuf();
+        auto output = buffer.str();
+
+        std::vector<Response> responses;
+        size_t position = 0;
+        while (position < output.size())
+        {
+            auto space = output.find(' ', position);
+            auto newline = output.find('\n', position);
+            CHECK(space != std::string::npos && newline != std::string::npos && space < newline);
+            auto status = output.substr(position, space - position);
+            auto length = std::stoul(output.substr(space + 1, newline - space - 1));
+            CHECK(newline + 1 + length <= output.size());
+            responses.push_back(Response{status, output.substr(newline + 1, length)});
+            position = newline + 1 + length;
+        }
+        return responses;
+    }
+
+    std::string encode(Encoder& encoder, const std::string& spec)
+    {
+        std::string errorMessage;
+        auto problem = encoder.encode(spec, errorMessage);
+        CHECK(problem != nullptr);
+        std::string output;
+        encoder.write(*problem, output);
+        return output;
+    }
+}
+
+TEST(server, RequestsAreAnsweredInOrder)
+{
+    const std::vector<std::string> specs = {test::readSpec("array-init.spec"), test::readSpec("two-traces.spec"), test::readSpec("nested-loops.spec")};
+    Encoder encoder;
+    std::vector<std::string> expected;
+    for (const auto& spec : specs)
+    {
+        expected.push_back(encode(encoder, spec));
+    }
+
+    // repeated requests get identical answers, which don't depend on the previous requests
+    std::string input;
+    std::vector<size_t> order = {0, 1, 0, 2, 2, 1};
+    for (auto i : order)
+    {
+        input += request(specs[i]);
+    }
+    auto responses = serve(encoder, input);
+    CHECK_EQUAL(responses.size(), order.size());
+    for (size_t j = 0; j < responses.size(); j++)
+    {
+        CHECK_EQUAL(responses[j].status, "ok");
+        CHECK_EQUAL(responses[j].content, expected[order[j]]);
+    }
+}
+
+TEST(server, ErrorsAreAnsweredAndServingContinues)
+{
+    auto spec = test::readSpec("array-init.spec");
+    Encoder encoder;
+    auto expected = encode(encoder, spec);
+    auto responses = serve(encoder, request("func main()\n{\n\tInt i;\n\ti = j;\n}\n") + request(spec) + request("") + request(spec));
+    CHECK_EQUAL(responses.size(), 4u);
+    CHECK_EQUAL(responses[0].status, "error");
+    CHECK(responses[0].content.find("request: Error while parsing location 4.6") == 0);
+    CHECK_EQUAL(responses[1].status, "ok");
+    CHECK_EQUAL(responses[1].content, expected);
+    CHECK_EQUAL(responses[2].status, "error");
+    CHECK_EQUAL(responses[3].status, "ok");
+    CHECK_EQUAL(responses[3].content, expected);
+}
+
+TEST(server, MalformedRequestsEndServing)
+{
+    auto spec = test::readSpec("array-init.spec");
+    Encoder encoder;
+    auto expected = encode(encoder, spec);
+
+    // a malformed header is answered by an error, and the following requests are not answered
+    auto responses = serve(encoder, request(spec) + "12a\n" + request(spec), false);
+    CHECK_EQUAL(responses.size(), 2u);
+    CHECK_EQUAL(responses[0].content, expected);
+    CHECK_EQUAL(responses[1].status, "error");
+    CHECK_EQUAL(responses[1].content, "malformed request");
+
+    CHECK_EQUAL(serve(encoder, "\n", false).size(), 1u);
+    CHECK_EQUAL(serve(encoder, "99999999999999999999\n", false).size(), 1u);
+
+    // a request which ends before its announced length is not answered
+    CHECK_EQUAL(serve(encoder, request(spec) + "100\nfunc", false).size(), 1u);
+
+    // no requests, no answers
+    CHECK_EQUAL(serve(encoder, "").size(), 0u);
+}
+
+TEST(server, OnlyStaleSocketsAreReplaced)
+{
+    test::TemporaryDirectory directory;
+    auto path = directory.path + "/notes.txt";
+    {
+        std::ofstream file(path);
+        file << "notes\n";
+    }
+    Encoder encoder;
+    Server server(encoder);
+
+    // a file which is not a socket is neither removed nor listened on
+    CHECK(!server.serveSocket(path));
+    std::ifstream file(path);
+    std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    CHECK_EQUAL(content, "notes\n");
+}
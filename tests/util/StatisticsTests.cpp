@@ -0,0 +1,107 @@
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "JSON.hpp"
+#include "Test.hpp"
+
+// the reports of -stats are written by the executable spectre, so they are checked on its output
+namespace {
+
+    const std::vector<std::string> specs = {"array-init.spec", "nested-loops.spec", "two-traces.spec"};
+
+    std::string spectre(const std::string& arguments)
+    {
+        return "'" + std::string(SPECTRE_EXECUTABLE) + "' " + arguments;
+    }
+
+    // the lines of smtlib which are not comments
+    std::string withoutComments(const std::string& smtlib)
+    {
+        std::istringstream lines(smtlib);
+        std::string line;
+        std::string result;
+        while (std::getline(lines, line))
+        {
+            if (line.empty() || line[0] != ';')
+            {
+                result += line + "\n";
+            }
+        }
+        return result;
+    }
+
+    // what spectre wrote to stderr, except for the node statistics written at exit in builds counting the nodes
+    std::string withoutNodeStatistics(const std::string& errors)
+    {
+#ifdef SPECTRE_NODE_STATISTICS
+        return errors.substr(0, errors.find("Node statistics:\n"));
+#else
+        return errors;
+#endif
+    }
+
+    void checkReport(const test::JSONValue& report)
+    {
+        CHECK(report.kind == test::JSONValue::Kind::Object);
+        for (const auto& stage : {"parse", "semantics", "traceLemmas", "staticAnalysis", "output"})
+        {
+            CHECK(report["stages"].has(stage));
+            CHECK(report["stages"][stage]["wall"].number >= 0);
+            CHECK(report["stages"][stage]["cpu"].number >= 0);
+        }
+        for (const auto& counter : {"terms", "formulas", "symbols", "axioms", "lemmas"})
+        {
+            CHECK(report["counters"].has(counter));
+            CHECK(report["counters"][counter].kind == test::JSONValue::Kind::Number);
+        }
+        CHECK(report["counters"]["formulas"].number > 0);
+        CHECK(report["counters"]["symbols"].number > 0);
+        CHECK(report["lemmaFamilies"].kind == test::JSONValue::Kind::Object);
+    }
+}
+
+TEST(stats, JSONReportIsOneObjectOnStderr)
+{
+    for (const auto& spec : specs)
+    {
+        std::string expected, output, errors;
+        CHECK_EQUAL(test::runCommand(spectre("'" + test::specPath(spec) + "'"), expected, errors), 0);
+        CHECK_EQUAL(test::runCommand(spectre("-stats json '" + test::specPath(spec) + "'"), output, errors), 0);
+        // the output is the same as without -stats
+        CHECK_EQUAL(output, expected);
+        checkReport(test::parseJSON(withoutNodeStatistics(errors)));
+    }
+}
+
+TEST(stats, BatchReportsOneObjectPerSpec)
+{
+    test::TemporaryDirectory directory;
+    std::string output, errors;
+    CHECK_EQUAL(test::runCommand(spectre("-stats json -j 2 -batch '" + std::string(SPECTRE_TEST_SPECS) + "' output '" + directory.path + "'"), output, errors), 0);
+    std::istringstream lines(withoutNodeStatistics(errors));
+    std::string line;
+    size_t numberOfReports = 0;
+    while (std::getline(lines, line))
+    {
+        checkReport(test::parseJSON(line));
+        numberOfReports++;
+    }
+    CHECK_EQUAL(numberOfReports, specs.size());
+}
+
+TEST(stats, CommentReportKeepsTheAssertions)
+{
+    for (const auto& spec : specs)
+    {
+        std::string expected, output, errors;
+        CHECK_EQUAL(test::runCommand(spectre("'" + test::specPath(spec) + "'"), expected, errors), 0);
+        CHECK_EQUAL(test::runCommand(spectre("-stats on '" + test::specPath(spec) + "'"), output, errors), 0);
+        CHECK_EQUAL(withoutNodeStatistics(errors), "");
+        CHECK(output.find("; Statistics:\n") != std::string::npos);
+        CHECK(output.size() > expected.size());
+        // the report only adds comments
+        CHECK_EQUAL(withoutComments(output), withoutComments(expected));
+        CHECK_EQUAL(output.compare(0, expected.size(), expected), 0);
+    }
+}
@@ -0,0 +1,107 @@
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "Test.hpp"
+#include "ThreadPool.hpp"
+
+using namespace util;
+
+TEST(threadpool, AllTasksAreExecutedOnce)
+{
+    for (unsigned numberOfThreads : {1u, 2u, 4u})
+    {
+        ThreadPool threadPool(numberOfThreads);
+        CHECK_EQUAL(threadPool.numberOfThreads(), numberOfThreads);
+        // the pool is reused for several runs
+        for (int round = 0; round < 3; round++)
+        {
+            std::vector<std::atomic<int>> executions(100);
+            std::vector<std::function<void()>> tasks;
+            for (size_t i = 0; i < executions.size(); i++)
+            {
+                tasks.push_back([&executions, i]{ executions[i]++; });
+            }
+            threadPool.run(std::move(tasks));
+            for (const auto& numberOfExecutions : executions)
+            {
+                CHECK_EQUAL(numberOfExecutions.load(), 1);
+            }
+        }
+    }
+}
+
+TEST(threadpool, SingleThreadExecutesTasksInOrderOnTheCallingThread)
+{
+    ThreadPool threadPool(1);
+    std::vector<int> order;
+    std::vector<std::function<void()>> tasks;
+    auto caller = std::this_thread::get_id();
+    bool onCaller = true;
+    for (int i = 0; i < 10; i++)
+    {
+        tasks.push_back([&, i]{ order.push_back(i); onCaller = onCaller && std::this_thread::get_id() == caller; });
+    }
+    threadPool.run(std::move(tasks));
+    CHECK(order == std::vector<int>({0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+    CHECK(onCaller);
+}
+
+TEST(threadpool, WorkersHelpWithTheTasks)
+{
+    ThreadPool threadPool(4);
+    std::mutex mutex;
+    std::set<std::thread::id> threads;
+    std::vector<std::function<void()>> tasks;
+    for (int i = 0; i < 16; i++)
+    {
+        tasks.push_back([&]{
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            std::lock_guard<std::mutex> lock(mutex);
+            threads.insert(std::this_thread::get_id());
+        });
+    }
+    threadPool.run(std::move(tasks));
+    CHECK(threads.size() > 1);
+}
+
+TEST(threadpool, ExceptionsAreRethrownAfterAllTasksFinished)
+{
+    for (unsigned numberOfThreads : {1u, 3u})
+    {
+        ThreadPool threadPool(numberOfThreads);
+        std::atomic<int> numberOfFinishedTasks(0);
+        std::vector<std::function<void()>> tasks;
+        for (int i = 0; i < 20; i++)
+        {
+            tasks.push_back([&, i]{
+                if (i % 5 == 2)
+                {
+                    throw std::runtime_error("task failed");
+                }
+                numberOfFinishedTasks++;
+            });
+        }
+        bool thrown = false;
+        try
+        {
+            threadPool.run(std::move(tasks));
+        }
+        catch (const std::runtime_error&)
+        {
+            thrown = true;
+        }
+        CHECK(thrown);
+        CHECK_EQUAL(numberOfFinishedTasks.load(), 16);
+
+        // the pool can still be used afterwards
+        std::atomic<int> numberOfExecutions(0);
+        threadPool.run({[&]{ numberOfExecutions++; }, [&]{ numberOfExecutions++; }});
+        CHECK_EQUAL(numberOfExecutions.load(), 2);
+    }
+}